@@ -0,0 +1,470 @@
+#include "Renderer.h"
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "StateCache.h"
+#include "Framebuffer.h"
+#include "FrameCapture.h"
+#include "GpuMemory.h"
+#include "FileSystem.h"
+#include "FramePacer.h"
+#include "UniformBuffer.h"
+#include "ShaderCompiler.h"
+#include "AllocationCounter.h"
+#include "LinearArena.h"
+#include "SpriteStore.h"
+#include "Math.h"
+#include "scenes/SceneRegistry.h"
+
+/* Runs a fixed set of scenes offscreen with vsync off and prints frame time statistics as JSON, */
+/* so results can be compared across code and driver versions. */
+/*                                                                    */
+/* Usage: Benchmark [--scene name]... [--frames n] [--warmup n] [--width w] [--height h] [--msaa samples] */
+/*                  [--render-scale s] [--capture dir] [--ready-timeout seconds] [--sprite-kernels] [--output file.json] */
+/* Without --scene every scene of scene::GetSceneNames() is run. Scenes are drawn into a Framebuffer, so the */
+/* results don't depend on the window being visible or composited. --render-scale sizes it relative to */
+/* --width and --height, and with --msaa the resolve is part of every measured frame. --capture writes the */
+/* last frame of every scene to dir/<scene>.tga, to compare the output of two builds image by image. */
+/* --sprite-kernels also times every SpriteStore kernel the CPU supports on its own, writing into ordinary */
+/* memory on one thread, so the SIMD speedup can be told apart from the GPU and the mapped buffer. */
+/* A scene that is still not ready after --ready-timeout seconds (30 by default), because a shader */
+/* failed to compile or res/ is not in the working directory, is reported as failed and skipped. */
+
+struct BenchmarkOptions
+{
+    std::vector<std::string> Scenes;
+    unsigned int Frames = 500;
+    unsigned int Warmup = 50;
+    int Width = 1280;
+    int Height = 720;
+    unsigned int Samples = 1;
+    float RenderScale = 1.0f;
+    std::string CapturePath;
+    double ReadyTimeout = 30.0;
+    bool SpriteKernels = false;
+    std::string Output;
+};
+
+struct BenchmarkResult
+{
+    std::string Scene;
+    unsigned int Frames = 0;
+    double MinMilliseconds = 0.0;
+    double AverageMilliseconds = 0.0;
+    double P99Milliseconds = 0.0;
+    double MaxMilliseconds = 0.0;
+    double DrawCallsPerSecond = 0.0;
+    double TrianglesPerSecond = 0.0;
+    double AllocationsPerFrame = 0.0; // Heap allocations, should be 0 once a scene is loaded
+    unsigned long long MaxAllocations = 0;
+    double GpuMegabytes = 0.0;        // What our own objects hold with the scene loaded, see GpuMemory
+    std::string Error;                // Why the scene could not be measured, empty if it was
+};
+
+struct SpriteKernelResult
+{
+    SpriteStore::Kernel Kernel = SpriteStore::Kernel::Scalar;
+    double NanosecondsPerSprite = 0.0; // Best of the runs
+    double Speedup = 1.0;              // Against the scalar kernel
+    double MaxError = 0.0;             // Largest difference of any vertex component from the scalar kernel
+};
+
+/* Frames in flight while measuring. Without a limit the driver would queue frames until it throttles */
+/* on its own, and we would be measuring how fast we can record commands rather than render them. */
+static const unsigned int MaxFramesInFlight = 2;
+
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scene" && hasValue)
+            options.Scenes.push_back(argv[++i]);
+        else if (arg == "--frames" && hasValue)
+            options.Frames = (unsigned int)atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            options.Warmup = (unsigned int)atoi(argv[++i]);
+        else if (arg == "--width" && hasValue)
+            options.Width = atoi(argv[++i]);
+        else if (arg == "--height" && hasValue)
+            options.Height = atoi(argv[++i]);
+        else if (arg == "--msaa" && hasValue)
+            options.Samples = (unsigned int)std::max(atoi(argv[++i]), 1);
+        else if (arg == "--render-scale" && hasValue)
+            options.RenderScale = (float)atof(argv[++i]);
+        else if (arg == "--capture" && hasValue)
+            options.CapturePath = argv[++i];
+        else if (arg == "--ready-timeout" && hasValue)
+            options.ReadyTimeout = atof(argv[++i]);
+        else if (arg == "--sprite-kernels")
+            options.SpriteKernels = true;
+        else if (arg == "--output" && hasValue)
+            options.Output = argv[++i];
+        else
+        {
+            fprintf(stderr, "Unknown argument '%s'\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.Scenes.empty())
+        options.Scenes = scene::GetSceneNames();
+    if (options.Frames == 0 || options.Width <= 0 || options.Height <= 0 || options.RenderScale < 0.25f || options.RenderScale > 2.0f ||
+        options.ReadyTimeout <= 0.0)
+        return false;
+    return true;
+}
+
+static double Percentile(std::vector<double> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(percentile * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+static BenchmarkResult RunScene(const std::string& name, const BenchmarkOptions& options, Framebuffer& target, FrameCapture& capture,
+    UniformBuffer& frameUniforms)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    BenchmarkResult result;
+    result.Scene = name;
+
+    std::unique_ptr<scene::Scene> currentScene = scene::CreateScene(name);
+    if (!currentScene)
+    {
+        fprintf(stderr, "Unknown scene '%s'\n", name.c_str());
+        result.Error = "unknown scene";
+        return result;
+    }
+
+    Renderer renderer;
+    FrameData frameData = {};
+    float aspect = (float)options.Width / options.Height;
+    Mat4 viewProjection = Mat4::Ortho(-aspect, aspect, -1.0f, 1.0f);
+    for (int i = 0; i < 16; i++)
+        frameData.ViewProjection[i] = viewProjection.Elements[i];
+
+    /* The simulation runs on a fixed step, so every run renders exactly the same frames. */
+    const float deltaTime = 1.0f / 60.0f;
+
+    FramePacer pacer(MaxFramesInFlight);
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.Frames);
+    unsigned long long drawCalls = 0, triangles = 0, allocations = 0;
+    LinearArena& frameArena = LinearArena::GetFrameArena();
+
+    /* Warmup frames also cover the time the scene needs to get its shaders. */
+    unsigned int frame = 0;
+    unsigned int measured = 0;
+    unsigned int warmup = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point last = start;
+    while (measured < options.Frames)
+    {
+        pacer.WaitForFrame();
+
+        Clock::time_point now = Clock::now();
+        double milliseconds = std::chrono::duration<double, std::milli>(now - last).count();
+        last = now;
+
+        /* Wall time rather than frames, a scene loading from disk may take few but long frames. */
+        if (!currentScene->IsReady() && std::chrono::duration<double>(now - start).count() > options.ReadyTimeout)
+        {
+            fprintf(stderr, "Error: %s was not ready after %.0f seconds, skipping it\n", name.c_str(), options.ReadyTimeout);
+            result.Error = "not ready in time";
+            GLCall(glFinish());
+            return result;
+        }
+
+        bool measuring = currentScene->IsReady() && warmup >= options.Warmup;
+        if (measuring && frame > 0)
+        {
+            frameTimes.push_back(milliseconds);
+            measured++;
+        }
+        else if (currentScene->IsReady())
+        {
+            warmup++;
+        }
+
+        frameArena.Reset();
+        const uint64_t allocationsBefore = AllocationCounter::GetStats().Allocations;
+
+        frameData.Time = frame * deltaTime;
+        frameUniforms.SetData(&frameData, sizeof(FrameData));
+
+        target.Bind();
+        renderer.Clear();
+        currentScene->OnUpdate(deltaTime);
+        currentScene->OnRender(1.0f);
+        target.Resolve();
+
+        if (measuring)
+        {
+            const unsigned long long frameAllocations = AllocationCounter::GetStats().Allocations - allocationsBefore;
+            allocations += frameAllocations;
+            result.MaxAllocations = std::max(result.MaxAllocations, frameAllocations);
+
+            scene::SceneStats stats = currentScene->GetStats();
+            drawCalls += stats.DrawCalls;
+            triangles += stats.Triangles;
+        }
+
+        GLCheckFrameErrors(name.c_str());
+        pacer.EndFrame(0.0);
+        frame++;
+    }
+
+    /* The last frame is read back after the measurements, so it can't affect them. */
+    if (!options.CapturePath.empty())
+    {
+        capture.Capture(target.GetResolvedID(), 0, 0, target.GetViewportWidth(), target.GetViewportHeight(),
+            options.CapturePath + "/" + name + ".tga");
+        capture.Finish();
+    }
+
+    /* Nothing of this scene may still be running when the next one is measured. */
+    GLCall(glFinish());
+
+    double total = 0.0;
+    for (double time : frameTimes)
+        total += time;
+
+    result.Frames = (unsigned int)frameTimes.size();
+    result.MinMilliseconds = *std::min_element(frameTimes.begin(), frameTimes.end());
+    result.MaxMilliseconds = *std::max_element(frameTimes.begin(), frameTimes.end());
+    result.AverageMilliseconds = total / frameTimes.size();
+    result.P99Milliseconds = Percentile(frameTimes, 0.99);
+    result.DrawCallsPerSecond = drawCalls / (total / 1000.0);
+    result.TrianglesPerSecond = triangles / (total / 1000.0);
+    result.AllocationsPerFrame = (double)allocations / frameTimes.size();
+    result.GpuMegabytes = GpuMemory::GetTotalBytes() / (1024.0 * 1024.0);
+    return result;
+}
+
+static std::vector<SpriteKernelResult> RunSpriteKernels()
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    /* Enough sprites that the vertices (14 MB) don't fit in the caches, like in the sprites scene. */
+    const unsigned int count = 100000;
+    const unsigned int runs = 20;
+
+    SpriteStore sprites(count);
+    uint32_t seed = 1;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const float random = (float)(seed >> 8) / 16777216.0f;
+        sprites.Add(random * 2.0f - 1.0f, 1.0f - random * 2.0f, random * 12.0f - 6.0f, 0.01f + random * 0.02f, 0.01f, seed);
+    }
+
+    std::vector<QuadVertex> reference(count * 4), vertices(count * 4);
+    sprites.WriteVertices(reference.data(), 0, count, 0.0f, SpriteStore::Kernel::Scalar);
+
+    std::vector<SpriteKernelResult> results;
+    const SpriteStore::Kernel kernels[] = { SpriteStore::Kernel::Scalar, SpriteStore::Kernel::SSE2, SpriteStore::Kernel::AVX2 };
+    for (SpriteStore::Kernel kernel : kernels)
+    {
+        if (!SpriteStore::IsSupported(kernel))
+            continue;
+
+        /* The first run touches every page of the output, so it isn't counted. */
+        double best = 0.0;
+        for (unsigned int run = 0; run <= runs; run++)
+        {
+            Clock::time_point start = Clock::now();
+            sprites.WriteVertices(vertices.data(), 0, count, 0.0f, kernel);
+            double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            if (run == 1 || (run > 1 && nanoseconds < best))
+                best = nanoseconds;
+        }
+
+        SpriteKernelResult result;
+        result.Kernel = kernel;
+        result.NanosecondsPerSprite = best / count;
+        result.Speedup = results.empty() ? 1.0 : results[0].NanosecondsPerSprite / result.NanosecondsPerSprite;
+
+        const float* a = (const float*)reference.data();
+        const float* b = (const float*)vertices.data();
+        const size_t floats = reference.size() * sizeof(QuadVertex) / sizeof(float);
+        for (size_t i = 0; i < floats; i++)
+            result.MaxError = std::max(result.MaxError, (double)std::abs(a[i] - b[i]));
+
+        results.push_back(result);
+    }
+    return results;
+}
+
+/* Scene names come from the command line and the GL strings from the driver, either can hold */
+/* characters JSON strings can't. */
+static std::string EscapeJson(const char* text)
+{
+    std::string escaped;
+    for (const char* c = text ? text : ""; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            escaped += '\\';
+            escaped += *c;
+        }
+        else if ((unsigned char)*c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", (unsigned char)*c);
+            escaped += code;
+        }
+        else
+            escaped += *c;
+    }
+    return escaped;
+}
+
+static void WriteResults(FILE* file, const std::vector<BenchmarkResult>& results, const std::vector<SpriteKernelResult>& spriteKernels,
+    const BenchmarkOptions& options)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"vendor\": \"%s\",\n", EscapeJson((const char*)glGetString(GL_VENDOR)).c_str());
+    fprintf(file, "  \"renderer\": \"%s\",\n", EscapeJson((const char*)glGetString(GL_RENDERER)).c_str());
+    fprintf(file, "  \"version\": \"%s\",\n", EscapeJson((const char*)glGetString(GL_VERSION)).c_str());
+    fprintf(file, "  \"width\": %d,\n  \"height\": %d,\n", options.Width, options.Height);
+    fprintf(file, "  \"msaa\": %u,\n  \"render_scale\": %.3f,\n", options.Samples, options.RenderScale);
+    fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        if (!result.Error.empty())
+        {
+            fprintf(file, "    { \"scene\": \"%s\", \"failed\": \"%s\" }%s\n", EscapeJson(result.Scene.c_str()).c_str(), result.Error.c_str(),
+                i + 1 < results.size() ? "," : "");
+            continue;
+        }
+        fprintf(file, "    { \"scene\": \"%s\", \"frames\": %u, \"min_ms\": %.4f, \"avg_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, "
+            "\"draw_calls_per_second\": %.1f, \"triangles_per_second\": %.1f, \"allocations_per_frame\": %.2f, \"max_allocations\": %llu, "
+            "\"gpu_memory_mb\": %.2f }%s\n",
+            EscapeJson(result.Scene.c_str()).c_str(), result.Frames, result.MinMilliseconds, result.AverageMilliseconds, result.P99Milliseconds,
+            result.MaxMilliseconds, result.DrawCallsPerSecond, result.TrianglesPerSecond, result.AllocationsPerFrame, result.MaxAllocations,
+            result.GpuMegabytes, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]");
+
+    if (options.SpriteKernels)
+    {
+        fprintf(file, ",\n  \"sprite_kernels\": [\n");
+        for (size_t i = 0; i < spriteKernels.size(); i++)
+        {
+            const SpriteKernelResult& result = spriteKernels[i];
+            fprintf(file, "    { \"kernel\": \"%s\", \"ns_per_sprite\": %.3f, \"speedup\": %.2f, \"max_error\": %.3g }%s\n",
+                SpriteStore::GetKernelName(result.Kernel), result.NanosecondsPerSprite, result.Speedup, result.MaxError,
+                i + 1 < spriteKernels.size() ? "," : "");
+        }
+        fprintf(file, "  ]");
+    }
+    fprintf(file, "\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        fprintf(stderr, "Usage: Benchmark [--scene name]... [--frames n] [--warmup n] [--width w] [--height h] [--msaa samples] "
+            "[--render-scale s] [--capture dir] [--sprite-kernels] [--output file.json]\n");
+        return 1;
+    }
+
+    if (!glfwInit())
+        return -1;
+
+    /* 4.3 if we can for the compute scenes, 3.3 otherwise, like the application. */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); // We only need the context, everything is drawn offscreen
+
+    GLFWwindow* window = glfwCreateWindow(options.Width, options.Height, "Benchmark", NULL, NULL);
+    if (!window)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        window = glfwCreateWindow(options.Width, options.Height, "Benchmark", NULL, NULL);
+    }
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (glewInit() != GLEW_OK)
+    {
+        fprintf(stderr, "Error: glewInit failed\n");
+        glfwTerminate();
+        return -1;
+    }
+
+    GLEnableDebugOutput(false);
+    ShaderCompiler::EnableParallelCompile();
+
+    /* Before any scene, so no driver or compiler thread is competing for the core. */
+    std::vector<SpriteKernelResult> spriteKernels;
+    if (options.SpriteKernels)
+    {
+        fprintf(stderr, "Running sprite kernels...\n");
+        spriteKernels = RunSpriteKernels();
+    }
+
+    std::vector<BenchmarkResult> results;
+    unsigned int failures = 0;
+    {
+        FramebufferSpec spec;
+        spec.Width = std::max(1, (int)(options.Width * options.RenderScale + 0.5f));
+        spec.Height = std::max(1, (int)(options.Height * options.RenderScale + 0.5f));
+        spec.Samples = options.Samples;
+        Framebuffer target(spec);
+        options.Samples = target.GetSamples(); // What the GPU supports, for the results
+
+        FrameCapture capture(1);
+        if (!options.CapturePath.empty())
+            FileSystem::MakeDirectories(options.CapturePath);
+
+        UniformBuffer frameUniforms(sizeof(FrameData), FrameData::BindingPoint);
+
+        for (const std::string& name : options.Scenes)
+        {
+            fprintf(stderr, "Running %s...\n", name.c_str());
+            results.push_back(RunScene(name, options, target, capture, frameUniforms));
+            if (!results.back().Error.empty())
+                failures++;
+        }
+    }
+
+    FILE* file = stdout;
+    if (!options.Output.empty())
+    {
+        file = fopen(options.Output.c_str(), "w");
+        if (!file)
+        {
+            fprintf(stderr, "Error: can't write %s\n", options.Output.c_str());
+            file = stdout;
+        }
+    }
+    WriteResults(file, results, spriteKernels, options);
+    if (file != stdout)
+        fclose(file);
+
+    glfwTerminate();
+    return failures == 0 ? 0 : 1;
+}
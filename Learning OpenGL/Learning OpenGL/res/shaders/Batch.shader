@@ -0,0 +1,77 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 3) in float a_TexIndex;
+
+out vec4 v_Color;
+out vec2 v_TexCoords;
+flat out int v_TexIndex;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoords = a_TexCoords;
+    v_TexIndex = int(a_TexIndex);
+    gl_Position = u_ViewProjection * a_Position;
+}
+
+#shader fragment
+#version 330 core
+
+#ifdef BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoords;
+flat in int v_TexIndex;
+
+#ifdef BINDLESS
+/* Two 64-bit handles per uvec4 (std140 pads every array element to 16 bytes), see BatchRenderer::MaxBindlessTextures. */
+layout(std140) uniform TextureHandles
+{
+    uvec4 u_TextureHandles[512];
+};
+
+void main()
+{
+    uvec4 pair = u_TextureHandles[v_TexIndex / 2];
+    uvec2 handle = (v_TexIndex % 2) == 0 ? pair.xy : pair.zw;
+    color = texture(sampler2D(handle), v_TexCoords) * v_Color;
+}
+#else
+uniform sampler2D u_Textures[16];
+
+void main()
+{
+    /* GLSL 3.30 only allows indexing sampler arrays with constant expressions, so we switch on the slot. */
+    vec4 texColor;
+    switch (v_TexIndex)
+    {
+        case  0: texColor = texture(u_Textures[ 0], v_TexCoords); break;
+        case  1: texColor = texture(u_Textures[ 1], v_TexCoords); break;
+        case  2: texColor = texture(u_Textures[ 2], v_TexCoords); break;
+        case  3: texColor = texture(u_Textures[ 3], v_TexCoords); break;
+        case  4: texColor = texture(u_Textures[ 4], v_TexCoords); break;
+        case  5: texColor = texture(u_Textures[ 5], v_TexCoords); break;
+        case  6: texColor = texture(u_Textures[ 6], v_TexCoords); break;
+        case  7: texColor = texture(u_Textures[ 7], v_TexCoords); break;
+        case  8: texColor = texture(u_Textures[ 8], v_TexCoords); break;
+        case  9: texColor = texture(u_Textures[ 9], v_TexCoords); break;
+        case 10: texColor = texture(u_Textures[10], v_TexCoords); break;
+        case 11: texColor = texture(u_Textures[11], v_TexCoords); break;
+        case 12: texColor = texture(u_Textures[12], v_TexCoords); break;
+        case 13: texColor = texture(u_Textures[13], v_TexCoords); break;
+        case 14: texColor = texture(u_Textures[14], v_TexCoords); break;
+        default: texColor = texture(u_Textures[15], v_TexCoords); break;
+    }
+    color = texColor * v_Color;
+}
+#endif
@@ -0,0 +1,98 @@
+#shader compute
+#version 430 core
+
+/* One invocation per object: tests its bounding sphere against the view frustum and the */
+/* depth pyramid of the previous frame, then writes its draw command, see GpuCuller. */
+
+layout(local_size_x = 64) in;
+
+struct DrawCommand
+{
+    uint Count;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Bounds { vec4 b_Bounds[]; }; // Center xyz, radius w
+layout(std430, binding = 1) readonly buffer Input { DrawCommand b_Input[]; };
+layout(std430, binding = 2) writeonly buffer Output { DrawCommand b_Output[]; };
+layout(std430, binding = 3) buffer Counters
+{
+    uint b_Visible;
+    uint b_Triangles;
+};
+
+uniform vec4 u_Planes[6];
+uniform int u_ObjectCount;
+
+uniform int u_Occlusion;
+uniform mat4 u_PyramidViewProjection;
+uniform vec2 u_PyramidSize;
+uniform float u_PyramidMaxLevel;
+uniform sampler2D u_Pyramid;
+
+bool IsInsideFrustum(vec3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(u_Planes[i].xyz, center) + u_Planes[i].w < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool IsOccluded(vec3 center, float radius)
+{
+    /* The screen rectangle and nearest depth of the sphere's bounding box, as the previous frame saw it. */
+    vec2 minimum = vec2(1.0);
+    vec2 maximum = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = u_PyramidViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0)
+            return false; // Crosses the camera plane, we can't tell
+
+        vec3 ndc = clip.xyz / clip.w;
+        minimum = min(minimum, ndc.xy * 0.5 + 0.5);
+        maximum = max(maximum, ndc.xy * 0.5 + 0.5);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+    minimum = clamp(minimum, 0.0, 1.0);
+    maximum = clamp(maximum, 0.0, 1.0);
+
+    /* On the level where the rectangle is at most one texel wide it touches at most 2x2 texels. */
+    vec2 extent = (maximum - minimum) * u_PyramidSize;
+    float level = min(ceil(log2(max(max(extent.x, extent.y), 1.0))), u_PyramidMaxLevel);
+
+    float farthest = max(max(textureLod(u_Pyramid, minimum, level).r, textureLod(u_Pyramid, vec2(maximum.x, minimum.y), level).r),
+                         max(textureLod(u_Pyramid, vec2(minimum.x, maximum.y), level).r, textureLod(u_Pyramid, maximum, level).r));
+    return nearest > farthest;
+}
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= uint(u_ObjectCount))
+        return;
+
+    vec4 bounds = b_Bounds[id];
+    bool visible = IsInsideFrustum(bounds.xyz, bounds.w);
+    if (visible && u_Occlusion != 0)
+        visible = !IsOccluded(bounds.xyz, bounds.w);
+
+    DrawCommand command = b_Input[id];
+    if (visible)
+    {
+        atomicAdd(b_Visible, 1u);
+        atomicAdd(b_Triangles, command.Count / 3u * command.InstanceCount);
+    }
+    else
+    {
+        command.InstanceCount = 0u;
+    }
+    b_Output[id] = command;
+}
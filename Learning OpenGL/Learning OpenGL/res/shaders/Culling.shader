@@ -0,0 +1,29 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Position;  // Mesh vertex, from the shared MeshPool buffer
+layout(location = 1) in vec4 a_Transform; // Per draw: center xy, scale zw
+layout(location = 2) in float a_Depth;    // Per draw
+layout(location = 3) in vec4 a_Color;     // Per draw
+
+uniform mat4 u_ViewProjection; // The scene's own camera, which the culling uses too
+
+out vec4 v_Color;
+
+void main()
+{
+    v_Color = a_Color;
+    gl_Position = u_ViewProjection * vec4(a_Transform.xy + a_Position * a_Transform.zw, a_Depth, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
@@ -0,0 +1,51 @@
+#shader compute
+#version 430 core
+
+/* Builds one level of a DepthPyramid. Level 0 copies the depth texture, the other levels */
+/* keep the farthest of the texels they cover in the level before, see DepthPyramid::Build. */
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D u_Depth;
+uniform int u_FromDepth;
+uniform ivec2 u_SourceSize;
+
+layout(r32f, binding = 1) readonly uniform image2D u_Source;
+layout(r32f, binding = 0) writeonly uniform image2D u_Destination;
+
+float LoadSource(ivec2 texel)
+{
+    return imageLoad(u_Source, min(texel, u_SourceSize - 1)).r;
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(u_Destination);
+    if (texel.x >= size.x || texel.y >= size.y)
+        return;
+
+    float depth;
+    if (u_FromDepth != 0)
+    {
+        depth = texelFetch(u_Depth, texel, 0).r;
+    }
+    else
+    {
+        ivec2 source = texel * 2;
+        depth = max(max(LoadSource(source), LoadSource(source + ivec2(1, 0))),
+                    max(LoadSource(source + ivec2(0, 1)), LoadSource(source + ivec2(1, 1))));
+
+        /* With an odd source size the last column/row would otherwise be covered by no texel at all. */
+        bool extraColumn = (u_SourceSize.x & 1) != 0 && texel.x == size.x - 1;
+        bool extraRow = (u_SourceSize.y & 1) != 0 && texel.y == size.y - 1;
+        if (extraColumn)
+            depth = max(depth, max(LoadSource(source + ivec2(2, 0)), LoadSource(source + ivec2(2, 1))));
+        if (extraRow)
+            depth = max(depth, max(LoadSource(source + ivec2(0, 2)), LoadSource(source + ivec2(1, 2))));
+        if (extraColumn && extraRow)
+            depth = max(depth, LoadSource(source + ivec2(2, 2)));
+    }
+
+    imageStore(u_Destination, texel, vec4(depth));
+}
@@ -0,0 +1,30 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec2 a_Position;  // Mesh vertex, from the shared MeshPool buffer
+layout(location = 1) in vec4 a_Transform; // Per draw: center xy, scale zw
+layout(location = 2) in vec4 a_Color;     // Per draw
+
+out vec4 v_Color;
+
+void main()
+{
+    /* Every draw of the multi-draw has its own BaseInstance, so these per-instance */
+    /* attributes hold the data of the draw the vertex belongs to. */
+    v_Color = a_Color;
+    gl_Position = u_ViewProjection * vec4(a_Transform.xy + a_Position * a_Transform.zw, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
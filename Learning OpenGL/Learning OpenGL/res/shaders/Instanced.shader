@@ -0,0 +1,28 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in mat4 a_Transform; // Per instance, locations 1 to 4
+layout(location = 5) in vec4 a_Color;     // Per instance
+
+out vec4 v_Color;
+
+void main()
+{
+    v_Color = a_Color;
+    gl_Position = u_ViewProjection * a_Transform * a_Position;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
@@ -0,0 +1,74 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+/* The same inputs read full floats or MeshQuantizer's compact vertices, the vertex fetch converts. */
+layout(location = 0) in vec3 a_Position;  // float, or snorm16 inside the mesh bounds
+layout(location = 1) in vec3 a_Normal;    // float, or snorm 10_10_10
+layout(location = 2) in vec4 a_Tangent;   // float, or snorm 10_10_10_2 with the handedness in w
+layout(location = 3) in vec2 a_TexCoords; // float, or half
+layout(location = 4) in vec4 a_Color;     // float, or unorm8
+
+uniform vec3 u_PositionScale;  // (1, 1, 1) for float vertices
+uniform vec3 u_PositionOffset; // (0, 0, 0) for float vertices
+uniform ivec2 u_GridSize;
+
+out vec3 v_Normal;
+out vec3 v_Tangent;
+out vec3 v_Bitangent;
+out vec2 v_TexCoords;
+out vec4 v_Color;
+
+vec3 RotateY(vec3 v, float angle)
+{
+    float s = sin(angle);
+    float c = cos(angle);
+    return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+void main()
+{
+    vec3 position = a_Position * u_PositionScale + u_PositionOffset;
+
+    /* Every instance sits in its own cell of the grid and spins at its own phase. */
+    ivec2 cell = ivec2(gl_InstanceID % u_GridSize.x, gl_InstanceID / u_GridSize.x);
+    vec2 cellSize = 2.0 / vec2(u_GridSize);
+    vec2 center = -1.0 + (vec2(cell) + 0.5) * cellSize;
+    float radius = 0.45 * min(cellSize.x, cellSize.y);
+    float angle = u_Time * 0.5 + float(gl_InstanceID) * 0.7;
+
+    v_Normal = RotateY(normalize(a_Normal), angle);
+    v_Tangent = RotateY(normalize(a_Tangent.xyz), angle);
+    v_Bitangent = cross(v_Normal, v_Tangent) * (a_Tangent.w < 0.0 ? -1.0 : 1.0);
+    v_TexCoords = a_TexCoords;
+    v_Color = a_Color;
+
+    vec3 rotated = RotateY(position, angle) * radius;
+    gl_Position = u_ViewProjection * vec4(center + rotated.xy, rotated.z, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec3 v_Tangent;
+in vec3 v_Bitangent;
+in vec2 v_TexCoords;
+in vec4 v_Color;
+
+void main()
+{
+    /* A procedural bump map of fine ridges, built on the tangent frame, so errors in any attribute show up. */
+    vec2 bump = vec2(cos(v_TexCoords.x * 251.3), cos(v_TexCoords.y * 125.7)) * 0.25;
+    vec3 normal = normalize(normalize(v_Normal) + bump.x * normalize(v_Tangent) + bump.y * normalize(v_Bitangent));
+
+    vec3 light = normalize(vec3(-0.4, 0.6, 0.7));
+    vec3 halfway = normalize(light + vec3(0.0, 0.0, 1.0));
+    float diffuse = max(dot(normal, light), 0.0);
+    float specular = pow(max(dot(normal, halfway), 0.0), 48.0);
+
+    color = vec4(v_Color.rgb * (0.15 + 0.85 * diffuse) + vec3(specular * 0.5), v_Color.a);
+}
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec2 a_Position; // Unit quad, [0, 1]
+
+uniform vec4 u_Rect; // x, y, width, height
+
+out vec2 v_TexCoord;
+
+void main()
+{
+    v_TexCoord = a_Position;
+    gl_Position = u_ViewProjection * vec4(u_Rect.xy + a_Position * u_Rect.zw, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform vec4 u_Color;
+
+#ifdef TEXTURED
+uniform sampler2D u_Texture; // Unit 0
+#endif
+
+void main()
+{
+#ifdef INVERT
+    color = vec4(1.0 - u_Color.rgb, u_Color.a);
+#else
+    color = u_Color;
+#endif
+#ifdef TEXTURED
+    color *= texture(u_Texture, v_TexCoord);
+#endif
+}
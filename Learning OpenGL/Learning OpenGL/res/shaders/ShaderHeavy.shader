@@ -0,0 +1,44 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec4 a_Position;
+
+out vec2 v_Position;
+
+void main()
+{
+    v_Position = a_Position.xy;
+    gl_Position = u_ViewProjection * a_Position;
+}
+
+#shader fragment
+#version 330 core
+
+#include "common/Frame.glsl"
+
+#ifndef ITERATIONS
+#define ITERATIONS 256
+#endif
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_Position;
+
+void main()
+{
+    /* A slowly zooming Mandelbrot set, every fragment runs the full loop. */
+    float zoom = 1.5 + sin(u_Time * 0.25);
+    vec2 c = v_Position * zoom - vec2(0.75, 0.0);
+    vec2 z = vec2(0.0);
+    float escaped = 0.0;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        z = vec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + c;
+        escaped += step(dot(z, z), 4.0);
+    }
+
+    float t = escaped / float(ITERATIONS);
+    color = vec4(t, t * t, sqrt(t), 1.0);
+}
@@ -0,0 +1,30 @@
+#shader vertex
+#version 330 core
+
+#include "common/Frame.glsl"
+
+layout(location = 0) in vec2 a_Position; // Unit quad, [0, 1]
+layout(location = 1) in vec4 a_Rect;     // Per instance: x, y, width, height
+layout(location = 2) in float a_Layer;   // Per instance
+
+out vec3 v_TexCoords;
+
+void main()
+{
+    v_TexCoords = vec3(a_Position, a_Layer);
+    gl_Position = u_ViewProjection * vec4(a_Rect.xy + a_Position * a_Rect.zw, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_TexCoords;
+
+uniform sampler2DArray u_Layers;
+
+void main()
+{
+    color = texture(u_Layers, v_TexCoords);
+}
@@ -0,0 +1,6 @@
+/* Per-frame data shared by every program, uploaded once per frame from main(). Matches FrameData in Renderer.h. */
+layout(std140) uniform Frame
+{
+    mat4 u_ViewProjection;
+    float u_Time;
+};
@@ -0,0 +1,185 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    std::atomic<uint64_t> s_Allocations(0);
+    std::atomic<uint64_t> s_Frees(0);
+    std::atomic<uint64_t> s_Bytes(0);
+
+    void* CountedAllocate(size_t size)
+    {
+        s_Allocations.fetch_add(1, std::memory_order_relaxed);
+        s_Bytes.fetch_add(size, std::memory_order_relaxed);
+        return malloc(size ? size : 1); // new must return a unique pointer even for 0 bytes
+    }
+
+    void CountedFree(void* pointer)
+    {
+        if (!pointer)
+            return;
+        s_Frees.fetch_add(1, std::memory_order_relaxed);
+        free(pointer);
+    }
+
+#ifdef __cpp_aligned_new
+    /* Memory from these can't be given to free on every platform, so it has its own pair. */
+    void* CountedAllocateAligned(size_t size, std::align_val_t alignment)
+    {
+        s_Allocations.fetch_add(1, std::memory_order_relaxed);
+        s_Bytes.fetch_add(size, std::memory_order_relaxed);
+        const size_t align = (size_t)alignment;
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        /* aligned_alloc wants a size that is a multiple of the alignment. */
+        return aligned_alloc(align, size ? (size + align - 1) / align * align : align);
+#endif
+    }
+
+    void CountedFreeAligned(void* pointer)
+    {
+        if (!pointer)
+            return;
+        s_Frees.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        free(pointer);
+#endif
+    }
+#endif
+
+}
+
+AllocationCounter::Stats AllocationCounter::GetStats()
+{
+    Stats stats;
+    stats.Allocations = s_Allocations.load(std::memory_order_relaxed);
+    stats.Frees = s_Frees.load(std::memory_order_relaxed);
+    stats.Bytes = s_Bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/* The replaceable global allocation functions. Placement new does not allocate, and the */
+/* aligned forms of C++17 don't forward to the plain ones (neither on MSVC nor on libstdc++), */
+/* so they are replaced as well, further down, when the compiler has them. */
+
+void* operator new(size_t size)
+{
+    void* pointer = CountedAllocate(size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    void* pointer = CountedAllocate(size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    CountedFree(pointer);
+}
+
+#ifdef __cpp_aligned_new
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* pointer = CountedAllocateAligned(size, alignment);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    void* pointer = CountedAllocateAligned(size, alignment);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    CountedFreeAligned(pointer);
+}
+
+#endif
@@ -1,162 +1,63 @@
-#include <GL/glew.h> // We need to include glew.h before any OpenGL .h file
+#include "Renderer.h"
+#include "StreamBuffer.h"
+#include "StateCache.h"
+#include "UniformBuffer.h"
+#include "ShaderCompiler.h"
+#include "ShaderPreprocessor.h"
+#include "HotReloader.h"
+#include "Framebuffer.h"
+#include "DynamicResolution.h"
+#include "FrameCapture.h"
+#include "GpuMemory.h"
+#include "FileSystem.h"
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include "LinearArena.h"
+#include "Config.h"
+#include "FrameLimiter.h"
+#include "FramePacer.h"
+#include "FixedTimestep.h"
+#include "SimulationThread.h"
+#include "Math.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <string>
-#include <sstream>
 
-#define ASSERT(x) if (!(x)) __debugbreak(); // Compiler intrinsic function
-#define GLCall(x) GLClearErrors();\
-    x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__)) 
+#include "scenes/SceneRegistry.h"
 
-// #x turns the function name into a string
-// __FILE__ indicates the file from which the function was called
-// __LINE__ indicates the line of the function that was called
-
-static void GLClearErrors()
-{
-    while (glGetError() != GL_NO_ERROR);
-}
-
-static bool GLLogCall(const char* function, const char* file, int line)
-{
-    while (GLenum error = glGetError())
-    {
-        std::cout << "[OpenGL Error] (" << error << "): " << function << " " << file << ":" << line << std::endl;
-        return false;
-    }
-    return true;
-}
-
-
-struct ShaderProgramSource
-{
-    std::string VertexSource;
-    std::string FragmentSource;
-};
-
-static ShaderProgramSource ParseShader(const std::string& filepath)
-{
-    std::ifstream stream(filepath);
-
-    enum class ShaderType { NONE = -1, VERTEX = 0, FRAGMENT = 1 };
-
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
-
-    while (getline(stream, line))
-    {
-        if (line.find("#shader") != std::string::npos)
-        {
-            if (line.find("vertex") != std::string::npos)
-            {
-                type = ShaderType::VERTEX;
-            }
-            else if (line.find("fragment") != std::string::npos)
-            {
-                type = ShaderType::FRAGMENT;
-            }
-        }
-        else
-        {
-            ss[(int)type] << line << '\n';
-        }
-    }
-
-    return { ss[0].str(), ss[1].str() };
-}
-
-static unsigned int CompileShader(unsigned int type, const std::string& source)
-{
-    // glCreateShader creates an empty shader object and returns a non-zero value by which it can be referenced. 
-    // A shader object is used to maintain the source code strings that define a shader.
-    unsigned int id = glCreateShader(type);
-
-    const char* src = source.c_str(); // This is a pointer to the beginning of the string data
-
-    // glShaderSource sets the source code in shader to the source code in the array of strings specified by string.
-    // Any source code previously stored in the shader object is completely replaced.The number of strings in the array is specified by count.
-    // If length is NULL, each string is assumed to be null terminated.
-    // If length is a value other than NULL, it points to an array containing a string length for each of the corresponding elements of string.
-    glShaderSource(id, 1, &src, nullptr);
-
-    // glCompileShader compiles the source code strings that have been stored in the shader object specified by shader.
-    glCompileShader(id);
-
-    // The next code is used for checking any possible error in the compilation of the shader
-    int result;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
-    if (result == GL_FALSE) // The shader has not compiled successfully
-    {
-        int length;
-        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
-        char* message = (char*)alloca(length * sizeof(char)); // alloca is a function that allocates memory dynamically
-        glGetShaderInfoLog(id, length, &length, message);
-        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!" << std::endl;
-        std::cout << &message << std::endl;
-        glDeleteShader(id);
-        return 0;
-    }
-
-    return id;
-}
-
-// This function will provide OpenGL with the source code of the vertex shader and the fragment shader.
-// And we want OpenGL to compile that program and link them together, and give a unique identifier for that shader back.
-static unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
-{
-    // glCreateProgram creates an empty program object and returns a non-zero value by which it can be referenced. 
-    // A program object is an object to which shader objects can be attached. This provides a mechanism to specify the shader objects 
-    // that will be linked to create a program. It also provides a means for checking the compatibility of the shaders that will 
-    // be used to create a program (for instance, checking the compatibility between a vertex shader and a fragment shader). 
-    // When no longer needed as part of a program object, shader objects can be detached.
-    unsigned int program = glCreateProgram();
-
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
-
-    // In order to create a complete shader program, there must be a way to specify the list of things that will be linked together.
-    // Program objects provide this mechanism. Shaders that are to be linked together in a program object must first be attached to that program object.
-    // glAttachShader attaches the shader object specified by shader to the program object specified by program.This indicates that shader will 
-    // be included in link operations that will be performed on program.
-    GLCall(glAttachShader(program, vs));
-    GLCall(glAttachShader(program, fs));
-
-    // glLinkProgram links the program object specified by program. 
-    // If any shader objects of type GL_VERTEX_SHADER are attached to program, they will be used to create an executable that will run on the programmable vertex processor. 
-    // If any shader objects of type GL_GEOMETRY_SHADER are attached to program, they will be used to create an executable that will run on the programmable geometry processor. 
-    // If any shader objects of type GL_FRAGMENT_SHADER are attached to program, they will be used to create an executable that will run on the programmable fragment processor.
-    GLCall(glLinkProgram(program));
-
-    // glValidateProgram checks to see whether the executables contained in program can execute given the current OpenGL state. 
-    // The information generated by the validation process will be stored in program's information log. 
-    // The validation information may consist of an empty string, or it may be a string containing information about how the current program object 
-    // interacts with the rest of current OpenGL state. This provides a way for OpenGL implementers to convey more information about why the current 
-    // program is inefficient, suboptimal, failing to execute, and so on.
-    GLCall(glValidateProgram(program));
-
-    GLCall(glDeleteShader(vs));
-    GLCall(glDeleteShader(fs));
-
-    return program;
-}
-
-int main(void)
+int main(int argc, char** argv)
 {
     GLFWwindow* window;
 
+    Config config;
+    if (!config.ParseArgs(argc, argv))
+        return -1;
+
     /* Initialize the library */
     if (!glfwInit())
         return -1;
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, config.GLMajor);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, config.GLMinor);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef _DEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE); // Debug contexts report much more through GL_KHR_debug
+#endif
 
     /* Create a windowed mode window and its OpenGL context */
-    window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
+    window = glfwCreateWindow(config.Width, config.Height, config.Title.c_str(), NULL, NULL);
+    if (!window && (config.GLMajor > 3 || config.GLMinor > 3))
+    {
+        /* Older drivers can't do 4.3, the 3.3 path still runs everything but the compute scenes. */
+        fprintf(stdout, "Status: OpenGL %d.%d not available, falling back to 3.3\n", config.GLMajor, config.GLMinor);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        window = glfwCreateWindow(config.Width, config.Height, config.Title.c_str(), NULL, NULL);
+    }
     if (!window)
     {
         glfwTerminate();
@@ -169,7 +70,7 @@ int main(void)
     /* This function sets the swap interval for the current OpenGL or OpenGL ES context, i.e. the number of screen updates */
     /* to wait from the time glfwSwapBuffers was called before swapping the buffers and returning. */
     /* This is sometimes called vertical synchronization, vertical retrace synchronization or just vsync.*/
-    glfwSwapInterval(1);
+    int swapInterval = FrameLimiter::ApplySwapInterval(config.SwapInterval);
 
     /* Initializing GLEW */
     GLenum err = glewInit();
@@ -182,126 +83,308 @@ int main(void)
     /* We are printing the version for both OpenGL and GLEW */
     fprintf(stdout, "Status: Using OpenGL %s\n", glGetString(GL_VERSION));
     fprintf(stdout, "Status: Using GLEW %s\n", glewGetString(GLEW_VERSION));
-
-    /* CREATING A VERTEX BUFFER THAT CONTAINS THE DATA TO DRAW A TRIANGLE */
-
-    /* These are going to be the vertices of the triangle. */
-    /* Vertices may contain way more data than just the position. */
-    /* When talking about the position, we will be talking about Vertex Position, not only about Vertex. */
-    float positions[8] = {
-        -0.5f, -0.5f,
-         0.5f, -0.5f,
-         0.5f,  0.5f,
-        -0.5f, 0.5f
-    };
-
-    /* These indices are the ones that we will be using to draw the rectangle, indicating the different vertices. */
-    unsigned int indices[6] = {
-        0, 1, 2,
-        2, 3, 0
-    };
-
-    /* Vertex Array Object */
-    unsigned int vao;
-    GLCall(glGenVertexArrays(1, &vao));
-    GLCall(glBindVertexArray(vao));
-
-    /* In this case, we are returning 1 buffer object into buffer. */
-    unsigned int buffer;
-    GLCall(glGenBuffers(1, &buffer));
-    
-    /* Once we have generated a buffer, we need to select it, and that is done with glBindBuffer. */
-    /* In this case, we are binding the buffer into GL_ARRAY_BUFFER, which simply means that the */
-    /* purpose of the buffer will be of being an array of Vertex Attributes. */
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer));
-
-    /* Once we have bound the buffer, we need to tell OpenGL how the layout of the data is going to be. */
-    /* This means whether the vertices are going to be in 2D or in 3D, and how to treat them. */
-
-    /* We first need to enable the Vertex Attribute. */
-    GLCall(glEnableVertexAttribArray(0));
-
-    /* Then we need to actually create the Vertex Attribute. */
-    /* 1) index */
-    /* 2) size = 2 because we are in 2D, and each vertex will have two floats. */
-    /* 3) type = GL_FLOAT because we are working with floats. */
-    /* 5) stride = the amount of bytes between each vertex, which is the size of the vertex position plus the size of the texture coordinate plus the size of the normal. */
-    /* 6) pointer = pointer into the actual attribute. */
-    /*    The offset for the position will be 0, the offset for the texture coordinate will be 12, and the offset for the normal will be 20. */
-    GLCall(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0));
-
-    /* We now need to give data to the buffer. This can be done either by directly giving data to the buffer */
-    /* or we can give it nothing and later pass the data. We are going to provide data straighaway. */
-    GLCall(glBufferData(GL_ARRAY_BUFFER, 4 * 2 * sizeof(float), positions, GL_STATIC_DRAW));
-
-    /* Sending the indices data to the gpu. */
-    unsigned int ibo;
-    GLCall(glGenBuffers(1, &ibo));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), indices, GL_STATIC_DRAW));
-
-    /* Creating a shader */
-    ShaderProgramSource source = ParseShader("res/shaders/Basic.shader");
-    unsigned int shader = CreateShader(source.VertexSource, source.FragmentSource);
-    GLCall(glUseProgram(shader)); // glUseProgram installs the program object specified by program as part of current rendering state
-
-    GLCall(int location = glGetUniformLocation(shader, "u_Color"));
-    ASSERT(location != -1);
-    GLCall(glUniform4f(0, 1.0f, 0.5f, 0.5f, 1.0f));
-
-    GLCall(glBindVertexArray(0));
-    GLCall(glUseProgram(0));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo));
-
-    float r = 0.0f;
-    float increment = 0.05f;
-
-    /* Loop until the user closes the window */
-    while (!glfwWindowShouldClose(window))
+    fprintf(stdout, "Status: Swap interval %d%s\n", swapInterval, swapInterval != config.SwapInterval ? " (adaptive vsync not supported)" : "");
+    if (config.FpsLimit > 0.0)
+        fprintf(stdout, "Status: Limiting to %.1f fps\n", config.FpsLimit);
+    if (config.LowLatency)
+        fprintf(stdout, "Status: Low latency mode, input is polled right before each frame\n");
+    fprintf(stdout, "Status: Streaming vertex data through %s\n", StreamBuffer::IsPersistentMappingSupported() ? "persistent mapping" : "buffer orphaning");
+
+    /* Lets the driver compile shaders on as many threads as it likes, see ShaderCompiler. */
+    if (ShaderCompiler::EnableParallelCompile())
+        fprintf(stdout, "Status: Compiling shaders in parallel\n");
+
+    /* When per-call checking is enabled we want the debug callback to run inside the failing call, */
+    /* otherwise we let the driver report asynchronously so it never blocks. */
+    if (!GLEnableDebugOutput(GLCALL_CHECK_LEVEL == GLCALL_CHECK_CALL))
+        fprintf(stdout, "Status: GL_KHR_debug not available, relying on glGetError\n");
+
+    /* This scope makes sure every OpenGL object is destroyed before glfwTerminate destroys the context. */
     {
-        /* Render here */
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        GLCall(glUseProgram(shader)); // We bind our shader
-        GLCall(glUniform4f(0, r, 0.5f, 0.5f, 1.0f)); // We setup our uniform
-        GLCall(glBindVertexArray(vao));
-        GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer)); // We bind our vertex buffer
-
-        /* We are going to change color over time of our rectangle. */
-        r += increment;
-        if (r >= 1.0f)
-            increment *= -1.0f;
-        else if (r <= 0.0f)
-            increment *= -1.0f;
-
-        /* We can draw in two different ways: */
-        /* 1) glDrawArrays: we use this if we do not have an IndexBuffer. */
-        // glDrawArrays(GL_TRIANGLES, 0, 3);
-
-        /* 2) glDrawElements: we use this if we have an IndexBuffer. */
-        // GLClearErrors();
-        // glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-        // ASSERT(GLLogCall());
-
-        GLCall(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr));
-
-        /* How does OpenGL know that it has to draw the triangle specified before? */
-        /* OpenGL will draw whatever is currently bound. In our case, we called to */
-        /* glBindBuffer before, and haven't bound anything else, so it will draw the */
-        /* triangle that has been passed to the buffer. */
-        /* If before having called to glDrawArrays we had bound a different buffer, then */
-        /* OpenGL would draw what is contained in that buffer, and not the triangle we want to draw.*/
-
-        /* Swap front and back buffers */
-        glfwSwapBuffers(window);
-
-        /* Poll for and process events */
-        glfwPollEvents();
-    }
+        /* The scene to run can be picked on the command line, e.g. "Learning OpenGL.exe instanced". */
+        /* "--trace file.json" records every profiled scope and writes a Chrome trace when the window is closed. */
+        const std::string& sceneName = config.Scene;
+        const std::string& tracePath = config.TracePath;
+
+        Profiler::Init();
+        GpuMemory::SetBudget((uint64_t)config.GpuBudget * 1024 * 1024);
+        if (!tracePath.empty())
+            Profiler::StartTrace();
+
+        std::unique_ptr<scene::Scene> currentScene = scene::CreateScene(sceneName);
+        if (!currentScene)
+        {
+            std::cout << "Unknown scene '" << sceneName << "', available scenes:";
+            for (const std::string& name : scene::GetSceneNames())
+                std::cout << " " << name;
+            std::cout << std::endl;
+            currentScene = scene::CreateScene("batch");
+        }
+
+        const ShaderPreprocessor::Stats& shaderStats = ShaderPreprocessor::GetTotalStats();
+        std::cout << "Status: Preprocessed " << shaderStats.Files << " shader files (" << shaderStats.Bytes << " bytes, "
+            << shaderStats.Includes << " includes) in " << shaderStats.Milliseconds << " ms" << std::endl;
+
+        if (config.HotReload)
+        {
+            if (HotReloader::Start("res"))
+                std::cout << "Status: Watching res/ for changes, shaders and textures reload when saved" << std::endl;
+            else
+                std::cout << "Status: Can't watch res/, hot reload is off" << std::endl;
+        }
 
-    glDeleteProgram(shader);
+        Renderer renderer;
+
+        /* The camera and the time are the same for every program, so they are uploaded once per frame */
+        /* into a uniform buffer that every shader reads through its "Frame" block. */
+        UniformBuffer frameUniforms(sizeof(FrameData), FrameData::BindingPoint);
+        FrameData frameData = {};
+
+        /* With MSAA or a render scale the scene goes into sceneTarget, created with the first frame, */
+        /* and is scaled onto the window from there. Otherwise it is drawn into the window directly. */
+        std::unique_ptr<Framebuffer> sceneTarget;
+        DynamicResolution resolution(config.RenderScale, config.DynamicResolution);
+
+        /* F12 saves a screenshot, --capture dir saves every frame. Neither waits for the GPU. */
+        FrameCapture capture;
+        std::string capturePath; // Reused for every frame, so continuous capture doesn't allocate
+        unsigned int captureFrame = 0, screenshotCount = 0;
+        bool screenshotKeyDown = false;
+        if (!config.CapturePath.empty())
+        {
+            FileSystem::MakeDirectories(config.CapturePath);
+            std::cout << "Status: Capturing every frame to " << config.CapturePath << "/" << std::endl;
+        }
+
+        FrameLimiter limiter(config.FpsLimit);
+        FramePacer pacer(config.FramesInFlight > 0 ? config.FramesInFlight : (config.LowLatency ? 1 : 0));
+
+        /* When input was last polled, the start of the input-to-present latency of the next frame. */
+        double inputTime = glfwGetTime();
+
+        /* The scene simulates at a fixed rate whatever the frame rate, either here between frames */
+        /* or on its own thread, and rendering interpolates between the last two steps. */
+        FixedTimestep timestep(config.SimulationRate);
+        SimulationThread simulation(config.SimulationRate);
+        unsigned int simulationSteps = 0;
+        if (config.SimulationThread)
+        {
+            scene::Scene* simulatedScene = currentScene.get();
+            simulation.Start([simulatedScene](float step) { simulatedScene->OnUpdate(step); });
+        }
+
+        double lastTime = glfwGetTime();
+        double lastReport = lastTime;
+
+        /* Heap allocations made while building frames, reported with the other stats. */
+        unsigned long long frameAllocations = 0, maxFrameAllocations = 0;
+        unsigned int reportFrames = 0;
+        LinearArena& frameArena = LinearArena::GetFrameArena();
+
+        /* Loop until the user closes the window */
+        while (!glfwWindowShouldClose(window))
+        {
+            /* In low latency mode all the waiting (frame limiter, GPU) happens before we poll, */
+            /* so the frame is built from input that is as fresh as possible. */
+            if (config.LowLatency)
+            {
+                limiter.Wait();
+                pacer.WaitForFrame();
+                glfwPollEvents();
+                inputTime = glfwGetTime();
+            }
+            else
+            {
+                pacer.WaitForFrame();
+            }
+
+            double now = glfwGetTime();
+            double frameTime = now - lastTime;
+            lastTime = now;
+
+            StateCache::ResetStats();
+            Profiler::BeginFrame();
+
+            /* Everything a frame allocated from the arena is garbage by now. */
+            frameArena.Reset();
+            const AllocationCounter::Stats frameStart = AllocationCounter::GetStats();
+
+            /* The scenes live in [-1, 1], we only widen the view so they keep their aspect ratio. */
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            float aspect = height > 0 ? (float)width / height : 1.0f;
+            Mat4 viewProjection = Mat4::Ortho(-aspect, aspect, -1.0f, 1.0f);
+            for (int i = 0; i < 16; i++)
+                frameData.ViewProjection[i] = viewProjection.Elements[i];
+            frameData.Time = (float)now;
+            frameUniforms.SetData(&frameData, sizeof(FrameData));
+
+            {
+                /* Before anything is drawn, so the whole frame sees the same programs. */
+                PROFILE_SCOPE("HotReload");
+                HotReloader::Update();
+            }
+
+            float alpha;
+            if (simulation.IsRunning())
+            {
+                simulationSteps += simulation.TakeStepCount();
+                alpha = simulation.GetAlpha();
+            }
+            else
+            {
+                PROFILE_SCOPE("Update");
+                unsigned int steps = timestep.Advance(frameTime);
+                for (unsigned int i = 0; i < steps; i++)
+                    currentScene->OnUpdate(timestep.GetStep());
+                simulationSteps += steps;
+                alpha = timestep.GetAlpha();
+            }
+
+            {
+                PROFILE_SCOPE("Render");
+
+                /* Render here */
+                if (config.IsOffscreen() && width > 0 && height > 0)
+                {
+                    /* Allocated for the largest scale, lower scales only render to part of it. */
+                    int targetWidth = (int)std::ceil(width * resolution.GetMaxScale());
+                    int targetHeight = (int)std::ceil(height * resolution.GetMaxScale());
+                    if (!sceneTarget)
+                    {
+                        FramebufferSpec spec;
+                        spec.Width = targetWidth;
+                        spec.Height = targetHeight;
+                        spec.Samples = config.Samples;
+                        sceneTarget.reset(new Framebuffer(spec));
+                    }
+                    sceneTarget->Resize(targetWidth, targetHeight);
+                    sceneTarget->SetViewportSize(std::max(1, std::min(targetWidth, (int)(width * resolution.GetScale() + 0.5f))),
+                        std::max(1, std::min(targetHeight, (int)(height * resolution.GetScale() + 0.5f))));
+                    sceneTarget->Bind();
+
+                    resolution.BeginFrame();
+                    renderer.Clear();
+                    currentScene->OnRender(alpha);
+                    sceneTarget->Resolve();
+                    resolution.EndFrame();
+
+                    sceneTarget->BlitColor(0, 0, 0, width, height, GL_LINEAR);
+                }
+                else
+                {
+                    GLCall(glViewport(0, 0, width, height));
+                    renderer.Clear();
+                    currentScene->OnRender(alpha);
+                }
+            }
+
+            {
+                PROFILE_SCOPE("Capture");
+                capture.Update();
+
+                char name[64];
+                if (!config.CapturePath.empty() && width > 0 && height > 0)
+                {
+                    snprintf(name, sizeof(name), "/frame-%06u.tga", captureFrame++);
+                    capturePath.assign(config.CapturePath).append(name);
+                    capture.Capture(0, 0, 0, width, height, capturePath);
+                }
+
+                bool screenshotKey = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+                if (screenshotKey && !screenshotKeyDown && width > 0 && height > 0)
+                {
+                    FileSystem::MakeDirectories("screenshots");
+                    snprintf(name, sizeof(name), "screenshots/screenshot-%04u.tga", screenshotCount++);
+                    if (capture.Capture(0, 0, 0, width, height, name))
+                        std::cout << "Status: Saving " << name << std::endl;
+                }
+                screenshotKeyDown = screenshotKey;
+            }
+
+            Profiler::EndFrame();
+
+            /* Counted before the report, which allocates plenty, but only once per second. */
+            const unsigned long long allocations = AllocationCounter::GetStats().Allocations - frameStart.Allocations;
+            frameAllocations += allocations;
+            if (allocations > maxFrameAllocations)
+                maxFrameAllocations = allocations;
+            reportFrames++;
+
+            /* Once per second we print the stats of the scene. */
+            if (now - lastReport >= 1.0)
+            {
+                currentScene->OnReport(std::cout);
+                std::cout << "Simulation: " << simulationSteps << " steps" << (simulation.IsRunning() ? " on its own thread" : "") << std::endl;
+                simulationSteps = 0;
+
+                const StateCache::Stats& stateStats = StateCache::GetStats();
+                std::cout << "State changes: " << stateStats.Issued << " | Redundant (skipped): " << stateStats.Skipped << std::endl;
+
+                std::cout << "Heap allocations per frame: " << (double)frameAllocations / reportFrames << " (max " << maxFrameAllocations << ")"
+                    << " | Frame arena: " << frameArena.GetPeak() / 1024 << " KB peak";
+                if (frameArena.GetFailures())
+                    std::cout << ", " << frameArena.GetFailures() << " allocations did not fit";
+                std::cout << std::endl;
+                frameAllocations = maxFrameAllocations = 0;
+                reportFrames = 0;
+                frameArena.ResetPeak();
+
+                if (sceneTarget)
+                {
+                    std::cout << "Render target: " << sceneTarget->GetViewportWidth() << "x" << sceneTarget->GetViewportHeight()
+                        << " (scale " << resolution.GetScale() << ") | MSAA: " << sceneTarget->GetSamples() << "x";
+                    if (resolution.IsEnabled())
+                        std::cout << " | GPU " << resolution.GetGpuMilliseconds() << " ms of " << resolution.GetBudgetMilliseconds() << " ms budget";
+                    std::cout << std::endl;
+                }
+
+                const FrameCapture::Stats& captureStats = capture.GetStats();
+                if (captureStats.Captured)
+                {
+                    std::cout << "Capture: " << captureStats.Written << " of " << captureStats.Captured << " frames written | Dropped: "
+                        << captureStats.Dropped << " | Failed: " << captureStats.Failed << std::endl;
+                }
+
+                pacer.PrintSummary(std::cout);
+                Profiler::PrintSummary(std::cout);
+                GpuMemory::PrintSummary(std::cout);
+                lastReport = now;
+            }
+
+            /* In release builds GLCall does not check anything, so we drain the error queue once per frame instead. */
+            GLCheckFrameErrors("frame");
+
+            if (!config.LowLatency)
+                limiter.Wait();
+
+            /* Swap front and back buffers */
+            glfwSwapBuffers(window);
+            pacer.EndFrame(inputTime);
+
+            /* Poll for and process events */
+            if (!config.LowLatency)
+            {
+                glfwPollEvents();
+                inputTime = glfwGetTime();
+            }
+        }
+
+        /* The simulation thread may be inside the scene right now, it has to stop before the scene goes away. */
+        simulation.Stop();
+        HotReloader::Stop();
+        capture.Finish();
+
+        if (!tracePath.empty())
+        {
+            if (Profiler::StopTrace(tracePath))
+                std::cout << "Status: Wrote trace to " << tracePath << std::endl;
+            else
+                std::cout << "Error: could not write trace to " << tracePath << std::endl;
+        }
+        Profiler::Shutdown();
+    }
 
     glfwTerminate();
     return 0;
-}
\ No newline at end of file
+}
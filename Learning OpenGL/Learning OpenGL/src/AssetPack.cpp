@@ -0,0 +1,302 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "Texture.h"
+#include "FileSystem.h"
+
+AssetPack::AssetPack()
+    : m_Data(nullptr), m_Size(0), m_Entries(nullptr), m_EntryCount(0)
+{
+}
+
+bool AssetPack::Open(const std::string& filepath)
+{
+    if (!m_File.Open(filepath))
+    {
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Entries = nullptr;
+        m_EntryCount = 0;
+        return false;
+    }
+
+    m_Data = m_File.GetData();
+    m_Size = m_File.GetSize();
+    if (!Validate())
+    {
+        std::cout << "Asset pack: " << filepath << " is damaged or of another version, ignoring it" << std::endl;
+        m_File.Close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::Open(const void* data, size_t size)
+{
+    m_File.Close();
+    m_Data = (const unsigned char*)data;
+    m_Size = size;
+    return Validate();
+}
+
+bool AssetPack::Validate()
+{
+    m_Entries = nullptr;
+    m_EntryCount = 0;
+
+    const AssetPackHeader* header = (const AssetPackHeader*)m_Data;
+    if (!m_Data || m_Size < sizeof(AssetPackHeader) || header->Magic != Magic || header->Version != Version ||
+        header->FileSize != m_Size || header->EntryCount > (m_Size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry))
+    {
+        m_Data = nullptr;
+        m_Size = 0;
+        return false;
+    }
+
+    const AssetPackEntry* entries = (const AssetPackEntry*)(m_Data + sizeof(AssetPackHeader));
+    for (unsigned int i = 0; i < header->EntryCount; i++)
+    {
+        const AssetPackEntry& entry = entries[i];
+        const bool terminated = memchr(entry.Name, 0, sizeof(entry.Name)) != nullptr;
+        const bool sorted = i == 0 || strcmp(entries[i - 1].Name, entry.Name) < 0;
+        if (!terminated || !sorted || entry.Offset > m_Size || entry.Size > m_Size - entry.Offset || !IsValidEntry(entry))
+        {
+            m_Data = nullptr;
+            m_Size = 0;
+            return false;
+        }
+    }
+
+    m_Entries = entries;
+    m_EntryCount = header->EntryCount;
+    return true;
+}
+
+bool AssetPack::IsValidEntry(const AssetPackEntry& entry)
+{
+    switch (entry.Type)
+    {
+        case AssetType::Data:
+            return true;
+        case AssetType::Vertices:
+            return entry.Format > 0 && (uint64_t)entry.Count * entry.Format == entry.Size;
+        case AssetType::Indices:
+        {
+            if (entry.Format != GL_UNSIGNED_SHORT && entry.Format != GL_UNSIGNED_INT)
+                return false;
+            const uint64_t indexSize = entry.Format == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+            return (uint64_t)entry.Count * indexSize <= entry.Size;
+        }
+        case AssetType::Texture:
+        {
+            if (entry.Width == 0 || entry.Height == 0 || entry.Width > MaxTextureSize || entry.Height > MaxTextureSize)
+                return false;
+            if (entry.Count == 0 || entry.Count > Texture::GetMipLevelCount(entry.Width, entry.Height))
+                return false;
+
+            uint64_t size = 0;
+            for (unsigned int level = 0; level < entry.Count; level++)
+            {
+                int width = entry.Width >> level > 0 ? entry.Width >> level : 1;
+                int height = entry.Height >> level > 0 ? entry.Height >> level : 1;
+                size += Texture::GetLevelSize(entry.Format, width, height);
+            }
+            return size <= entry.Size;
+        }
+        default:
+            return false;
+    }
+}
+
+const AssetPackEntry* AssetPack::Find(const char* name) const
+{
+    /* The table is sorted by name, so this is a binary search on the mapped table itself. */
+    const AssetPackEntry* end = m_Entries + m_EntryCount;
+    const AssetPackEntry* entry = std::lower_bound(m_Entries, end, name,
+        [](const AssetPackEntry& entry, const char* name) { return strcmp(entry.Name, name) < 0; });
+    return entry != end && strcmp(entry->Name, name) == 0 ? entry : nullptr;
+}
+
+const AssetPackEntry* AssetPack::Find(const char* name, AssetType type) const
+{
+    const AssetPackEntry* entry = Find(name);
+    return entry && entry->Type == type ? entry : nullptr;
+}
+
+std::unique_ptr<VertexBuffer> AssetPack::CreateVertexBuffer(const char* name) const
+{
+    const AssetPackEntry* entry = Find(name, AssetType::Vertices);
+    if (!entry)
+        return nullptr;
+
+    return std::unique_ptr<VertexBuffer>(new VertexBuffer(GetData(*entry), (unsigned int)entry->Size));
+}
+
+std::unique_ptr<IndexBuffer> AssetPack::CreateIndexBuffer(const char* name) const
+{
+    const AssetPackEntry* entry = Find(name, AssetType::Indices);
+    if (!entry)
+        return nullptr;
+
+    /* The blob already has the index type the buffer should have, so neither constructor has to convert. */
+    /* Validate made sure it is one of the two and holds Count of them. */
+    if (entry->Format == GL_UNSIGNED_SHORT)
+        return std::unique_ptr<IndexBuffer>(new IndexBuffer((const unsigned short*)GetData(*entry), entry->Count));
+
+    std::unique_ptr<IndexBuffer> buffer(new IndexBuffer(entry->Count, GL_UNSIGNED_INT));
+    buffer->SetData((const unsigned int*)GetData(*entry), entry->Count);
+    return buffer;
+}
+
+std::unique_ptr<Texture> AssetPack::CreateTexture(const char* name) const
+{
+    const AssetPackEntry* entry = Find(name, AssetType::Texture);
+    if (!entry)
+        return nullptr;
+
+    /* SetLevel reads from a bound pixel unpack buffer instead of the pointer otherwise. */
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    std::unique_ptr<Texture> texture(new Texture(entry->Name));
+    texture->Allocate(entry->Width, entry->Height, entry->Format, entry->Count);
+
+    const unsigned char* data = (const unsigned char*)GetData(*entry);
+    size_t offset = 0;
+    for (unsigned int level = 0; level < entry->Count; level++)
+    {
+        int width = entry->Width >> level > 0 ? entry->Width >> level : 1;
+        int height = entry->Height >> level > 0 ? entry->Height >> level : 1;
+        unsigned int size = Texture::GetLevelSize(entry->Format, width, height);
+        ASSERT(offset + size <= entry->Size); // See IsValidEntry
+        texture->SetLevel(level, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data + offset, size);
+        offset += size;
+    }
+    texture->SetReady();
+    return texture;
+}
+
+AssetPackWriter::Blob& AssetPackWriter::Add(const char* name, AssetType type, const void* data, size_t size)
+{
+    ASSERT(strlen(name) < sizeof(AssetPackEntry::Name));
+
+    m_Blobs.emplace_back();
+    Blob& blob = m_Blobs.back();
+    memset(&blob.Entry, 0, sizeof(blob.Entry));
+    strncpy(blob.Entry.Name, name, sizeof(blob.Entry.Name) - 1);
+    blob.Entry.Type = type;
+    blob.Entry.Size = size;
+    blob.Data.assign((const unsigned char*)data, (const unsigned char*)data + size);
+    return blob;
+}
+
+void AssetPackWriter::AddData(const char* name, const void* data, size_t size)
+{
+    Add(name, AssetType::Data, data, size);
+}
+
+void AssetPackWriter::AddVertices(const char* name, const void* vertices, unsigned int vertexCount, unsigned int stride)
+{
+    Blob& blob = Add(name, AssetType::Vertices, vertices, (size_t)vertexCount * stride);
+    blob.Entry.Format = stride;
+    blob.Entry.Count = vertexCount;
+}
+
+void AssetPackWriter::AddIndices(const char* name, const unsigned int* indices, unsigned int count)
+{
+    if (IndexBuffer::FitsShort(indices, count))
+    {
+        std::vector<unsigned short> narrowed(indices, indices + count);
+        Blob& blob = Add(name, AssetType::Indices, narrowed.data(), count * sizeof(unsigned short));
+        blob.Entry.Format = GL_UNSIGNED_SHORT;
+        blob.Entry.Count = count;
+    }
+    else
+    {
+        Blob& blob = Add(name, AssetType::Indices, indices, count * sizeof(unsigned int));
+        blob.Entry.Format = GL_UNSIGNED_INT;
+        blob.Entry.Count = count;
+    }
+}
+
+void AssetPackWriter::AddTexture(const char* name, const void* data, int width, int height, unsigned int internalFormat, unsigned int levels)
+{
+    size_t size = 0;
+    for (unsigned int level = 0; level < levels; level++)
+    {
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        size += Texture::GetLevelSize(internalFormat, levelWidth, levelHeight);
+    }
+
+    Blob& blob = Add(name, AssetType::Texture, data, size);
+    blob.Entry.Format = internalFormat;
+    blob.Entry.Count = levels;
+    blob.Entry.Width = width;
+    blob.Entry.Height = height;
+}
+
+std::vector<unsigned char> AssetPackWriter::Serialize() const
+{
+    /* The reader looks entries up with a binary search, so the table goes out sorted by name. */
+    std::vector<const Blob*> blobs;
+    for (const Blob& blob : m_Blobs)
+        blobs.push_back(&blob);
+    std::sort(blobs.begin(), blobs.end(), [](const Blob* a, const Blob* b) { return strcmp(a->Entry.Name, b->Entry.Name) < 0; });
+
+    const size_t align = AssetPack::BlobAlignment;
+    size_t offset = sizeof(AssetPackHeader) + blobs.size() * sizeof(AssetPackEntry);
+    std::vector<AssetPackEntry> entries;
+    for (const Blob* blob : blobs)
+    {
+        ASSERT(entries.empty() || strcmp(entries.back().Name, blob->Entry.Name) != 0); // Names must be unique
+        offset = (offset + align - 1) / align * align;
+        entries.push_back(blob->Entry);
+        entries.back().Offset = offset;
+        offset += blob->Data.size();
+    }
+
+    std::vector<unsigned char> image(offset, 0);
+    AssetPackHeader header;
+    header.Magic = AssetPack::Magic;
+    header.Version = AssetPack::Version;
+    header.EntryCount = (uint32_t)entries.size();
+    header.Reserved = 0;
+    header.FileSize = image.size();
+    memcpy(image.data(), &header, sizeof(header));
+    if (!entries.empty())
+        memcpy(image.data() + sizeof(header), entries.data(), entries.size() * sizeof(AssetPackEntry));
+
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        if (!blobs[i]->Data.empty())
+            memcpy(image.data() + entries[i].Offset, blobs[i]->Data.data(), blobs[i]->Data.size());
+    }
+    return image;
+}
+
+bool AssetPackWriter::WriteFile(const std::string& filepath, const std::vector<unsigned char>& image)
+{
+    std::string directory = FileSystem::GetParentPath(filepath);
+    if (!directory.empty())
+        FileSystem::MakeDirectories(directory);
+
+    /* Written under a temporary name first, so a crash halfway never leaves a pack that looks complete. */
+    std::string temporary = filepath + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream || !stream.write((const char*)image.data(), image.size()))
+            return false;
+    }
+
+    std::remove(filepath.c_str());
+    return std::rename(temporary.c_str(), filepath.c_str()) == 0;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+class VertexBuffer;
+class IndexBuffer;
+class Texture;
+
+/* A pack file is a header, a table of entries sorted by name, and the blobs, each aligned to */
+/* BlobAlignment. Blobs are stored exactly the way OpenGL takes them (vertices in their final layout, */
+/* indices already narrowed to 16 bits where they fit, every mip level of a texture one after the */
+/* other), so loading is mapping the file and handing pointers to the GL. */
+/*                                                                    */
+/* Packs are written by the machine that reads them, so byte order and struct padding are not an issue. */
+struct AssetPackHeader
+{
+    uint32_t Magic;      // 'LOPK'
+    uint32_t Version;
+    uint32_t EntryCount; // The entry table follows the header
+    uint32_t Reserved;
+    uint64_t FileSize;   // Guards against truncated files
+};
+
+enum class AssetType : uint32_t
+{
+    Data = 0,     // Anything else the loader needs, e.g. mesh bounds
+    Vertices = 1, // Format = stride in bytes, Count = vertex count
+    Indices = 2,  // Format = GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, Count = index count
+    Texture = 3   // Format = internal format, Count = mip levels, Width and Height of level 0
+};
+
+struct AssetPackEntry
+{
+    char Name[48];   // Zero terminated
+    AssetType Type;
+    uint32_t Format;
+    uint32_t Count;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Reserved;
+    uint64_t Offset; // From the start of the file
+    uint64_t Size;
+};
+
+static_assert(sizeof(AssetPackHeader) == 24, "AssetPackHeader must stay tightly packed");
+static_assert(sizeof(AssetPackEntry) == 88, "AssetPackEntry must stay tightly packed");
+
+/* Reads a pack, either mapped from a file or from memory the caller keeps alive. Every entry is */
+/* validated once in Open: its blob lies inside the file, and its count, format and size agree with */
+/* each other for its type, so the Create functions never read past a blob. A pack failing any of it */
+/* is rejected as a whole, for the caller to rebuild. */
+class AssetPack
+{
+private:
+    MappedFile m_File;
+    const unsigned char* m_Data;
+    size_t m_Size;
+    const AssetPackEntry* m_Entries;
+    unsigned int m_EntryCount;
+
+public:
+    static const uint32_t Magic = 0x4b504f4c;
+    static const uint32_t Version = 1;
+    static const unsigned int BlobAlignment = 64;
+    static const uint32_t MaxTextureSize = 16384; // Width and height, anything larger no GL takes anyway
+
+    AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    /* Returns false, with the pack left empty, if the file is missing, truncated, damaged or of another version. */
+    bool Open(const std::string& filepath);
+    bool Open(const void* data, size_t size);
+
+    /* nullptr if the pack has no entry of that name. */
+    const AssetPackEntry* Find(const char* name) const;
+    inline const void* GetData(const AssetPackEntry& entry) const { return m_Data + entry.Offset; }
+
+    inline unsigned int GetEntryCount() const { return m_EntryCount; }
+    inline size_t GetSize() const { return m_Size; }
+    inline bool IsMapped() const { return m_File.IsOpen(); }
+
+    /* Create GL objects straight from the blobs, nullptr if there is no entry of that name and type. */
+    /* Vertex buffers need a VertexBufferLayout matching the stride, which the pack does not describe. */
+    std::unique_ptr<VertexBuffer> CreateVertexBuffer(const char* name) const;
+    std::unique_ptr<IndexBuffer> CreateIndexBuffer(const char* name) const;
+    std::unique_ptr<Texture> CreateTexture(const char* name) const;
+
+private:
+    bool Validate();
+    static bool IsValidEntry(const AssetPackEntry& entry);
+    const AssetPackEntry* Find(const char* name, AssetType type) const;
+};
+
+/* Collects blobs and lays them out as a pack. */
+class AssetPackWriter
+{
+private:
+    struct Blob
+    {
+        AssetPackEntry Entry;
+        std::vector<unsigned char> Data;
+    };
+
+    std::vector<Blob> m_Blobs;
+
+public:
+    void AddData(const char* name, const void* data, size_t size);
+    void AddVertices(const char* name, const void* vertices, unsigned int vertexCount, unsigned int stride);
+
+    /* Stored as 16 bit indices whenever they fit, like IndexBuffer does. */
+    void AddIndices(const char* name, const unsigned int* indices, unsigned int count);
+
+    /* data holds every level of the mip chain, level 0 first, each as Texture::GetLevelSize bytes of RGBA8 */
+    /* or of the compressed format. */
+    void AddTexture(const char* name, const void* data, int width, int height, unsigned int internalFormat, unsigned int levels);
+
+    /* The whole pack as it would be written to a file. */
+    std::vector<unsigned char> Serialize() const;
+
+    /* Writes the pack, creating the directories it goes in. Returns false if the file can't be written. */
+    bool Write(const std::string& filepath) const { return WriteFile(filepath, Serialize()); }
+
+    /* Same for a pack that is already serialized. */
+    static bool WriteFile(const std::string& filepath, const std::vector<unsigned char>& image);
+
+private:
+    Blob& Add(const char* name, AssetType type, const void* data, size_t size);
+};
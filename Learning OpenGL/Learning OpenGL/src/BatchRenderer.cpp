@@ -0,0 +1,291 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+#include "Profiler.h"
+
+BatchRenderer::BatchRenderer(Shader& shader, unsigned int maxQuads, unsigned int regionCount)
+    : m_Shader(shader), m_MaxQuads(maxQuads), m_Vertices(nullptr), m_QuadCount(0), m_TextureSlotCount(1),
+      m_Bindless(IsBindlessSupported()), m_WhiteHandle(0), m_HandleGeneration(1), m_StallBase(0)
+{
+    /* The attribute pointers always point at the start of the buffer, the region we are drawing */
+    /* from is selected with the base vertex of the draw call. */
+    m_VertexBuffer.reset(new StreamBuffer(GL_ARRAY_BUFFER, maxQuads * 4 * sizeof(QuadVertex), regionCount));
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2); // Position
+    layout.Push<float>(4); // Color
+    layout.Push<float>(2); // TexCoords
+    layout.Push<float>(1); // TexIndex
+    ASSERT(layout.GetStride() == sizeof(QuadVertex));
+
+    m_VertexArray.reset(new VertexArray());
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+    /* Every quad uses the same index pattern, so the index buffer is generated once and never touched again. */
+    std::vector<unsigned int> indices(maxQuads * 6);
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < indices.size(); i += 6)
+    {
+        indices[i + 0] = offset + 0;
+        indices[i + 1] = offset + 1;
+        indices[i + 2] = offset + 2;
+
+        indices[i + 3] = offset + 2;
+        indices[i + 4] = offset + 3;
+        indices[i + 5] = offset + 0;
+
+        offset += 4;
+    }
+    m_IndexBuffer.reset(new IndexBuffer(indices.data(), (unsigned int)indices.size())); // Captured by the bound VAO
+
+    m_VertexArray->Unbind();
+
+    GLCall(glGenTextures(1, &m_WhiteTexture));
+    StateCache::BindTexture(0, GL_TEXTURE_2D, m_WhiteTexture);
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    unsigned int white = 0xffffffff;
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white));
+    GpuMemory::Allocate(GpuMemory::Category::Textures, sizeof(white));
+    StateCache::BindTexture(0, GL_TEXTURE_2D, 0);
+
+    m_TextureSlots[0] = m_WhiteTexture;
+
+    if (m_Bindless)
+    {
+        GLCall(m_WhiteHandle = glGetTextureHandleARB(m_WhiteTexture));
+        GLCall(glMakeTextureHandleResidentARB(m_WhiteHandle));
+
+        m_Handles.reserve(MaxBindlessTextures);
+        m_HandleTable.assign(HandleTableSize, HandleSlot{ 0, 0, 0 });
+        m_Handles.push_back(m_WhiteHandle);
+        m_HandleBuffer.reset(new UniformBuffer(MaxBindlessTextures * sizeof(uint64_t), TextureHandleBindingPoint));
+        m_Shader.SetUniformBlockBinding("TextureHandles", TextureHandleBindingPoint);
+        m_MaxTextureSlots = MaxBindlessTextures;
+        return;
+    }
+
+    int maxUnits;
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+    m_MaxTextureSlots = (unsigned int)maxUnits < MaxTextureSlots ? (unsigned int)maxUnits : MaxTextureSlots;
+
+    /* Sampler i always reads from texture unit i. */
+    int samplers[MaxTextureSlots];
+    for (unsigned int i = 0; i < MaxTextureSlots; i++)
+        samplers[i] = i;
+
+    m_Shader.Bind();
+    m_Shader.SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+}
+
+BatchRenderer::~BatchRenderer()
+{
+    if (m_Vertices)
+        m_VertexBuffer->Unmap(0);
+
+    if (m_WhiteHandle)
+    {
+        GLCall(glMakeTextureHandleNonResidentARB(m_WhiteHandle));
+    }
+
+    StateCache::OnDeleteTexture(m_WhiteTexture);
+    GLCall(glDeleteTextures(1, &m_WhiteTexture));
+    GpuMemory::Free(GpuMemory::Category::Textures, sizeof(unsigned int));
+}
+
+void BatchRenderer::BeginBatch()
+{
+    m_QuadCount = 0;
+    m_TextureSlotCount = 1;
+
+    if (m_Bindless)
+    {
+        m_Handles.resize(1);
+        if (++m_HandleGeneration == 0)
+        {
+            /* Wrapped around after four billion batches, entries of generation 0 would look current. */
+            m_HandleTable.assign(HandleTableSize, HandleSlot{ 0, 0, 0 });
+            m_HandleGeneration = 1;
+        }
+    }
+}
+
+bool BatchRenderer::IsBindlessSupported()
+{
+    return Texture::IsBindlessSupported();
+}
+
+std::vector<std::string> BatchRenderer::GetShaderDefines()
+{
+    if (IsBindlessSupported())
+        return { "BINDLESS" };
+    return {};
+}
+
+void BatchRenderer::EndBatch()
+{
+    Flush();
+}
+
+void BatchRenderer::Flush()
+{
+    if (m_QuadCount == 0)
+        return;
+
+    PROFILE_SCOPE("BatchRenderer::Flush");
+
+    m_VertexBuffer->Unmap(m_QuadCount * 4 * sizeof(QuadVertex));
+    m_Vertices = nullptr;
+
+    if (m_Bindless)
+    {
+        /* The previous batch may still be reading the old handles, the driver takes care of that. */
+        m_HandleBuffer->SetData(m_Handles.data(), (unsigned int)(m_Handles.size() * sizeof(uint64_t)));
+        m_HandleBuffer->Bind();
+    }
+    else
+    {
+        for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+            StateCache::BindTexture(i, GL_TEXTURE_2D, m_TextureSlots[i]);
+    }
+
+    m_Shader.Bind();
+    m_VertexArray->Bind();
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6, m_IndexBuffer->GetType(), nullptr,
+        m_VertexBuffer->GetOffset() / sizeof(QuadVertex)));
+    m_VertexBuffer->Lock();
+
+    m_Stats.BatchCount++;
+    m_Stats.DrawCount++;
+    m_Stats.StallCount = m_VertexBuffer->GetStallCount() - m_StallBase;
+
+    BeginBatch();
+}
+
+float BatchRenderer::FindTextureSlot(unsigned int texture, uint64_t handle)
+{
+    if (m_Bindless)
+    {
+        unsigned int index = (texture * 2654435761u) & (HandleTableSize - 1);
+        while (m_HandleTable[index].Generation == m_HandleGeneration)
+        {
+            if (m_HandleTable[index].Texture == texture)
+                return (float)m_HandleTable[index].Slot;
+            index = (index + 1) & (HandleTableSize - 1);
+        }
+
+        if (m_Handles.size() == MaxBindlessTextures)
+        {
+            /* Starts a new batch, where every entry of the table is free again. */
+            Flush();
+            index = (texture * 2654435761u) & (HandleTableSize - 1);
+        }
+
+        if (!handle)
+        {
+            GLCall(handle = glGetTextureHandleARB(texture));
+            GLCall(GLboolean resident = glIsTextureHandleResidentARB(handle));
+            if (!resident)
+            {
+                GLCall(glMakeTextureHandleResidentARB(handle));
+            }
+        }
+
+        unsigned int slot = (unsigned int)m_Handles.size();
+        m_Handles.push_back(handle);
+        m_HandleTable[index] = HandleSlot{ texture, slot, m_HandleGeneration };
+        return (float)slot;
+    }
+
+    for (unsigned int i = 1; i < m_TextureSlotCount; i++)
+    {
+        if (m_TextureSlots[i] == texture)
+            return (float)i;
+    }
+
+    /* Every slot is taken, so everything recorded so far has to be drawn before we can use a new one. */
+    if (m_TextureSlotCount == m_MaxTextureSlots)
+        Flush();
+
+    m_TextureSlots[m_TextureSlotCount] = texture;
+    return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, const float color[4])
+{
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    PushQuad(x, y, width, height, color, 0.0f);
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, const Texture& texture, const float tint[4])
+{
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    /* Looking up the slot may flush, which is fine because it happens before we write the quad. */
+    float texIndex = FindTextureSlot(texture.GetRendererID(), m_Bindless ? texture.GetBindlessHandle() : 0);
+    PushQuad(x, y, width, height, tint, texIndex);
+}
+
+void BatchRenderer::DrawQuad(float x, float y, float width, float height, unsigned int texture, const float tint[4])
+{
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    float texIndex = FindTextureSlot(texture, 0);
+    PushQuad(x, y, width, height, tint, texIndex);
+}
+
+unsigned int BatchRenderer::AllocateQuads(unsigned int count, QuadVertex*& vertices)
+{
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    if (!m_Vertices)
+        m_Vertices = (QuadVertex*)m_VertexBuffer->Map();
+
+    unsigned int allocated = std::min(count, m_MaxQuads - m_QuadCount);
+    vertices = &m_Vertices[m_QuadCount * 4];
+    m_QuadCount += allocated;
+    m_Stats.QuadCount += allocated;
+    return allocated;
+}
+
+void BatchRenderer::PushQuad(float x, float y, float width, float height, const float color[4], float texIndex)
+{
+    static const float texCoords[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+    if (!m_Vertices)
+        m_Vertices = (QuadVertex*)m_VertexBuffer->Map();
+
+    /* The mapped memory may be write-combined, so we only ever write to it, in order. */
+    QuadVertex* vertex = &m_Vertices[m_QuadCount * 4];
+    for (int i = 0; i < 4; i++)
+    {
+        vertex[i].Position[0] = x + width * texCoords[i][0];
+        vertex[i].Position[1] = y + height * texCoords[i][1];
+        vertex[i].Color[0] = color[0];
+        vertex[i].Color[1] = color[1];
+        vertex[i].Color[2] = color[2];
+        vertex[i].Color[3] = color[3];
+        vertex[i].TexCoords[0] = texCoords[i][0];
+        vertex[i].TexCoords[1] = texCoords[i][1];
+        vertex[i].TexIndex = texIndex;
+    }
+
+    m_QuadCount++;
+    m_Stats.QuadCount++;
+}
+
+void BatchRenderer::ResetStats()
+{
+    m_Stats = Stats();
+    m_StallBase = m_VertexBuffer->GetStallCount();
+}
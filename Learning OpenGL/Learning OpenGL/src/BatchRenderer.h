@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "StreamBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+#include "IndexBuffer.h"
+#include "Texture.h"
+#include "UniformBuffer.h"
+
+/* Everything the batch shader needs to know about one corner of a quad. */
+struct QuadVertex
+{
+    float Position[2];
+    float Color[4];
+    float TexCoords[2];
+    float TexIndex;
+};
+
+/* The batch renderer collects many quads into one streaming vertex buffer and draws them with a single */
+/* glDrawElements. A batch is flushed when the vertex buffer is full, when all texture slots are taken, */
+/* or when EndBatch is called. Quads are written straight into the mapped region of the stream buffer, */
+/* so with persistent mapping there is no intermediate copy at all. */
+/*                                                                    */
+/* With GL_ARB_bindless_texture nothing is bound at all: each batch uploads the handles of its textures */
+/* into a uniform buffer and the shader samples through them, so a batch can use up to */
+/* MaxBindlessTextures textures instead of the 16 texture units. */
+class BatchRenderer
+{
+public:
+    struct Stats
+    {
+        unsigned int QuadCount = 0;  // Quads submitted through DrawQuad
+        unsigned int BatchCount = 0; // Batches flushed with at least one quad
+        unsigned int DrawCount = 0;  // glDrawElements calls issued
+        unsigned int StallCount = 0; // Times the CPU had to wait for the GPU to release a vertex region
+    };
+
+    static const unsigned int MaxTextureSlots = 16; // Must match the switch in res/shaders/Batch.shader
+    static const unsigned int MaxBindlessTextures = 1024; // Must match u_TextureHandles in res/shaders/Batch.shader
+    static const unsigned int TextureHandleBindingPoint = 1;
+
+private:
+    Shader& m_Shader;
+    unsigned int m_MaxQuads;
+
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<StreamBuffer> m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    QuadVertex* m_Vertices; // Mapped region of the current batch, null until the first quad is pushed
+    unsigned int m_QuadCount;
+
+    unsigned int m_WhiteTexture; // Untextured quads sample this 1x1 texture in slot 0
+    unsigned int m_TextureSlots[MaxTextureSlots];
+    unsigned int m_TextureSlotCount;
+    unsigned int m_MaxTextureSlots; // May be lower than MaxTextureSlots on old hardware
+
+    /* Bindless path only. Handle i of the batch is read by quads with TexIndex i, 0 is the white texture. */
+    bool m_Bindless;
+    uint64_t m_WhiteHandle;
+    std::vector<uint64_t> m_Handles;
+    /* Texture name to index in m_Handles, as an open addressing table twice as large as the most handles */
+    /* a batch can hold. Entries from an older batch have an older generation, so starting a batch doesn't */
+    /* have to clear anything, and unlike a std::unordered_map nothing is allocated per texture. */
+    struct HandleSlot
+    {
+        unsigned int Texture;
+        unsigned int Slot;
+        unsigned int Generation;
+    };
+    static const unsigned int HandleTableSize = MaxBindlessTextures * 2; // A power of two
+    std::vector<HandleSlot> m_HandleTable;
+    unsigned int m_HandleGeneration;
+    std::unique_ptr<UniformBuffer> m_HandleBuffer;
+
+    Stats m_Stats;
+    unsigned int m_StallBase; // Stall count of the vertex stream when the stats were last reset
+
+public:
+    /* shader must be a program built from res/shaders/Batch.shader with the defines of GetShaderDefines(). */
+    /* Each of the regionCount regions of the vertex stream holds one full batch of maxQuads quads. */
+    BatchRenderer(Shader& shader, unsigned int maxQuads = 10000, unsigned int regionCount = 3);
+    ~BatchRenderer();
+
+    BatchRenderer(const BatchRenderer&) = delete;
+    BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+    void BeginBatch();
+    void EndBatch();
+
+    void DrawQuad(float x, float y, float width, float height, const float color[4]);
+    void DrawQuad(float x, float y, float width, float height, const Texture& texture, const float tint[4]);
+
+    /* For raw texture names. On the bindless path their handles have to be looked up for every batch, */
+    /* so prefer the Texture overload. */
+    void DrawQuad(float x, float y, float width, float height, unsigned int texture, const float tint[4]);
+
+    /* Reserves up to count untextured quads in the current batch, flushing first if it is full, and points */
+    /* vertices at their 4 * n vertices, for code that writes vertices itself (see SpriteStore). Returns n, */
+    /* which is less than count when the batch runs out of room: write them, then ask for the rest. */
+    /* The vertices are TexIndex 0 and may be write-combined memory, write them in order and never read them. */
+    unsigned int AllocateQuads(unsigned int count, QuadVertex*& vertices);
+
+    inline unsigned int GetMaxQuads() const { return m_MaxQuads; }
+
+    inline const Stats& GetStats() const { return m_Stats; }
+    void ResetStats();
+
+    inline bool IsBindless() const { return m_Bindless; }
+
+    /* The batch renderer goes bindless whenever the extension is there. */
+    static bool IsBindlessSupported();
+
+    /* What res/shaders/Batch.shader has to be compiled with to match IsBindlessSupported. */
+    static std::vector<std::string> GetShaderDefines();
+
+private:
+    void Flush();
+    void PushQuad(float x, float y, float width, float height, const float color[4], float texIndex);
+    float FindTextureSlot(unsigned int texture, uint64_t handle);
+};
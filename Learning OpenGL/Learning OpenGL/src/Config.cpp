@@ -0,0 +1,153 @@
+#include "Config.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+static std::string Trim(const std::string& text)
+{
+    size_t begin = text.find_first_not_of(" \t\r\"");
+    if (begin == std::string::npos)
+        return "";
+    size_t end = text.find_last_not_of(" \t\r\"");
+    return text.substr(begin, end - begin + 1);
+}
+
+static bool ParseSwapInterval(const std::string& value, int& interval)
+{
+    if (value == "on" || value == "1")
+        interval = 1;
+    else if (value == "off" || value == "0")
+        interval = 0;
+    else if (value == "adaptive" || value == "-1")
+        interval = -1;
+    else
+        return false;
+    return true;
+}
+
+static bool ParseVersion(const std::string& value, int& major, int& minor)
+{
+    size_t dot = value.find('.');
+    if (dot == std::string::npos)
+        return false;
+
+    major = atoi(value.substr(0, dot).c_str());
+    minor = atoi(value.substr(dot + 1).c_str());
+    return major > 3 || (major == 3 && minor >= 3);
+}
+
+static bool ParseSwitch(const std::string& value, bool& enabled)
+{
+    if (value == "on" || value == "true" || value == "1")
+        enabled = true;
+    else if (value == "off" || value == "false" || value == "0")
+        enabled = false;
+    else
+        return false;
+    return true;
+}
+
+bool Config::Set(const std::string& key, const std::string& value)
+{
+    if (key == "width")
+        Width = atoi(value.c_str());
+    else if (key == "height")
+        Height = atoi(value.c_str());
+    else if (key == "title")
+        Title = value;
+    else if (key == "vsync")
+        return ParseSwapInterval(value, SwapInterval);
+    else if (key == "fps-limit")
+        FpsLimit = atof(value.c_str());
+    else if (key == "low-latency")
+        return ParseSwitch(value, LowLatency);
+    else if (key == "frames-in-flight")
+        FramesInFlight = (unsigned int)atoi(value.c_str());
+    else if (key == "simulation-rate")
+        SimulationRate = atof(value.c_str());
+    else if (key == "simulation-thread")
+        return ParseSwitch(value, SimulationThread);
+    else if (key == "gl-version")
+        return ParseVersion(value, GLMajor, GLMinor);
+    else if (key == "msaa")
+        Samples = (unsigned int)std::max(atoi(value.c_str()), 1);
+    else if (key == "render-scale")
+        RenderScale = (float)atof(value.c_str());
+    else if (key == "dynamic-resolution")
+        DynamicResolution = atof(value.c_str());
+    else if (key == "gpu-budget")
+        GpuBudget = (unsigned int)std::max(atoi(value.c_str()), 0);
+    else if (key == "hot-reload")
+        return ParseSwitch(value, HotReload);
+    else if (key == "scene")
+        Scene = value;
+    else if (key == "trace")
+        TracePath = value;
+    else if (key == "capture")
+        CapturePath = value;
+    else
+        return false;
+
+    return Width > 0 && Height > 0 && FpsLimit >= 0.0 && SimulationRate > 0.0
+        && RenderScale >= 0.25f && RenderScale <= 2.0f && DynamicResolution >= 0.0;
+}
+
+bool Config::LoadFile(const std::string& filepath)
+{
+    std::ifstream stream(filepath);
+    if (!stream)
+        return false;
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (getline(stream, line))
+    {
+        lineNumber++;
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos || !Set(Trim(line.substr(0, equals)), Trim(line.substr(equals + 1))))
+            std::cout << "Warning: " << filepath << "(" << lineNumber << "): ignoring '" << line << "'" << std::endl;
+    }
+    return true;
+}
+
+bool Config::ParseArgs(int argc, char** argv)
+{
+    /* The file goes first so that every other flag overrides it, wherever --config appears. */
+    std::string configPath = "config.ini";
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--config")
+            configPath = argv[i + 1];
+    }
+    LoadFile(configPath);
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0)
+        {
+            Scene = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cout << "Error: " << arg << " needs a value" << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (arg != "--config" && !Set(arg.substr(2), value))
+        {
+            std::cout << "Error: bad argument " << arg << " " << value << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
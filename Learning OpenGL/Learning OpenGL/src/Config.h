@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+
+/* Everything about how the application runs that we want to change per machine without recompiling. */
+/*                                                                    */
+/* Values come from a "key = value" file first (config.ini in the working directory, or --config path), */
+/* then the command line overrides them with the same keys as flags: */
+/* --width 1280 --height 720 --title "Learning OpenGL" --vsync off|on|adaptive --fps-limit 144 --low-latency on --frames-in-flight 1 */
+/* --simulation-rate 120 --simulation-thread on --gl-version 4.3 --hot-reload off --msaa 4 --render-scale 0.75 */
+/* --dynamic-resolution 12 --gpu-budget 512 --capture frames --trace file.json */
+/* Any other argument is the name of the scene to run. */
+struct Config
+{
+    int Width = 640;
+    int Height = 480;
+    std::string Title = "Hello World";
+
+    /* 1 waits for vblank, 0 presents immediately (tearing, lowest latency), */
+    /* -1 is adaptive vsync: waits for vblank unless the frame is late, then tears instead of dropping to half rate. */
+    int SwapInterval = 1;
+
+    /* 0 means uncapped. Mostly useful together with SwapInterval 0, to save power without vsync latency. */
+    double FpsLimit = 0.0;
+
+    /* Waits for the GPU before polling input instead of after presenting, so each frame is built from */
+    /* the freshest input we can get, see FramePacer. */
+    bool LowLatency = false;
+
+    /* How many frames the CPU may get ahead of the GPU. 0 leaves it to the driver, */
+    /* unless LowLatency is on, which uses 1. */
+    unsigned int FramesInFlight = 0;
+
+    /* Simulation steps per second, and whether they run on their own thread. */
+    double SimulationRate = 60.0;
+    bool SimulationThread = false;
+
+    /* The core profile version asked for first. If the driver can't create it we fall back to 3.3, */
+    /* which everything except the compute-based scenes works with. */
+    int GLMajor = 4;
+    int GLMinor = 3;
+
+    /* Samples per pixel, 1 is no MSAA. Anything but the defaults of these three renders the scene */
+    /* into an offscreen Framebuffer that is then scaled onto the window, see Framebuffer. */
+    unsigned int Samples = 1;
+
+    /* Render resolution relative to the window. With DynamicResolution it is the largest scale used. */
+    float RenderScale = 1.0f;
+
+    /* GPU milliseconds per frame the render scale is lowered to stay within, 0 keeps RenderScale fixed. */
+    /* See DynamicResolution. */
+    double DynamicResolution = 0.0;
+
+    inline bool IsOffscreen() const { return Samples > 1 || RenderScale != 1.0f || DynamicResolution > 0.0; }
+
+    /* Megabytes of GPU memory our own objects should stay within, 0 is no budget. Only reported, */
+    /* nothing is evicted to hold it yet, see GpuMemory. */
+    unsigned int GpuBudget = 0;
+
+    /* Watches res/ and reloads shaders and textures when they are saved, see HotReloader. */
+    bool HotReload = true;
+
+    std::string Scene = "batch";
+    std::string TracePath;
+
+    /* Directory every frame is written to as a TGA file, see FrameCapture. Empty captures nothing. */
+    std::string CapturePath;
+
+    /* A missing file is not an error, the defaults are used. Unknown keys and bad values are reported and skipped. */
+    bool LoadFile(const std::string& filepath);
+
+    /* Returns false on arguments it does not understand. --config is applied before any other argument. */
+    bool ParseArgs(int argc, char** argv);
+
+private:
+    bool Set(const std::string& key, const std::string& value);
+};
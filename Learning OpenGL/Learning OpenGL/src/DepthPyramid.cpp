@@ -0,0 +1,70 @@
+#include "DepthPyramid.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+#include "Shader.h"
+#include "Texture.h"
+
+#include <algorithm>
+
+/* Must match local_size_x and local_size_y in DepthPyramid.shader. */
+static const int GroupSize = 8;
+
+DepthPyramid::DepthPyramid(int width, int height)
+    : m_Width(width), m_Height(height), m_LevelCount(Texture::GetMipLevelCount(width, height))
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    StateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    GLCall(glTexStorage2D(GL_TEXTURE_2D, m_LevelCount, GL_R32F, width, height));
+    GpuMemory::Allocate(GpuMemory::Category::RenderTargets, GpuMemory::GetTextureSize(GL_R32F, width, height, m_LevelCount));
+
+    /* The culling shader picks the level itself and must never get a blend of depths. */
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+}
+
+DepthPyramid::~DepthPyramid()
+{
+    StateCache::OnDeleteTexture(m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::RenderTargets, GpuMemory::GetTextureSize(GL_R32F, m_Width, m_Height, m_LevelCount));
+}
+
+void DepthPyramid::Build(Shader& shader, unsigned int depthTexture)
+{
+    shader.Bind();
+    shader.SetUniform1i("u_Depth", DepthTextureUnit);
+    StateCache::BindTexture(DepthTextureUnit, GL_TEXTURE_2D, depthTexture);
+
+    int width = m_Width;
+    int height = m_Height;
+    for (unsigned int level = 0; level < m_LevelCount; level++)
+    {
+        /* Level 0 copies the depth texture, every other level reduces the one before it. */
+        /* Reading and writing two different levels of the same texture through images is fine, */
+        /* the barrier makes the writes of one dispatch visible to the image loads of the next. */
+        shader.SetUniform1i("u_FromDepth", level == 0 ? 1 : 0);
+        if (level > 0)
+        {
+            GLCall(glBindImageTexture(SourceImageUnit, m_RendererID, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F));
+            shader.SetUniform2i("u_SourceSize", width, height);
+            width = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+        }
+        GLCall(glBindImageTexture(DestinationImageUnit, m_RendererID, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F));
+
+        GLCall(glDispatchCompute((width + GroupSize - 1) / GroupSize, (height + GroupSize - 1) / GroupSize, 1));
+        GLCall(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+    }
+
+    /* Whoever samples the pyramid next reads it as a texture. */
+    GLCall(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT));
+}
+
+void DepthPyramid::Bind(unsigned int slot) const
+{
+    StateCache::BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
+}
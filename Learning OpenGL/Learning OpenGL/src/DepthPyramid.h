@@ -0,0 +1,42 @@
+#pragma once
+
+class Shader;
+
+/* A hierarchical-Z buffer: an R32F texture whose level 0 is a copy of a depth buffer and where every */
+/* texel of each following level is the farthest depth of the texels it covers in the level above. */
+/* Any screen rectangle is covered by at most 2x2 texels of some level, so four fetches tell whether */
+/* everything inside the rectangle is farther than an object's nearest point, see GpuCuller. */
+/*                                                                    */
+/* Built with res/shaders/DepthPyramid.shader, one dispatch per level, so it needs compute shaders. */
+class DepthPyramid
+{
+public:
+    /* Texture unit the pyramid is sampled from, and image units used while building it. */
+    static const unsigned int DepthTextureUnit = 0;
+    static const unsigned int SourceImageUnit = 1;
+    static const unsigned int DestinationImageUnit = 0;
+
+private:
+    unsigned int m_RendererID;
+    int m_Width;
+    int m_Height;
+    unsigned int m_LevelCount;
+
+public:
+    DepthPyramid(int width, int height);
+    ~DepthPyramid();
+
+    DepthPyramid(const DepthPyramid&) = delete;
+    DepthPyramid& operator=(const DepthPyramid&) = delete;
+
+    /* depthTexture must be a GL_TEXTURE_2D depth texture of the same size as the pyramid, */
+    /* with the draws that wrote it already submitted. */
+    void Build(Shader& shader, unsigned int depthTexture);
+
+    void Bind(unsigned int slot) const;
+
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline unsigned int GetLevelCount() const { return m_LevelCount; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+};
@@ -0,0 +1,97 @@
+#include "DynamicResolution.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float DynamicResolution::MinScale = 0.5f;
+const float DynamicResolution::MaxStep = 0.125f;
+const float DynamicResolution::Granularity = 1.0f / 32.0f;
+const double DynamicResolution::Headroom = 0.8;
+
+DynamicResolution::DynamicResolution(float maxScale, double budgetMilliseconds)
+    : m_Frame(0), m_Measuring(false), m_Scale(maxScale), m_MaxScale(maxScale), m_BudgetMilliseconds(budgetMilliseconds),
+      m_GpuMilliseconds(0.0), m_Skip(0)
+{
+    for (unsigned int i = 0; i < QueryCount; i++)
+    {
+        m_Queries[i] = 0;
+        m_Issued[i] = false;
+    }
+    if (IsEnabled())
+    {
+        GLCall(glGenQueries(QueryCount, m_Queries));
+    }
+}
+
+DynamicResolution::~DynamicResolution()
+{
+    if (IsEnabled())
+    {
+        GLCall(glDeleteQueries(QueryCount, m_Queries));
+    }
+}
+
+void DynamicResolution::BeginFrame()
+{
+    if (!IsEnabled())
+        return;
+
+    /* The query of this slot was issued QueryCount frames ago. If it still isn't done we would rather */
+    /* lose the sample than wait, reusing the query drops it. */
+    unsigned int slot = m_Frame % QueryCount;
+    if (m_Issued[slot])
+    {
+        GLint available = 0;
+        GLCall(glGetQueryObjectiv(m_Queries[slot], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (available)
+        {
+            GLuint64 nanoseconds = 0;
+            GLCall(glGetQueryObjectui64v(m_Queries[slot], GL_QUERY_RESULT, &nanoseconds));
+            OnSample(nanoseconds / 1000000.0);
+        }
+        m_Issued[slot] = false;
+    }
+
+    GLCall(glBeginQuery(GL_TIME_ELAPSED, m_Queries[slot]));
+    m_Measuring = true;
+}
+
+void DynamicResolution::EndFrame()
+{
+    if (!m_Measuring)
+        return;
+
+    GLCall(glEndQuery(GL_TIME_ELAPSED));
+    m_Issued[m_Frame % QueryCount] = true;
+    m_Measuring = false;
+    m_Frame++;
+}
+
+void DynamicResolution::OnSample(double milliseconds)
+{
+    if (m_Skip > 0)
+    {
+        m_Skip--;
+        return;
+    }
+
+    /* A little smoothing so a single slow frame doesn't change the scale. */
+    m_GpuMilliseconds = m_GpuMilliseconds == 0.0 ? milliseconds : m_GpuMilliseconds + (milliseconds - m_GpuMilliseconds) * 0.25;
+    if (m_GpuMilliseconds <= m_BudgetMilliseconds && m_GpuMilliseconds >= m_BudgetMilliseconds * Headroom)
+        return;
+    if (m_GpuMilliseconds < m_BudgetMilliseconds * Headroom && m_Scale >= m_MaxScale)
+        return;
+
+    double target = m_BudgetMilliseconds * (1.0 + Headroom) * 0.5;
+    float scale = m_Scale * (float)std::sqrt(target / std::max(m_GpuMilliseconds, 0.001));
+    scale = std::max(m_Scale - MaxStep, std::min(m_Scale + MaxStep, scale));
+    scale = std::round(scale / Granularity) * Granularity;
+    scale = std::max(std::min(MinScale, m_MaxScale), std::min(m_MaxScale, scale));
+    if (scale == m_Scale)
+        return;
+
+    m_Scale = scale;
+    m_GpuMilliseconds = 0.0;
+    m_Skip = QueryCount;
+}
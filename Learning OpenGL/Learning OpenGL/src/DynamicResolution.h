@@ -0,0 +1,51 @@
+#pragma once
+
+/* Picks the render scale that keeps the GPU time of a frame within a budget. */
+/*                                                                    */
+/* The GPU time of the scene comes from a GL_TIME_ELAPSED query around it. Queries are read a few frames */
+/* later and only once GL_QUERY_RESULT_AVAILABLE says so, like the Profiler's, so measuring never stalls. */
+/* Fill-rate bound work scales with the pixel count, the square of the scale, so when the smoothed time */
+/* leaves the band between Headroom * budget and the budget the scale jumps to where the time should land */
+/* in the middle of it, at most MaxStep at once. After a change the samples still in flight were taken at */
+/* the old scale, so they are skipped before the next decision. */
+/* With a budget of 0 the scale stays at the maximum and nothing is measured. */
+class DynamicResolution
+{
+private:
+    static const unsigned int QueryCount = 4;
+    static const float MinScale;
+    static const float MaxStep;     // Largest change of the scale in one decision
+    static const float Granularity; // The scale is a multiple of this, so it doesn't creep by tiny amounts
+    static const double Headroom;   // Below Headroom * budget the scale goes up again
+
+    unsigned int m_Queries[QueryCount];
+    bool m_Issued[QueryCount];
+    unsigned int m_Frame;
+    bool m_Measuring;
+
+    float m_Scale;
+    float m_MaxScale;
+    double m_BudgetMilliseconds;
+    double m_GpuMilliseconds; // Smoothed, 0 until the first sample after a change
+    unsigned int m_Skip;      // Samples left that were taken at the previous scale
+
+    void OnSample(double milliseconds);
+
+public:
+    /* maxScale is also the scale used when budgetMilliseconds is 0. */
+    DynamicResolution(float maxScale, double budgetMilliseconds);
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    /* Around the GPU work the scale is meant to control, once per frame. */
+    void BeginFrame();
+    void EndFrame();
+
+    inline bool IsEnabled() const { return m_BudgetMilliseconds > 0.0; }
+    inline float GetScale() const { return m_Scale; }
+    inline float GetMaxScale() const { return m_MaxScale; }
+    inline double GetBudgetMilliseconds() const { return m_BudgetMilliseconds; }
+    inline double GetGpuMilliseconds() const { return m_GpuMilliseconds; }
+};
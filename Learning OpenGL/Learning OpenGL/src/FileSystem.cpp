@@ -0,0 +1,59 @@
+#include "FileSystem.h"
+
+#include <vector>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+void FileSystem::MakeDirectories(const std::string& path)
+{
+    for (size_t i = 1; i <= path.size(); i++)
+    {
+        if (i == path.size() || path[i] == '/' || path[i] == '\\')
+        {
+            std::string directory = path.substr(0, i);
+#ifdef _WIN32
+            _mkdir(directory.c_str());
+#else
+            mkdir(directory.c_str(), 0755);
+#endif
+        }
+    }
+}
+
+std::string FileSystem::GetParentPath(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+std::string FileSystem::NormalizePath(const std::string& path)
+{
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (begin <= path.size())
+    {
+        size_t end = path.find_first_of("/\\", begin);
+        if (end == std::string::npos)
+            end = path.size();
+
+        std::string part = path.substr(begin, end - begin);
+        if (part == ".." && !parts.empty() && parts.back() != "..")
+            parts.pop_back();
+        else if (!part.empty() && part != ".")
+            parts.push_back(part);
+        begin = end + 1;
+    }
+
+    std::string normalized = !path.empty() && (path[0] == '/' || path[0] == '\\') ? "/" : "";
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        if (i > 0)
+            normalized += '/';
+        normalized += parts[i];
+    }
+    return normalized;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+/* The few file system operations the caches need that the standard library (before C++17) doesn't have. */
+class FileSystem
+{
+public:
+    /* Creates every directory of path in turn, ignoring the ones that already exist. */
+    static void MakeDirectories(const std::string& path);
+
+    /* Everything before the last slash, or an empty string for a bare file name. */
+    static std::string GetParentPath(const std::string& path);
+
+    /* Forward slashes only, with "." and "dir/.." removed, so two spellings of a path compare equal. */
+    static std::string NormalizePath(const std::string& path);
+};
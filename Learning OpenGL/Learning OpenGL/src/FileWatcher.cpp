@@ -0,0 +1,223 @@
+#include "FileWatcher.h"
+
+#include "FileSystem.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+const int FileWatcher::QuietMilliseconds;
+
+void FileWatcher::OnChanged(const std::string& relativePath)
+{
+    std::string path = FileSystem::NormalizePath(m_Directory + "/" + relativePath);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Changed[path] = Clock::now();
+}
+
+void FileWatcher::Poll(std::vector<std::string>& changed)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Changed.empty())
+        return;
+
+    const Clock::time_point quietSince = Clock::now() - std::chrono::milliseconds(QuietMilliseconds);
+    for (auto it = m_Changed.begin(); it != m_Changed.end();)
+    {
+        if (it->second <= quietSince)
+        {
+            changed.push_back(it->first);
+            it = m_Changed.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+#ifdef _WIN32
+
+FileWatcher::FileWatcher(const std::string& directory)
+    : m_Directory(FileSystem::NormalizePath(directory)), m_Running(false), m_DirectoryHandle(INVALID_HANDLE_VALUE), m_StopEvent(nullptr)
+{
+    /* FILE_FLAG_BACKUP_SEMANTICS is what lets CreateFile open a directory. */
+    m_DirectoryHandle = CreateFileA(m_Directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_DirectoryHandle == INVALID_HANDLE_VALUE)
+        return;
+
+    m_StopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    m_Running = true;
+    m_Thread = std::thread(&FileWatcher::WatcherMain, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_Running)
+    {
+        m_Running = false;
+        SetEvent(m_StopEvent);
+        m_Thread.join();
+    }
+
+    if (m_StopEvent)
+        CloseHandle(m_StopEvent);
+    if (m_DirectoryHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_DirectoryHandle);
+}
+
+void FileWatcher::WatcherMain()
+{
+    /* The notifications are DWORD aligned records, written into the buffer while the read is pending. */
+    std::vector<DWORD> buffer(16 * 1024);
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+    while (m_Running)
+    {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(m_DirectoryHandle, buffer.data(), (DWORD)(buffer.size() * sizeof(DWORD)), TRUE, filter, nullptr, &overlapped, nullptr))
+            break;
+
+        HANDLE events[2] = { overlapped.hEvent, m_StopEvent };
+        if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+        {
+            CancelIo(m_DirectoryHandle);
+            GetOverlappedResult(m_DirectoryHandle, &overlapped, nullptr, TRUE);
+            break;
+        }
+
+        /* 0 bytes means the buffer overflowed and the changes are lost, nothing we can do but wait for the next ones. */
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytes, FALSE) || bytes == 0)
+            continue;
+
+        const unsigned char* record = (const unsigned char*)buffer.data();
+        while (true)
+        {
+            const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)record;
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+            {
+                const int length = (int)(info->FileNameLength / sizeof(WCHAR));
+                const int size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, nullptr, 0, nullptr, nullptr);
+                std::string name(size, '\0');
+                WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, &name[0], size, nullptr, nullptr);
+                OnChanged(name);
+            }
+
+            if (info->NextEntryOffset == 0)
+                break;
+            record += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::string& directory)
+    : m_Directory(FileSystem::NormalizePath(directory)), m_Running(false), m_Inotify(-1)
+{
+    m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_Inotify < 0)
+        return;
+
+    /* inotify is not recursive, every directory of the tree needs a watch of its own. */
+    AddWatches("");
+    if (m_Watches.empty())
+        return;
+
+    m_Running = true;
+    m_Thread = std::thread(&FileWatcher::WatcherMain, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_Running)
+    {
+        m_Running = false;
+        m_Thread.join();
+    }
+
+    if (m_Inotify >= 0)
+        close(m_Inotify);
+}
+
+void FileWatcher::AddWatches(const std::string& relativeDirectory)
+{
+    const std::string path = relativeDirectory.empty() ? m_Directory : m_Directory + "/" + relativeDirectory;
+    const int watch = inotify_add_watch(m_Inotify, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch < 0)
+        return;
+    m_Watches[watch] = relativeDirectory;
+
+    DIR* directory = opendir(path.c_str());
+    if (!directory)
+        return;
+
+    while (dirent* entry = readdir(directory))
+    {
+        const std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+
+        const std::string child = relativeDirectory.empty() ? name : relativeDirectory + "/" + name;
+        struct stat status;
+        if (stat((m_Directory + "/" + child).c_str(), &status) == 0 && S_ISDIR(status.st_mode))
+            AddWatches(child);
+    }
+    closedir(directory);
+}
+
+void FileWatcher::WatcherMain()
+{
+    /* inotify_event records are variable sized and must be read into suitably aligned memory. */
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (m_Running)
+    {
+        /* Wakes up regularly to notice the destructor asking us to stop. */
+        pollfd descriptor = { m_Inotify, POLLIN, 0 };
+        if (poll(&descriptor, 1, 100) <= 0)
+            continue;
+
+        const ssize_t bytes = read(m_Inotify, buffer, sizeof(buffer));
+        if (bytes <= 0)
+            continue;
+
+        for (ssize_t offset = 0; offset < bytes;)
+        {
+            const inotify_event* event = (const inotify_event*)(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            auto watch = m_Watches.find(event->wd);
+            if (watch == m_Watches.end() || event->len == 0)
+                continue;
+
+            const std::string name = watch->second.empty() ? event->name : watch->second + "/" + event->name;
+            if (event->mask & IN_ISDIR)
+            {
+                /* A new directory: watch it too. Files saved into it before the watch was added are missed. */
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    AddWatches(name);
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                OnChanged(name);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Watches a directory tree from a thread of its own and reports the files that changed in it, */
+/* through ReadDirectoryChangesW on Windows and inotify on Linux. */
+/*                                                                    */
+/* Editors save in several steps (truncate and write, or write a temporary file and rename it over the */
+/* original), so a file is only reported once it has been quiet for QuietMilliseconds, and a burst of */
+/* changes to the same file is reported once. Paths are reported normalized, see FileSystem::NormalizePath, */
+/* and start with the watched directory, e.g. "res/shaders/Basic.shader". */
+class FileWatcher
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::string m_Directory;
+    std::thread m_Thread;
+    std::atomic<bool> m_Running;
+
+    std::mutex m_Mutex;
+    std::unordered_map<std::string, Clock::time_point> m_Changed; // Path, last change
+
+#ifdef _WIN32
+    void* m_DirectoryHandle; // HANDLE
+    void* m_StopEvent;       // HANDLE
+#else
+    int m_Inotify;
+    std::unordered_map<int, std::string> m_Watches; // Watch descriptor, directory relative to m_Directory, watcher thread only
+#endif
+
+public:
+    static const int QuietMilliseconds = 100;
+
+    /* Starts watching right away. IsWatching is false if the directory can't be watched. */
+    explicit FileWatcher(const std::string& directory);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    inline bool IsWatching() const { return m_Running; }
+    inline const std::string& GetDirectory() const { return m_Directory; }
+
+    /* Appends every file that changed and has been quiet since, and forgets about them. */
+    /* Doesn't allocate when nothing changed, so it can be called every frame. */
+    void Poll(std::vector<std::string>& changed);
+
+private:
+    void WatcherMain();
+    void OnChanged(const std::string& relativePath);
+
+#ifndef _WIN32
+    void AddWatches(const std::string& relativeDirectory);
+#endif
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+/* Turns variable frame times into a whole number of fixed simulation steps. */
+/*                                                                    */
+/* Every frame adds its duration to an accumulator, and one step is run for every full step it holds. */
+/* What is left over, as a fraction of a step, is how far rendering is between the last two simulated */
+/* states, so the renderer can interpolate and motion stays smooth when the rates don't match. */
+class FixedTimestep
+{
+private:
+    double m_Step;
+    double m_Accumulator;
+    unsigned int m_MaxSteps;
+
+public:
+    /* maxSteps bounds the work of a single frame. When a frame took so long that more steps are due, */
+    /* the rest is dropped: the simulation slows down instead of falling further behind every frame. */
+    FixedTimestep(double rate = 60.0, unsigned int maxSteps = 8)
+        : m_Step(1.0 / rate), m_Accumulator(0.0), m_MaxSteps(maxSteps) {}
+
+    /* Returns the number of steps to run for a frame that took frameTime seconds. */
+    unsigned int Advance(double frameTime)
+    {
+        m_Accumulator += frameTime;
+        unsigned int steps = (unsigned int)(m_Accumulator / m_Step);
+        if (steps > m_MaxSteps)
+        {
+            steps = m_MaxSteps;
+            m_Accumulator = 0.0;
+        }
+        else
+        {
+            m_Accumulator -= steps * m_Step;
+        }
+        return steps;
+    }
+
+    inline float GetStep() const { return (float)m_Step; }
+    inline float GetAlpha() const { return (float)(m_Accumulator / m_Step); }
+};
@@ -0,0 +1,243 @@
+#include "FrameCapture.h"
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+const unsigned int FrameCapture::MaxSlots;
+
+FrameCapture::FrameCapture(unsigned int slots)
+    : m_SlotCount(std::max(1u, std::min(slots, MaxSlots))), m_Oldest(0), m_Pending(0),
+      m_Writing(false), m_Stop(false), m_Written(0), m_Failed(0)
+{
+    for (unsigned int i = 0; i < m_SlotCount; i++)
+    {
+        GLCall(glGenBuffers(1, &m_Slots[i].Buffer));
+        GpuMemory::Allocate(GpuMemory::Category::PixelBuffers, 0);
+    }
+
+    m_Writer = std::thread(&FrameCapture::WriterMain, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    Finish();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkReady.notify_all();
+    m_Writer.join();
+
+    for (Job* job : m_Jobs)
+        delete job;
+
+    for (unsigned int i = 0; i < m_SlotCount; i++)
+    {
+        StateCache::OnDeleteBuffer(m_Slots[i].Buffer);
+        GLCall(glDeleteBuffers(1, &m_Slots[i].Buffer));
+        GpuMemory::Free(GpuMemory::Category::PixelBuffers, m_Slots[i].Size);
+    }
+}
+
+bool FrameCapture::Capture(unsigned int framebuffer, int x, int y, int width, int height, const std::string& path)
+{
+    if (m_Pending == m_SlotCount)
+    {
+        m_Stats.Dropped++;
+        return false;
+    }
+
+    Slot& slot = m_Slots[(m_Oldest + m_Pending) % m_SlotCount];
+    const unsigned int size = (unsigned int)(width * height * 4);
+
+    StateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    if (size > slot.Size)
+    {
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+        GpuMemory::Resize(GpuMemory::Category::PixelBuffers, slot.Size, size);
+        slot.Size = size;
+    }
+
+    /* With a pack buffer bound the pointer is an offset into it, and the call only queues the copy. */
+    /* BGRA rows of 4 byte pixels are always 4 byte aligned, and are what the GPU stores natively. */
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer));
+    GLCall(glReadPixels(x, y, width, height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    /* Anything else reading pixels after us expects client memory. */
+    StateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.Width = width;
+    slot.Height = height;
+    slot.Path.assign(path); // Reuses the capacity, continuous capture doesn't allocate here
+    m_Pending++;
+    m_Stats.Captured++;
+    return true;
+}
+
+bool FrameCapture::Retire()
+{
+    Job* job = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Free.empty())
+        {
+            job = m_Free.back();
+            m_Free.pop_back();
+        }
+    }
+
+    /* One more job than slots lets the writer work on one while every slot is in flight. */
+    if (!job)
+    {
+        if (m_Jobs.size() > m_SlotCount)
+            return false;
+        job = new Job();
+        m_Jobs.push_back(job);
+    }
+
+    Slot& slot = m_Slots[m_Oldest];
+    const unsigned int size = (unsigned int)(slot.Width * slot.Height * 4);
+
+    GLCall(glDeleteSync(slot.Fence));
+    slot.Fence = nullptr;
+
+    /* The fence has signaled, so mapping doesn't wait. The copy is the only cost left on this thread, */
+    /* the buffer has to be unmapped here before the slot can be used again. */
+    job->Pixels.resize(size);
+    StateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    const void* pixels;
+    GLCall(pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (pixels)
+    {
+        memcpy(job->Pixels.data(), pixels, size);
+        GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    StateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_Oldest = (m_Oldest + 1) % m_SlotCount;
+    m_Pending--;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (pixels)
+        {
+            job->Width = slot.Width;
+            job->Height = slot.Height;
+            job->Path.assign(slot.Path);
+            m_Queued.push_back(job);
+        }
+        else
+        {
+            m_Failed++;
+            m_Free.push_back(job);
+        }
+    }
+    m_WorkReady.notify_one();
+    return true;
+}
+
+void FrameCapture::Update()
+{
+    while (m_Pending > 0)
+    {
+        GLenum result;
+        GLCall(result = glClientWaitSync(m_Slots[m_Oldest].Fence, 0, 0));
+        if (result == GL_TIMEOUT_EXPIRED || !Retire())
+            return;
+    }
+}
+
+void FrameCapture::Finish()
+{
+    while (m_Pending > 0)
+    {
+        /* The flush bit makes sure the fence actually gets to the GPU, otherwise waiting on it could hang. */
+        GLenum result;
+        GLCall(result = glClientWaitSync(m_Slots[m_Oldest].Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull));
+        if (result == GL_TIMEOUT_EXPIRED)
+            continue;
+
+        if (!Retire())
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkDone.wait(lock, [this] { return !m_Free.empty(); });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [this] { return m_Queued.empty() && !m_Writing; });
+}
+
+const FrameCapture::Stats& FrameCapture::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Written = m_Written;
+    m_Stats.Failed = m_Failed;
+    return m_Stats;
+}
+
+void FrameCapture::WriterMain()
+{
+    while (true)
+    {
+        Job* job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkReady.wait(lock, [this] { return m_Stop || !m_Queued.empty(); });
+            if (m_Queued.empty())
+                return;
+
+            job = m_Queued.front();
+            m_Queued.pop_front();
+            m_Writing = true;
+        }
+
+        unsigned char* pixels = job->Pixels.data();
+        for (size_t i = 3; i < job->Pixels.size(); i += 4)
+            pixels[i] = 255;
+        bool written = WriteTGA(job->Path, job->Width, job->Height, pixels);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (written)
+                m_Written++;
+            else
+                m_Failed++;
+            m_Free.push_back(job);
+            m_Writing = false;
+        }
+        m_WorkDone.notify_all();
+    }
+}
+
+bool FrameCapture::WriteTGA(const std::string& filepath, int width, int height, const unsigned char* bgra)
+{
+    if (width <= 0 || height <= 0 || width > 0xffff || height > 0xffff)
+        return false;
+
+    /* Uncompressed true color, origin bottom left, 8 bits of alpha. */
+    unsigned char header[18] = {};
+    header[2] = 2;
+    header[12] = (unsigned char)(width & 0xff);
+    header[13] = (unsigned char)(width >> 8);
+    header[14] = (unsigned char)(height & 0xff);
+    header[15] = (unsigned char)(height >> 8);
+    header[16] = 32;
+    header[17] = 8;
+
+    /* stdio rather than a stream, which would allocate its buffer with operator new for every file */
+    /* and show up in the heap allocation counts of continuous capture. */
+    FILE* file = fopen(filepath.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const size_t size = (size_t)width * height * 4;
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) && fwrite(bgra, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
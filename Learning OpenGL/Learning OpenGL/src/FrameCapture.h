@@ -0,0 +1,99 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Reads frames back from the GPU and writes them as TGA files without ever stalling the render loop. */
+/*                                                                    */
+/* Capture only records a glReadPixels into one of a ring of pixel pack buffers, followed by a fence, so */
+/* the copy happens on the GPU later and the call returns straight away. Update, once per frame, checks */
+/* the oldest fences without waiting. A buffer whose fence has signaled is mapped, copied into a job and */
+/* handed to the writer thread, which encodes and writes the file. If every buffer is still in flight, or */
+/* the writer is that far behind, the frame is dropped and counted instead of waited for, so continuous */
+/* capture costs the copy out of the mapped buffer and nothing else. Jobs and their pixels are reused, */
+/* once warmed up capturing doesn't allocate. */
+class FrameCapture
+{
+public:
+    struct Stats
+    {
+        unsigned int Captured = 0; // Read backs issued
+        unsigned int Written = 0;  // Files written by the writer thread
+        unsigned int Dropped = 0;  // Frames skipped because every buffer was busy
+        unsigned int Failed = 0;   // Files that couldn't be written
+    };
+
+    static const unsigned int MaxSlots = 8;
+
+private:
+    struct Slot
+    {
+        unsigned int Buffer = 0;
+        unsigned int Size = 0; // Allocated bytes, the buffer only grows
+        GLsync Fence = nullptr;
+        int Width = 0;
+        int Height = 0;
+        std::string Path;
+    };
+
+    struct Job
+    {
+        std::vector<unsigned char> Pixels; // BGRA, bottom row first
+        int Width = 0;
+        int Height = 0;
+        std::string Path;
+    };
+
+    Slot m_Slots[MaxSlots];
+    unsigned int m_SlotCount;
+    unsigned int m_Oldest;
+    unsigned int m_Pending;
+
+    std::thread m_Writer;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+    std::deque<Job*> m_Queued; // Waiting for the writer
+    std::vector<Job*> m_Free;  // Written, ready for reuse
+    std::vector<Job*> m_Jobs;  // Every job, owned here
+    bool m_Writing;            // The writer is busy with a job it took off m_Queued
+    bool m_Stop;
+
+    Stats m_Stats;
+    unsigned int m_Written; // Counted by the writer, under m_Mutex
+    unsigned int m_Failed;
+
+    void WriterMain();
+    /* Maps the oldest slot and queues it for the writer. Returns false if no job is free. */
+    bool Retire();
+
+public:
+    /* slots is how many frames may be in flight at once, 3 covers the usual GPU latency. */
+    explicit FrameCapture(unsigned int slots = 3);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /* Reads the rectangle of the color buffer of framebuffer (0 is the window's back buffer) into path. */
+    /* framebuffer is left bound as GL_READ_FRAMEBUFFER. Returns false if the frame had to be dropped. */
+    bool Capture(unsigned int framebuffer, int x, int y, int width, int height, const std::string& path);
+
+    /* Hands finished read backs to the writer. Never blocks, call once per frame. */
+    void Update();
+
+    /* Waits for every capture to be read back and written, e.g. before exiting. */
+    void Finish();
+
+    inline unsigned int GetPendingCount() const { return m_Pending; }
+    const Stats& GetStats();
+
+    /* 32 bit uncompressed TGA with the bottom row first, what glReadPixels returns with GL_BGRA. */
+    /* Captures are made opaque before they are written, the window's alpha channel rarely means anything. */
+    static bool WriteTGA(const std::string& filepath, int width, int height, const unsigned char* bgra);
+};
@@ -0,0 +1,67 @@
+#include "FrameLimiter.h"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <thread>
+
+FrameLimiter::FrameLimiter(double fps)
+    : m_Period(0), m_Deadline(Clock::now()), m_SleepOvershoot(0.002),
+      m_SleptMilliseconds(0.0), m_SpunMilliseconds(0.0)
+{
+    SetTargetRate(fps);
+}
+
+void FrameLimiter::SetTargetRate(double fps)
+{
+    m_Period = fps > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+        : Clock::duration(0);
+    m_Deadline = Clock::now() + m_Period;
+}
+
+void FrameLimiter::Wait()
+{
+    m_SleptMilliseconds = m_SpunMilliseconds = 0.0;
+    if (!IsEnabled())
+        return;
+
+    Clock::time_point start = Clock::now();
+
+    /* More than a whole period late (a hitch, the window was dragged...): start over from now */
+    /* rather than rushing out frames to catch up. */
+    if (start - m_Deadline > m_Period)
+        m_Deadline = start;
+
+    /* Sleep while we are sure to wake up before the deadline. */
+    Clock::time_point now = start;
+    while (std::chrono::duration<double>(m_Deadline - now).count() > m_SleepOvershoot + 0.001)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Clock::time_point woke = Clock::now();
+
+        double overshoot = std::chrono::duration<double>(woke - now).count() - 0.001;
+        m_SleepOvershoot = std::max(overshoot, m_SleepOvershoot * 0.99);
+        now = woke;
+    }
+    Clock::time_point slept = now;
+
+    /* Spin the rest, yielding so another thread that is ready can have the core. */
+    while (now < m_Deadline)
+    {
+        std::this_thread::yield();
+        now = Clock::now();
+    }
+
+    m_SleptMilliseconds = std::chrono::duration<double, std::milli>(slept - start).count();
+    m_SpunMilliseconds = std::chrono::duration<double, std::milli>(now - slept).count();
+    m_Deadline += m_Period;
+}
+
+int FrameLimiter::ApplySwapInterval(int interval)
+{
+    if (interval < 0 && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        interval = 1;
+
+    glfwSwapInterval(interval);
+    return interval;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+
+/* Caps the frame rate on the CPU side, for when vsync is off or the display is faster than we need. */
+/*                                                                    */
+/* Sleeping alone is too coarse: the OS may wake us up a millisecond or more late (15.6 ms on Windows */
+/* unless the timer resolution was raised). Spinning alone burns a core. So we sleep in small steps */
+/* while the deadline is further away than the worst oversleep seen so far, and spin the rest. */
+/* Deadlines advance by exactly one period, so an early or late frame does not shift the ones after it. */
+class FrameLimiter
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::duration m_Period;
+    Clock::time_point m_Deadline;
+
+    /* Longest time a 1 ms sleep overshot by, decayed slowly so one hiccup does not force spinning forever. */
+    double m_SleepOvershoot;
+
+    double m_SleptMilliseconds;
+    double m_SpunMilliseconds;
+
+public:
+    /* fps <= 0 disables the limiter. */
+    explicit FrameLimiter(double fps = 0.0);
+
+    void SetTargetRate(double fps);
+    inline bool IsEnabled() const { return m_Period.count() > 0; }
+
+    /* Call once per frame, right before presenting. */
+    void Wait();
+
+    /* Time the last Wait spent sleeping and spinning. */
+    inline double GetSleptMilliseconds() const { return m_SleptMilliseconds; }
+    inline double GetSpunMilliseconds() const { return m_SpunMilliseconds; }
+
+    /* Sets the swap interval of the current context. -1 (adaptive vsync) needs */
+    /* WGL_EXT_swap_control_tear / GLX_EXT_swap_control_tear, without it we fall back to 1. */
+    /* Returns the interval actually used. */
+    static int ApplySwapInterval(int interval);
+};
@@ -0,0 +1,108 @@
+#include "FramePacer.h"
+#include "Renderer.h"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+
+const unsigned int FramePacer::MaxTrackedFrames;
+
+FramePacer::FramePacer(unsigned int maxFramesInFlight)
+    : m_Oldest(0), m_Pending(0), m_MaxFramesInFlight(std::min(maxFramesInFlight, MaxTrackedFrames)),
+      m_LatencySum(0.0), m_LatencyMax(0.0), m_LatencyCount(0), m_WaitSum(0.0)
+{
+    for (Frame& frame : m_Frames)
+        frame = { nullptr, 0.0 };
+}
+
+FramePacer::~FramePacer()
+{
+    for (Frame& frame : m_Frames)
+    {
+        if (frame.Fence)
+        {
+            GLCall(glDeleteSync(frame.Fence));
+        }
+    }
+}
+
+bool FramePacer::Retire(bool wait)
+{
+    if (m_Pending == 0)
+        return false;
+
+    Frame& frame = m_Frames[m_Oldest];
+
+    /* The flush bit makes sure the fence actually gets to the GPU, otherwise waiting on it could hang. */
+    GLenum result;
+    GLCall(result = glClientWaitSync(frame.Fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0));
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    /* A wait failed means the context is gone, we just drop the frame from the statistics. */
+    if (result != GL_WAIT_FAILED)
+    {
+        double latency = glfwGetTime() - frame.InputTime;
+        m_LatencySum += latency;
+        m_LatencyMax = std::max(m_LatencyMax, latency);
+        m_LatencyCount++;
+    }
+
+    GLCall(glDeleteSync(frame.Fence));
+    frame.Fence = nullptr;
+    m_Oldest = (m_Oldest + 1) % MaxTrackedFrames;
+    m_Pending--;
+    return true;
+}
+
+void FramePacer::WaitForFrame()
+{
+    while (Retire(false))
+        ;
+
+    if (m_MaxFramesInFlight == 0)
+        return;
+
+    double start = glfwGetTime();
+    while (m_Pending >= m_MaxFramesInFlight && Retire(true))
+        ;
+    m_WaitSum += glfwGetTime() - start;
+}
+
+void FramePacer::EndFrame(double inputTime)
+{
+    /* Only when not limiting frames can we run out of slots. We would rather lose a measurement than stall. */
+    if (m_Pending == MaxTrackedFrames)
+    {
+        Frame& oldest = m_Frames[m_Oldest];
+        GLCall(glDeleteSync(oldest.Fence));
+        oldest.Fence = nullptr;
+        m_Oldest = (m_Oldest + 1) % MaxTrackedFrames;
+        m_Pending--;
+    }
+
+    Frame& frame = m_Frames[(m_Oldest + m_Pending) % MaxTrackedFrames];
+    GLCall(frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    frame.InputTime = inputTime;
+    m_Pending++;
+
+    while (Retire(false))
+        ;
+}
+
+void FramePacer::PrintSummary(std::ostream& out)
+{
+    out << "Input latency: ";
+    if (m_LatencyCount > 0)
+        out << (m_LatencySum / m_LatencyCount * 1000.0) << " ms avg, " << (m_LatencyMax * 1000.0) << " ms max";
+    else
+        out << "n/a";
+    out << " | Frames in flight: ";
+    if (m_MaxFramesInFlight > 0)
+        out << m_MaxFramesInFlight;
+    else
+        out << "driver";
+    out << " | Waited: " << (m_WaitSum * 1000.0) << " ms" << std::endl;
+
+    m_LatencySum = m_LatencyMax = m_WaitSum = 0.0;
+    m_LatencyCount = 0;
+}
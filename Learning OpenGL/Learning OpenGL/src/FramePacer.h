@@ -0,0 +1,59 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <ostream>
+
+/* Keeps the CPU from running too far ahead of the GPU, and measures input latency. */
+/*                                                                    */
+/* A fence goes into the command stream after every swap. Before a new frame is started, WaitForFrame */
+/* blocks until at most maxFramesInFlight - 1 of those fences are still pending, so the frame we are */
+/* about to build is at most maxFramesInFlight frames away from the screen instead of however many */
+/* the driver is willing to queue (often 3 or more). */
+/*                                                                    */
+/* Each fence remembers when the input of its frame was polled. When we see it signaled, the time since */
+/* then is the input latency of that frame, up to the moment the GPU finished it. With vsync off that is */
+/* about when it reaches the screen; with vsync on add up to one refresh. Fences are only checked when we */
+/* wait or at the end of a frame, so the numbers are rounded up to our own frame time. */
+class FramePacer
+{
+private:
+    struct Frame
+    {
+        GLsync Fence;
+        double InputTime;
+    };
+
+    static const unsigned int MaxTrackedFrames = 4;
+
+    Frame m_Frames[MaxTrackedFrames];
+    unsigned int m_Oldest;
+    unsigned int m_Pending;
+    unsigned int m_MaxFramesInFlight;
+
+    double m_LatencySum;
+    double m_LatencyMax;
+    unsigned int m_LatencyCount;
+    double m_WaitSum;
+
+    /* Retires frames from the oldest on, blocking on the oldest one if wait is true. */
+    bool Retire(bool wait);
+
+public:
+    /* 0 does not limit anything and only measures. */
+    explicit FramePacer(unsigned int maxFramesInFlight);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /* Call before polling input for the next frame. */
+    void WaitForFrame();
+
+    /* Call right after glfwSwapBuffers, with the time (glfwGetTime) input was polled for this frame. */
+    void EndFrame(double inputTime);
+
+    inline unsigned int GetMaxFramesInFlight() const { return m_MaxFramesInFlight; }
+
+    /* Average and worst latency and the time spent waiting since the last summary. */
+    void PrintSummary(std::ostream& out);
+};
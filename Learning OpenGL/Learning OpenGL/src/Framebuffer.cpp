@@ -0,0 +1,233 @@
+#include "Framebuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+static bool HasStencil(GLenum depthFormat)
+{
+    return depthFormat == GL_DEPTH24_STENCIL8 || depthFormat == GL_DEPTH32F_STENCIL8;
+}
+
+/* Storage for a single level texture, immutable when glTexStorage2D is available. */
+static unsigned int CreateTexture(GLenum internalFormat, int width, int height, bool depth)
+{
+    unsigned int texture;
+    GLCall(glGenTextures(1, &texture));
+    StateCache::BindTexture(0, GL_TEXTURE_2D, texture);
+    if (GLEW_ARB_texture_storage)
+    {
+        GLCall(glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height));
+    }
+    else
+    {
+        /* Without immutable storage the format and type have to be compatible with internalFormat, */
+        /* even though no data is passed. */
+        GLenum format = depth ? (HasStencil(internalFormat) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT) : GL_RGBA;
+        GLenum type = depth ? (HasStencil(internalFormat) ? GL_UNSIGNED_INT_24_8 : GL_FLOAT) : GL_UNSIGNED_BYTE;
+        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+    }
+
+    /* Linear so a lower resolution target can be scaled up from the texture as well as through BlitColor. */
+    GLenum filter = depth ? GL_NEAREST : GL_LINEAR;
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    return texture;
+}
+
+static unsigned int CreateRenderbuffer(GLenum internalFormat, int width, int height, unsigned int samples)
+{
+    unsigned int renderbuffer;
+    GLCall(glGenRenderbuffers(1, &renderbuffer));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer));
+    GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples > 1 ? samples : 0, internalFormat, width, height));
+    return renderbuffer;
+}
+
+/* Every attachment, and the resolve texture with MSAA. */
+static uint64_t GetStorageSize(const FramebufferSpec& spec)
+{
+    uint64_t size = GpuMemory::GetTextureSize(spec.ColorFormat, spec.Width, spec.Height, 1, 1, spec.Samples);
+    if (spec.DepthFormat != GL_NONE)
+        size += GpuMemory::GetTextureSize(spec.DepthFormat, spec.Width, spec.Height, 1, 1, spec.Samples);
+    if (spec.Samples > 1)
+        size += GpuMemory::GetTextureSize(spec.ColorFormat, spec.Width, spec.Height);
+    return size;
+}
+
+Framebuffer::Framebuffer(const FramebufferSpec& spec)
+    : m_Spec(spec), m_RendererID(0), m_ColorBuffer(0), m_DepthBuffer(0), m_ResolveID(0), m_ResolveTexture(0),
+      m_ViewportWidth(spec.Width), m_ViewportHeight(spec.Height)
+{
+    unsigned int maxSamples = GetMaxSamples();
+    if (m_Spec.Samples < 1)
+        m_Spec.Samples = 1;
+    if (m_Spec.Samples > maxSamples)
+        m_Spec.Samples = maxSamples;
+
+    /* Multisampled textures can be sampled, but only texel by texel, so they are no use to DepthPyramid. */
+    ASSERT(!m_Spec.DepthTexture || m_Spec.Samples == 1);
+
+    Create();
+}
+
+Framebuffer::~Framebuffer()
+{
+    Destroy();
+}
+
+void Framebuffer::Create()
+{
+    const int width = m_Spec.Width;
+    const int height = m_Spec.Height;
+    const bool multisampled = m_Spec.Samples > 1;
+    ASSERT(width > 0 && height > 0);
+
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+    if (multisampled)
+    {
+        m_ColorBuffer = CreateRenderbuffer(m_Spec.ColorFormat, width, height, m_Spec.Samples);
+        GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer));
+    }
+    else
+    {
+        m_ColorBuffer = CreateTexture(m_Spec.ColorFormat, width, height, false);
+        GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorBuffer, 0));
+    }
+
+    if (m_Spec.DepthFormat != GL_NONE)
+    {
+        GLenum attachment = HasStencil(m_Spec.DepthFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        if (m_Spec.DepthTexture)
+        {
+            m_DepthBuffer = CreateTexture(m_Spec.DepthFormat, width, height, true);
+            GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, m_DepthBuffer, 0));
+        }
+        else
+        {
+            m_DepthBuffer = CreateRenderbuffer(m_Spec.DepthFormat, width, height, m_Spec.Samples);
+            GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, m_DepthBuffer));
+        }
+    }
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    ASSERT(status == GL_FRAMEBUFFER_COMPLETE);
+
+    /* Only color is resolved, depth with more than one sample has no meaningful average. */
+    if (multisampled)
+    {
+        m_ResolveTexture = CreateTexture(m_Spec.ColorFormat, width, height, false);
+        GLCall(glGenFramebuffers(1, &m_ResolveID));
+        GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_ResolveID));
+        GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ResolveTexture, 0));
+        GLCall(GLenum resolveStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+        ASSERT(resolveStatus == GL_FRAMEBUFFER_COMPLETE);
+    }
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    GpuMemory::Allocate(GpuMemory::Category::RenderTargets, GetStorageSize(m_Spec));
+}
+
+void Framebuffer::Destroy()
+{
+    const bool multisampled = m_Spec.Samples > 1;
+
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+    if (multisampled)
+    {
+        GLCall(glDeleteRenderbuffers(1, &m_ColorBuffer));
+    }
+    else
+    {
+        StateCache::OnDeleteTexture(m_ColorBuffer);
+        GLCall(glDeleteTextures(1, &m_ColorBuffer));
+    }
+
+    if (m_Spec.DepthTexture)
+    {
+        StateCache::OnDeleteTexture(m_DepthBuffer);
+        GLCall(glDeleteTextures(1, &m_DepthBuffer));
+    }
+    else if (m_DepthBuffer)
+    {
+        GLCall(glDeleteRenderbuffers(1, &m_DepthBuffer));
+    }
+
+    if (multisampled)
+    {
+        GLCall(glDeleteFramebuffers(1, &m_ResolveID));
+        StateCache::OnDeleteTexture(m_ResolveTexture);
+        GLCall(glDeleteTextures(1, &m_ResolveTexture));
+    }
+
+    m_RendererID = m_ColorBuffer = m_DepthBuffer = m_ResolveID = m_ResolveTexture = 0;
+    GpuMemory::Free(GpuMemory::Category::RenderTargets, GetStorageSize(m_Spec));
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+    if (width != m_Spec.Width || height != m_Spec.Height)
+    {
+        Destroy();
+        m_Spec.Width = width;
+        m_Spec.Height = height;
+        Create();
+    }
+    m_ViewportWidth = width;
+    m_ViewportHeight = height;
+}
+
+void Framebuffer::SetViewportSize(int width, int height)
+{
+    ASSERT(width > 0 && width <= m_Spec.Width && height > 0 && height <= m_Spec.Height);
+    m_ViewportWidth = width;
+    m_ViewportHeight = height;
+}
+
+void Framebuffer::Bind() const
+{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+    GLCall(glViewport(0, 0, m_ViewportWidth, m_ViewportHeight));
+}
+
+void Framebuffer::Resolve() const
+{
+    if (m_Spec.Samples <= 1)
+        return;
+
+    /* A multisampled blit can't scale, so the resolve is 1:1 and scaling is left to BlitColor. */
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+    GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveID));
+    GLCall(glBlitFramebuffer(0, 0, m_ViewportWidth, m_ViewportHeight, 0, 0, m_ViewportWidth, m_ViewportHeight,
+        GL_COLOR_BUFFER_BIT, GL_NEAREST));
+
+    /* The samples are never read again, the next frame clears them. */
+    if (GLEW_ARB_invalidate_subdata)
+    {
+        GLenum depthAttachment = HasStencil(m_Spec.DepthFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        GLenum attachments[2] = { GL_COLOR_ATTACHMENT0, depthAttachment };
+        GLCall(glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, m_Spec.DepthFormat != GL_NONE ? 2 : 1, attachments));
+    }
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+}
+
+void Framebuffer::BlitColor(unsigned int drawFramebuffer, int x, int y, int width, int height, GLenum filter) const
+{
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, GetResolvedID()));
+    GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer));
+    GLCall(glBlitFramebuffer(0, 0, m_ViewportWidth, m_ViewportHeight, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, filter));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, drawFramebuffer));
+}
+
+unsigned int Framebuffer::GetMaxSamples()
+{
+    GLint samples = 1;
+    GLCall(glGetIntegerv(GL_MAX_SAMPLES, &samples));
+    return samples > 1 ? (unsigned int)samples : 1;
+}
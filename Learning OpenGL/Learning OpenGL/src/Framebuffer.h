@@ -0,0 +1,83 @@
+#pragma once
+
+#include <GL/glew.h>
+
+struct FramebufferSpec
+{
+    int Width = 0;
+    int Height = 0;
+
+    /* 1 renders into textures directly. More renders into multisampled renderbuffers, which Resolve */
+    /* blits into a single sampled color texture. Clamped to GL_MAX_SAMPLES. */
+    unsigned int Samples = 1;
+
+    GLenum ColorFormat = GL_RGBA8;
+    GLenum DepthFormat = GL_DEPTH24_STENCIL8; // GL_NONE for no depth attachment
+
+    /* Depth in a texture instead of a renderbuffer, to sample it later (see DepthPyramid). Single sampled only. */
+    bool DepthTexture = false;
+};
+
+/* An offscreen render target with a color and an optional depth attachment. */
+/*                                                                    */
+/* The storage is sized once and only reallocated by Resize when the size really changes. For dynamic */
+/* resolution the target is allocated at the largest size and SetViewportSize picks how much of it is */
+/* rendered to, so changing the render scale every few frames never reallocates anything. */
+/* With MSAA the scene is drawn into multisampled renderbuffers, Resolve averages the samples into the */
+/* color texture and tells the driver the multisampled contents are no longer needed, so tiled GPUs */
+/* don't have to write them back to memory. BlitColor then scales the result onto another framebuffer. */
+class Framebuffer
+{
+private:
+    FramebufferSpec m_Spec;
+    unsigned int m_RendererID;     // Drawn into, multisampled when m_Spec.Samples > 1
+    unsigned int m_ColorBuffer;    // Renderbuffer when multisampled, the color texture otherwise
+    unsigned int m_DepthBuffer;    // Renderbuffer or texture, see FramebufferSpec::DepthTexture
+    unsigned int m_ResolveID;      // Single sampled framebuffer around m_ResolveTexture, MSAA only
+    unsigned int m_ResolveTexture;
+    int m_ViewportWidth;
+    int m_ViewportHeight;
+
+    void Create();
+    void Destroy();
+
+public:
+    explicit Framebuffer(const FramebufferSpec& spec);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    /* Reallocates every attachment if the size changed, and resets the viewport size to the full size. */
+    void Resize(int width, int height);
+
+    /* The part of the target that is rendered to, from the bottom left corner. At most the allocated size. */
+    void SetViewportSize(int width, int height);
+
+    /* Binds the target for drawing and sets the viewport to the viewport size. */
+    void Bind() const;
+
+    /* Averages the samples of the viewport into the color texture and leaves the target bound. */
+    /* Does nothing without MSAA. */
+    void Resolve() const;
+
+    /* Copies the (resolved) viewport to the rectangle of drawFramebuffer, scaling with filter if the sizes */
+    /* differ. drawFramebuffer is left bound as GL_FRAMEBUFFER. */
+    void BlitColor(unsigned int drawFramebuffer, int x, int y, int width, int height, GLenum filter) const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    /* The single sampled framebuffer the resolved color is read from, e.g. by FrameCapture. */
+    inline unsigned int GetResolvedID() const { return m_Spec.Samples > 1 ? m_ResolveID : m_RendererID; }
+    inline int GetWidth() const { return m_Spec.Width; }
+    inline int GetHeight() const { return m_Spec.Height; }
+    inline int GetViewportWidth() const { return m_ViewportWidth; }
+    inline int GetViewportHeight() const { return m_ViewportHeight; }
+    inline unsigned int GetSamples() const { return m_Spec.Samples; }
+
+    /* The single sampled color texture, resolved when multisampled. */
+    inline unsigned int GetColorTexture() const { return m_Spec.Samples > 1 ? m_ResolveTexture : m_ColorBuffer; }
+    /* 0 unless FramebufferSpec::DepthTexture was set. */
+    inline unsigned int GetDepthTexture() const { return m_Spec.DepthTexture ? m_DepthBuffer : 0; }
+
+    static unsigned int GetMaxSamples();
+};
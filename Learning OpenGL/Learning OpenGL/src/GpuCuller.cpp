@@ -0,0 +1,138 @@
+#include "GpuCuller.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "Shader.h"
+#include "DepthPyramid.h"
+
+#include <cmath>
+
+/* Must match local_size_x in Cull.shader. */
+static const unsigned int GroupSize = 64;
+
+GpuCuller::GpuCuller(IndirectCommandBuffer& commands, const std::vector<Bounds>& bounds)
+    : m_Commands(commands), m_Frame(0), m_Program(0), m_PyramidViewProjectionLocation(-1), m_PyramidMaxLevelLocation(-1)
+{
+    ASSERT(bounds.size() == commands.GetCommandCount());
+
+    const std::vector<DrawElementsIndirectCommand>& list = commands.GetCommands();
+    m_Bounds.reset(new StorageBuffer(bounds.data(), (unsigned int)(bounds.size() * sizeof(Bounds))));
+    m_Input.reset(new StorageBuffer(list.data(), (unsigned int)(list.size() * sizeof(DrawElementsIndirectCommand))));
+
+    for (unsigned int i = 0; i < CounterBufferCount; i++)
+    {
+        m_Counters[i].reset(new StorageBuffer(nullptr, sizeof(Counters)));
+        m_Fences[i] = nullptr;
+    }
+
+    m_Stats.Objects = commands.GetCommandCount();
+}
+
+GpuCuller::~GpuCuller()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+}
+
+void GpuCuller::Cull(Shader& shader, const Mat4& viewProjection, const DepthPyramid* pyramid, const Mat4& pyramidViewProjection)
+{
+    ReadCounters();
+
+    const unsigned int counter = m_Frame % CounterBufferCount;
+    const Counters zero = { 0, 0 };
+    m_Counters[counter]->SetData(&zero, sizeof(Counters));
+
+    float planes[6][4];
+    ExtractFrustumPlanes(viewProjection, planes);
+
+    shader.Bind();
+    shader.SetUniform4fv("u_Planes", 6, &planes[0][0]);
+    shader.SetUniform1i("u_ObjectCount", (int)m_Commands.GetCommandCount());
+    shader.SetUniform1i("u_Occlusion", pyramid ? 1 : 0);
+    if (pyramid)
+    {
+        /* These names are too long for the small string optimization, so looking them up by name */
+        /* would allocate a std::string every frame. */
+        if (m_Program != shader.GetRendererID())
+        {
+            m_Program = shader.GetRendererID();
+            m_PyramidViewProjectionLocation = shader.GetUniformLocation("u_PyramidViewProjection");
+            m_PyramidMaxLevelLocation = shader.GetUniformLocation("u_PyramidMaxLevel");
+        }
+        GLCall(glUniformMatrix4fv(m_PyramidViewProjectionLocation, 1, GL_FALSE, pyramidViewProjection.Elements));
+        GLCall(glUniform1f(m_PyramidMaxLevelLocation, (float)(pyramid->GetLevelCount() - 1)));
+        shader.SetUniform2f("u_PyramidSize", (float)pyramid->GetWidth(), (float)pyramid->GetHeight());
+        shader.SetUniform1i("u_Pyramid", PyramidTextureUnit);
+        pyramid->Bind(PyramidTextureUnit);
+    }
+
+    m_Bounds->BindBase(BoundsBinding);
+    m_Input->BindBase(InputBinding);
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, OutputBinding, m_Commands.GetRendererID());
+    m_Counters[counter]->BindBase(CounterBinding);
+
+    GLCall(glDispatchCompute((m_Commands.GetCommandCount() + GroupSize - 1) / GroupSize, 1, 1));
+
+    /* The draw reads the commands as indirect arguments, the counters are read back with glGetBufferSubData. */
+    GLCall(glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT));
+
+    if (m_Fences[counter])
+    {
+        GLCall(glDeleteSync(m_Fences[counter]));
+    }
+    GLCall(m_Fences[counter] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_Frame++;
+}
+
+void GpuCuller::ReadCounters()
+{
+    /* The oldest counters in the ring, unless the GPU has not got to them yet, in which case we keep the */
+    /* previous stats rather than wait. */
+    const unsigned int oldest = m_Frame % CounterBufferCount;
+    GLsync fence = m_Fences[oldest];
+    if (!fence)
+        return;
+
+    GLCall(GLenum result = glClientWaitSync(fence, 0, 0));
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        return;
+
+    Counters counters;
+    m_Counters[oldest]->GetData(&counters, sizeof(Counters));
+    m_Stats.Visible = counters.Visible;
+    m_Stats.Triangles = counters.Triangles;
+
+    GLCall(glDeleteSync(fence));
+    m_Fences[oldest] = nullptr;
+}
+
+void GpuCuller::ExtractFrustumPlanes(const Mat4& viewProjection, float planes[6][4])
+{
+    /* Gribb and Hartmann: each plane is the last row of the matrix plus or minus one of the other rows. */
+    const float* m = viewProjection.Elements;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            const float last = m[j * 4 + 3];
+            const float row = m[j * 4 + i];
+            planes[i * 2 + 0][j] = last + row;
+            planes[i * 2 + 1][j] = last - row;
+        }
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        const float length = std::sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+        if (length > 0.0f)
+        {
+            for (int j = 0; j < 4; j++)
+                planes[i][j] /= length;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <memory>
+#include <vector>
+
+#include "Math.h"
+#include "StorageBuffer.h"
+#include "IndirectCommandBuffer.h"
+
+class Shader;
+class DepthPyramid;
+
+/* Frustum and occlusion culling on the GPU, feeding an IndirectCommandBuffer. */
+/*                                                                    */
+/* The commands added to the buffer (and uploaded) describe every object. The culler keeps them as its */
+/* input, and every Cull dispatch of res/shaders/Cull.shader tests one bounding sphere per command: */
+/* against the six planes of the view, then against a DepthPyramid of the previous frame. Every object */
+/* gets its command rewritten straight into the indirect buffer, with InstanceCount 0 if it was culled, */
+/* so the following Renderer::DrawIndirect draws only what survived without the CPU reading anything back. */
+/* Draws with zero instances cost the command processor next to nothing. */
+/*                                                                    */
+/* How many objects survived is only known later: the counters are written to a small ring of buffers */
+/* and read back once their fence has signaled, a couple of frames after the fact, never stalling. */
+/* Needs compute shaders, see Shader::IsComputeSupported. */
+class GpuCuller
+{
+public:
+    /* Binding points used by Cull.shader. */
+    static const unsigned int BoundsBinding = 0;
+    static const unsigned int InputBinding = 1;
+    static const unsigned int OutputBinding = 2;
+    static const unsigned int CounterBinding = 3;
+    static const unsigned int PyramidTextureUnit = 0;
+
+    /* Bounding sphere of one object, in the same space as the view projection given to Cull. */
+    struct Bounds
+    {
+        float Center[3];
+        float Radius;
+    };
+
+    struct Stats
+    {
+        unsigned int Objects = 0;
+        unsigned int Visible = 0;
+        unsigned long long Triangles = 0; // Of the visible objects
+    };
+
+private:
+    /* std430 layout of the counters in Cull.shader. */
+    struct Counters
+    {
+        unsigned int Visible;
+        unsigned int Triangles;
+    };
+
+    static const unsigned int CounterBufferCount = 3;
+
+    IndirectCommandBuffer& m_Commands;
+    std::unique_ptr<StorageBuffer> m_Bounds;
+    std::unique_ptr<StorageBuffer> m_Input;
+    std::unique_ptr<StorageBuffer> m_Counters[CounterBufferCount];
+    GLsync m_Fences[CounterBufferCount];
+    unsigned int m_Frame;
+
+    unsigned int m_Program; // The program the locations below belong to
+    int m_PyramidViewProjectionLocation;
+    int m_PyramidMaxLevelLocation;
+
+    Stats m_Stats;
+
+public:
+    /* bounds has one entry per command of commands, in the same order. */
+    GpuCuller(IndirectCommandBuffer& commands, const std::vector<Bounds>& bounds);
+    ~GpuCuller();
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+    /* Rewrites the indirect buffer for the given view. pyramid may be null to only cull against the frustum, */
+    /* otherwise pyramidViewProjection is the view projection the pyramid's depth was rendered with. */
+    void Cull(Shader& shader, const Mat4& viewProjection, const DepthPyramid* pyramid, const Mat4& pyramidViewProjection);
+
+    /* The most recent counts the GPU has finished. */
+    inline const Stats& GetStats() const { return m_Stats; }
+
+    /* The planes (a, b, c, d) with ax + by + cz + d >= 0 inside, normalized so d is a distance. */
+    static void ExtractFrustumPlanes(const Mat4& viewProjection, float planes[6][4]);
+
+private:
+    void ReadCounters();
+};
@@ -0,0 +1,215 @@
+#include "GpuMemory.h"
+
+#include <cstdio>
+
+#include "Renderer.h"
+#include "Texture.h"
+
+namespace {
+
+    GpuMemory::Usage s_Usage[(int)GpuMemory::Category::Count];
+    uint64_t s_Total = 0;
+    uint64_t s_Peak = 0;
+    uint64_t s_Budget = 0;
+
+    /* Uncompressed formats only, compressed ones are sized by Texture::GetLevelSize. */
+    unsigned int GetBytesPerPixel(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case GL_R8:
+                return 1;
+            case GL_RG8:
+            case GL_R16F:
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGB8:
+            case GL_SRGB8:
+                return 3; // Usually padded to 4 by the driver
+            case GL_RGBA16F:
+            case GL_RG32F:
+            case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGBA32F:
+                return 16;
+            default:
+                return 4; // RGBA8, R32F, the 24 and 32 bit depth formats and most others
+        }
+    }
+
+    void Print(std::ostream& out, const char* name, const GpuMemory::Usage& usage, bool sized)
+    {
+        char line[160];
+        if (sized)
+            snprintf(line, sizeof(line), "%-16s %9.2f MB in %5u objects (peak %.2f MB)", name, usage.Bytes / (1024.0 * 1024.0),
+                usage.Objects, usage.PeakBytes / (1024.0 * 1024.0));
+        else
+            snprintf(line, sizeof(line), "%-16s %5u objects", name, usage.Objects);
+        out << line << std::endl;
+    }
+
+}
+
+void GpuMemory::Allocate(Category category, uint64_t bytes)
+{
+    Usage& usage = s_Usage[(int)category];
+    usage.Objects++;
+    Resize(category, 0, bytes);
+}
+
+void GpuMemory::Free(Category category, uint64_t bytes)
+{
+    Usage& usage = s_Usage[(int)category];
+    ASSERT(usage.Objects > 0);
+    usage.Objects--;
+    Resize(category, bytes, 0);
+}
+
+void GpuMemory::Resize(Category category, uint64_t oldBytes, uint64_t newBytes)
+{
+    Usage& usage = s_Usage[(int)category];
+    ASSERT(usage.Bytes >= oldBytes && s_Total >= oldBytes);
+    usage.Bytes = usage.Bytes - oldBytes + newBytes;
+    if (usage.Bytes > usage.PeakBytes)
+        usage.PeakBytes = usage.Bytes;
+
+    s_Total = s_Total - oldBytes + newBytes;
+    if (s_Total > s_Peak)
+        s_Peak = s_Total;
+}
+
+const GpuMemory::Usage& GpuMemory::GetUsage(Category category)
+{
+    return s_Usage[(int)category];
+}
+
+uint64_t GpuMemory::GetTotalBytes()
+{
+    return s_Total;
+}
+
+uint64_t GpuMemory::GetPeakBytes()
+{
+    return s_Peak;
+}
+
+void GpuMemory::SetBudget(uint64_t bytes)
+{
+    s_Budget = bytes;
+}
+
+uint64_t GpuMemory::GetBudget()
+{
+    return s_Budget;
+}
+
+bool GpuMemory::IsOverBudget()
+{
+    return s_Budget > 0 && s_Total > s_Budget;
+}
+
+uint64_t GpuMemory::GetBudgetHeadroom()
+{
+    if (s_Budget == 0)
+        return ~0ull;
+    return s_Total < s_Budget ? s_Budget - s_Total : 0;
+}
+
+GpuMemory::DeviceInfo GpuMemory::QueryDevice()
+{
+    DeviceInfo info;
+
+    /* Both extensions report kilobytes. */
+    if (GLEW_NVX_gpu_memory_info)
+    {
+        GLint total = 0, available = 0, evictions = 0, evicted = 0;
+        GLCall(glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total));
+        GLCall(glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available));
+        GLCall(glGetIntegerv(GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX, &evictions));
+        GLCall(glGetIntegerv(GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX, &evicted));
+        info.Source = "GL_NVX_gpu_memory_info";
+        info.TotalBytes = (uint64_t)total * 1024;
+        info.AvailableBytes = (uint64_t)available * 1024;
+        info.Evictions = (unsigned int)evictions;
+        info.EvictedBytes = (uint64_t)evicted * 1024;
+    }
+    else if (GLEW_ATI_meminfo)
+    {
+        /* Four values per pool: total free, largest free block, and the same for auxiliary memory. */
+        /* Textures and buffers usually share one pool, the texture pool is the one that matters most. */
+        GLint pool[4] = {};
+        GLCall(glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, pool));
+        info.Source = "GL_ATI_meminfo";
+        info.AvailableBytes = (uint64_t)pool[0] * 1024;
+    }
+
+    return info;
+}
+
+uint64_t GpuMemory::GetTextureSize(GLenum internalFormat, int width, int height, unsigned int levels, unsigned int layers,
+    unsigned int samples)
+{
+    const bool compressed = Texture::IsCompressedFormat(internalFormat);
+    uint64_t size = 0;
+    for (unsigned int level = 0; level < levels; level++)
+    {
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        if (compressed)
+            size += Texture::GetLevelSize(internalFormat, levelWidth, levelHeight);
+        else
+            size += (uint64_t)levelWidth * levelHeight * GetBytesPerPixel(internalFormat);
+    }
+    return size * layers * (samples > 1 ? samples : 1);
+}
+
+const char* GpuMemory::GetCategoryName(Category category)
+{
+    switch (category)
+    {
+        case Category::VertexBuffers: return "Vertex buffers";
+        case Category::IndexBuffers: return "Index buffers";
+        case Category::UniformBuffers: return "Uniform buffers";
+        case Category::StorageBuffers: return "Storage buffers";
+        case Category::IndirectBuffers: return "Indirect buffers";
+        case Category::StreamBuffers: return "Stream buffers";
+        case Category::PixelBuffers: return "Pixel buffers";
+        case Category::Textures: return "Textures";
+        case Category::RenderTargets: return "Render targets";
+        case Category::VertexArrays: return "Vertex arrays";
+        case Category::Programs: return "Programs";
+        default: return "Unknown";
+    }
+}
+
+void GpuMemory::PrintSummary(std::ostream& out)
+{
+    for (int i = 0; i < (int)Category::Count; i++)
+    {
+        const Category category = (Category)i;
+        if (s_Usage[i].Objects > 0 || s_Usage[i].PeakBytes > 0)
+            Print(out, GetCategoryName(category), s_Usage[i], category != Category::VertexArrays && category != Category::Programs);
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%-16s %9.2f MB (peak %.2f MB)", "Total", s_Total / (1024.0 * 1024.0), s_Peak / (1024.0 * 1024.0));
+    out << line;
+    if (s_Budget)
+    {
+        snprintf(line, sizeof(line), " of a %.0f MB budget%s", s_Budget / (1024.0 * 1024.0), IsOverBudget() ? ", OVER BUDGET" : "");
+        out << line;
+    }
+    out << std::endl;
+
+    DeviceInfo device = QueryDevice();
+    if (device.Source)
+    {
+        if (device.TotalBytes)
+            snprintf(line, sizeof(line), "%-16s %9.2f MB free of %.2f MB | Evictions: %u (%.2f MB) [%s]", "Device",
+                device.AvailableBytes / (1024.0 * 1024.0), device.TotalBytes / (1024.0 * 1024.0), device.Evictions,
+                device.EvictedBytes / (1024.0 * 1024.0), device.Source);
+        else
+            snprintf(line, sizeof(line), "%-16s %9.2f MB free [%s]", "Device", device.AvailableBytes / (1024.0 * 1024.0), device.Source);
+        out << line << std::endl;
+    }
+}
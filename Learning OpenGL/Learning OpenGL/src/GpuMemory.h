@@ -0,0 +1,72 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <ostream>
+
+/* Keeps count of the GPU memory our own objects hold, per kind of object, against an optional budget. */
+/*                                                                    */
+/* Every wrapper that allocates storage (VertexBuffer, Texture, Framebuffer, ...) reports it here when */
+/* the storage is created and when it is deleted, so the numbers are what we asked for, not what the */
+/* driver really uses: it pads, aligns, keeps copies for orphaned buffers and may not allocate at all */
+/* until first use. Vertex arrays and programs have no size we can know and are only counted. */
+/* What the driver says is free on the whole device is read separately by QueryDevice, from */
+/* GL_NVX_gpu_memory_info (NVIDIA) or GL_ATI_meminfo (AMD) when either is there. */
+/* The budget is only bookkeeping: IsOverBudget and GetBudgetHeadroom tell streaming code how much */
+/* it may still load, or that it should evict something first. GL thread only, like StateCache. */
+class GpuMemory
+{
+public:
+    enum class Category
+    {
+        VertexBuffers, IndexBuffers, UniformBuffers, StorageBuffers, IndirectBuffers, StreamBuffers, PixelBuffers,
+        Textures, RenderTargets, VertexArrays, Programs, Count
+    };
+
+    struct Usage
+    {
+        uint64_t Bytes = 0;
+        uint64_t PeakBytes = 0;
+        unsigned int Objects = 0;
+    };
+
+    struct DeviceInfo
+    {
+        const char* Source = nullptr; // The extension the numbers come from, null if there is none
+        uint64_t TotalBytes = 0;      // 0 when the extension doesn't say (GL_ATI_meminfo)
+        uint64_t AvailableBytes = 0;
+        unsigned int Evictions = 0;   // How often the driver had to move something out of video memory
+        uint64_t EvictedBytes = 0;
+    };
+
+    /* One object of category now holds bytes more. Objects without a size allocate 0 bytes. */
+    static void Allocate(Category category, uint64_t bytes);
+    static void Free(Category category, uint64_t bytes);
+    /* For objects whose storage is replaced without deleting them. */
+    static void Resize(Category category, uint64_t oldBytes, uint64_t newBytes);
+
+    static const Usage& GetUsage(Category category);
+    static uint64_t GetTotalBytes();
+    static uint64_t GetPeakBytes(); // Highest total so far
+
+    /* 0, the default, means no budget. */
+    static void SetBudget(uint64_t bytes);
+    static uint64_t GetBudget();
+    static bool IsOverBudget();
+    /* How much can still be allocated, 0 when over budget and the largest value without a budget. */
+    static uint64_t GetBudgetHeadroom();
+
+    /* Reads what the driver reports. Cheap enough for once per report, but not free: the driver may */
+    /* have to ask its kernel side. */
+    static DeviceInfo QueryDevice();
+
+    /* Storage of a texture with levels mip levels (each half the previous size) and layers layers, */
+    /* or of a renderbuffer with samples samples. */
+    static uint64_t GetTextureSize(GLenum internalFormat, int width, int height, unsigned int levels = 1,
+        unsigned int layers = 1, unsigned int samples = 1);
+
+    static const char* GetCategoryName(Category category);
+
+    /* Usage of every category holding anything, the budget and the device numbers. */
+    static void PrintSummary(std::ostream& out);
+};
@@ -0,0 +1,196 @@
+#include "HotReloader.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Renderer.h"
+#include "FileWatcher.h"
+#include "ProgramCache.h"
+#include "TextureLoader.h"
+
+std::unique_ptr<FileWatcher> HotReloader::s_Watcher;
+std::vector<Shader*> HotReloader::s_Shaders;
+std::vector<TextureLoader*> HotReloader::s_Loaders;
+std::vector<HotReloader::PendingReload> HotReloader::s_Pending;
+std::vector<std::string> HotReloader::s_Changed;
+HotReloader::Stats HotReloader::s_Stats;
+
+bool HotReloader::Start(const std::string& directory)
+{
+    s_Watcher.reset(new FileWatcher(directory));
+    if (!s_Watcher->IsWatching())
+    {
+        s_Watcher.reset();
+        return false;
+    }
+    return true;
+}
+
+void HotReloader::Stop()
+{
+    for (PendingReload& reload : s_Pending)
+        Discard(reload);
+    s_Pending.clear();
+    s_Stats.Pending = 0;
+    s_Watcher.reset();
+}
+
+bool HotReloader::IsRunning()
+{
+    return s_Watcher != nullptr;
+}
+
+void HotReloader::Register(Shader* shader)
+{
+    s_Shaders.push_back(shader);
+}
+
+void HotReloader::Unregister(Shader* shader)
+{
+    s_Shaders.erase(std::remove(s_Shaders.begin(), s_Shaders.end(), shader), s_Shaders.end());
+
+    /* A reload still compiling for a shader that is gone has nowhere to go. */
+    DiscardPending(shader);
+}
+
+void HotReloader::Register(TextureLoader* loader)
+{
+    s_Loaders.push_back(loader);
+}
+
+void HotReloader::Unregister(TextureLoader* loader)
+{
+    s_Loaders.erase(std::remove(s_Loaders.begin(), s_Loaders.end(), loader), s_Loaders.end());
+}
+
+void HotReloader::Discard(PendingReload& reload)
+{
+    Shader::PendingProgram& pending = reload.Pending;
+    if (pending.VertexShader)
+    {
+        GLCall(glDeleteShader(pending.VertexShader));
+    }
+    if (pending.FragmentShader)
+    {
+        GLCall(glDeleteShader(pending.FragmentShader));
+    }
+    if (pending.ComputeShader)
+    {
+        GLCall(glDeleteShader(pending.ComputeShader));
+    }
+    if (pending.Program)
+    {
+        GLCall(glDeleteProgram(pending.Program));
+    }
+    pending = Shader::PendingProgram();
+}
+
+void HotReloader::DiscardPending(const Shader* shader)
+{
+    for (size_t i = 0; i < s_Pending.size(); )
+    {
+        if (s_Pending[i].Target == shader)
+        {
+            Discard(s_Pending[i]);
+            s_Pending.erase(s_Pending.begin() + i);
+        }
+        else
+            i++;
+    }
+    s_Stats.Pending = (unsigned int)s_Pending.size();
+}
+
+void HotReloader::ReloadShader(Shader& shader)
+{
+    /* Parsing is cheap next to compiling, so it stays on this thread. Only the compile runs in the background. */
+    ShaderProgramSource source = Shader::ParseShader(shader.GetFilePath(), shader.GetDefines());
+
+    /* Saving twice in a row or undoing an edit: the program may already be in the binary cache. */
+    unsigned int program = ProgramCache::Load(source);
+    if (program)
+    {
+        /* An older edit still compiling would replace this one when it finishes. */
+        DiscardPending(&shader);
+        shader.ReplaceProgram(program, source.Files);
+        s_Stats.Reloads++;
+        std::cout << "Hot reload: " << shader.GetFilePath() << " (from the program cache)" << std::endl;
+        return;
+    }
+
+    /* Only the latest edit matters, an older compile still running for the same shader is thrown away. */
+    for (PendingReload& reload : s_Pending)
+    {
+        if (reload.Target == &shader)
+        {
+            Discard(reload);
+            reload.Source = std::move(source);
+            reload.Pending = Shader::SubmitProgram(reload.Source);
+            return;
+        }
+    }
+
+    PendingReload reload;
+    reload.Target = &shader;
+    reload.Source = std::move(source);
+    reload.Pending = Shader::SubmitProgram(reload.Source);
+    s_Pending.push_back(std::move(reload));
+}
+
+void HotReloader::Update()
+{
+    if (!s_Watcher)
+        return;
+
+    s_Changed.clear();
+    s_Watcher->Poll(s_Changed);
+
+    for (const std::string& path : s_Changed)
+    {
+        bool used = false;
+        for (Shader* shader : s_Shaders)
+        {
+            if (shader->DependsOn(path))
+            {
+                ReloadShader(*shader);
+                used = true;
+            }
+        }
+        for (TextureLoader* loader : s_Loaders)
+        {
+            if (loader->Reload(path))
+            {
+                s_Stats.Reloads++;
+                used = true;
+            }
+        }
+        if (used)
+            std::cout << "Hot reload: " << path << " changed" << std::endl;
+    }
+
+    for (size_t i = 0; i < s_Pending.size(); )
+    {
+        PendingReload& reload = s_Pending[i];
+        if (!Shader::IsProgramComplete(reload.Pending))
+        {
+            i++;
+            continue;
+        }
+
+        Shader& shader = *reload.Target;
+        unsigned int program = Shader::FinishProgram(reload.Pending, shader.GetFilePath());
+        if (program)
+        {
+            ProgramCache::Store(program, reload.Source);
+            shader.ReplaceProgram(program, reload.Source.Files);
+            s_Stats.Reloads++;
+            std::cout << "Hot reload: " << shader.GetFilePath() << " reloaded" << std::endl;
+        }
+        else
+        {
+            s_Stats.Failures++;
+            std::cout << "Hot reload: " << shader.GetFilePath() << " failed, keeping the last good program" << std::endl;
+        }
+        s_Pending.erase(s_Pending.begin() + i);
+    }
+    s_Stats.Pending = (unsigned int)s_Pending.size();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+
+class FileWatcher;
+class TextureLoader;
+
+/* Reloads shaders and textures while the application runs, when their files change on disk. */
+/*                                                                    */
+/* Every Shader and TextureLoader registers itself here. Update, called at the start of every frame on */
+/* the GL thread, asks the FileWatcher what changed and only rebuilds what depends on it: a shader is */
+/* reparsed when its .shader file or any file it #includes changed, then compiled in the background */
+/* like ShaderCompiler does, and swapped in with Shader::ReplaceProgram once the driver is done. */
+/* A shader that fails to compile keeps its last good program, so a typo never takes the scene down. */
+/* Textures are decoded again by their TextureLoader and uploaded into the same GL texture. */
+class HotReloader
+{
+public:
+    struct Stats
+    {
+        unsigned int Reloads = 0;  // Shaders and textures swapped in
+        unsigned int Failures = 0; // Shaders that didn't compile, the old program was kept
+        unsigned int Pending = 0;  // Shaders still compiling
+    };
+
+private:
+    struct PendingReload
+    {
+        Shader* Target;
+        ShaderProgramSource Source;
+        Shader::PendingProgram Pending;
+    };
+
+    static std::unique_ptr<FileWatcher> s_Watcher;
+    static std::vector<Shader*> s_Shaders;
+    static std::vector<TextureLoader*> s_Loaders;
+    static std::vector<PendingReload> s_Pending;
+    static std::vector<std::string> s_Changed; // Reused every Update
+    static Stats s_Stats;
+
+public:
+    /* Watches directory and everything below it. Returns false if it can't be watched. */
+    static bool Start(const std::string& directory = "res");
+    static void Stop();
+    static bool IsRunning();
+
+    /* GL thread only, before anything is rendered. Does nothing until Start was called. */
+    static void Update();
+
+    /* Called by the constructors and destructors, never needed anywhere else. */
+    static void Register(Shader* shader);
+    static void Unregister(Shader* shader);
+    static void Register(TextureLoader* loader);
+    static void Unregister(TextureLoader* loader);
+
+    static inline const Stats& GetStats() { return s_Stats; }
+
+private:
+    static void ReloadShader(Shader& shader);
+    static void Discard(PendingReload& reload);
+    /* Throws away every compile still running for shader. */
+    static void DiscardPending(const Shader* shader);
+};
@@ -0,0 +1,345 @@
+#include "ImageDecoder.h"
+#include "Texture.h"
+
+#include <cstring>
+#include <fstream>
+
+static bool ReadBinaryFile(const std::string& filepath, std::vector<unsigned char>& out)
+{
+    std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+    if (!stream)
+        return false;
+
+    std::streamoff size = stream.tellg();
+    out.resize((size_t)size);
+    stream.seekg(0);
+    return size == 0 || (bool)stream.read((char*)out.data(), size);
+}
+
+static unsigned int ReadU32(const unsigned char* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int)data[3] << 24);
+}
+
+static bool EndsWith(const std::string& text, const char* suffix)
+{
+    size_t length = strlen(suffix);
+    if (text.size() < length)
+        return false;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[text.size() - length + i];
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        if (c != suffix[i])
+            return false;
+    }
+    return true;
+}
+
+bool ImageDecoder::Decode(const std::string& filepath, Image& image, std::string& error)
+{
+    std::vector<unsigned char> file;
+    if (!ReadBinaryFile(filepath, file))
+    {
+        error = "can't read the file";
+        return false;
+    }
+
+    if (EndsWith(filepath, ".tga"))
+        return DecodeTGA(file, image, error);
+    if (EndsWith(filepath, ".dds"))
+        return DecodeDDS(file, image, error);
+    if (EndsWith(filepath, ".ktx"))
+        return DecodeKTX(file, image, error);
+
+    error = "unknown image format";
+    return false;
+}
+
+bool ImageDecoder::DecodeTGA(const std::vector<unsigned char>& file, Image& image, std::string& error)
+{
+    if (file.size() < 18)
+    {
+        error = "truncated TGA header";
+        return false;
+    }
+
+    const unsigned char* header = file.data();
+    unsigned int idLength = header[0];
+    unsigned int colorMapType = header[1];
+    unsigned int imageType = header[2];
+    int width = header[12] | (header[13] << 8);
+    int height = header[14] | (header[15] << 8);
+    unsigned int bitsPerPixel = header[16];
+    bool topDown = (header[17] & 0x20) != 0;
+
+    bool rle = imageType == 10 || imageType == 11;
+    bool gray = imageType == 3 || imageType == 11;
+    bool supported = colorMapType == 0 && (imageType == 2 || imageType == 3 || rle) &&
+        (gray ? bitsPerPixel == 8 : (bitsPerPixel == 24 || bitsPerPixel == 32));
+    if (!supported || width <= 0 || height <= 0)
+    {
+        error = "unsupported TGA (only 24/32 bit true color and 8 bit grayscale, raw or RLE)";
+        return false;
+    }
+    if (width > MaxSize || height > MaxSize)
+    {
+        error = "TGA too large";
+        return false;
+    }
+
+    const unsigned int pixelBytes = bitsPerPixel / 8;
+    const size_t pixelCount = (size_t)width * height;
+    const unsigned char* source = file.data() + 18 + idLength;
+    const unsigned char* end = file.data() + file.size();
+
+    image.Data.resize(pixelCount * 4);
+    image.Levels.assign(1, Image::Level{ width, height, 0, (unsigned int)(pixelCount * 4) });
+    image.InternalFormat = GL_RGBA8;
+    image.GenerateMipmaps = true;
+
+    /* TGA stores BGR(A), we convert to RGBA while decoding. */
+    size_t pixel = 0;
+    while (pixel < pixelCount)
+    {
+        unsigned int run = 1;
+        bool repeat = false;
+        if (rle)
+        {
+            if (source >= end)
+                break;
+            unsigned char packet = *source++;
+            run = (packet & 0x7f) + 1;
+            repeat = (packet & 0x80) != 0;
+        }
+        if (pixel + run > pixelCount)
+            break;
+
+        for (unsigned int i = 0; i < run; i++)
+        {
+            if (source + pixelBytes > end)
+            {
+                error = "truncated TGA data";
+                return false;
+            }
+
+            size_t row = pixel / width;
+            size_t column = pixel % width;
+            size_t targetRow = topDown ? height - 1 - row : row;
+            unsigned char* target = &image.Data[(targetRow * width + column) * 4];
+            if (gray)
+            {
+                target[0] = target[1] = target[2] = source[0];
+                target[3] = 255;
+            }
+            else
+            {
+                target[0] = source[2];
+                target[1] = source[1];
+                target[2] = source[0];
+                target[3] = pixelBytes == 4 ? source[3] : 255;
+            }
+
+            pixel++;
+            if (!repeat || i + 1 == run)
+                source += pixelBytes;
+        }
+    }
+
+    if (pixel < pixelCount)
+    {
+        error = "truncated TGA data";
+        return false;
+    }
+    return true;
+}
+
+/* Fills in the levels of a block compressed image whose level 0 starts at offset in file. */
+static bool ReadCompressedLevels(const std::vector<unsigned char>& file, unsigned int offset, int width, int height,
+    unsigned int levels, GLenum internalFormat, Image& image, std::string& error)
+{
+    image.InternalFormat = internalFormat;
+    image.GenerateMipmaps = false;
+    image.Levels.clear();
+
+    unsigned int total = 0;
+    for (unsigned int level = 0; level < levels; level++)
+    {
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        unsigned int size = Texture::GetLevelSize(internalFormat, levelWidth, levelHeight);
+        image.Levels.push_back({ levelWidth, levelHeight, total, size });
+        total += size;
+    }
+
+    if (offset + total > file.size())
+    {
+        error = "truncated image data";
+        return false;
+    }
+
+    image.Data.assign(file.begin() + offset, file.begin() + offset + total);
+    return true;
+}
+
+bool ImageDecoder::DecodeDDS(const std::vector<unsigned char>& file, Image& image, std::string& error)
+{
+    /* "DDS ", then a 124 byte DDS_HEADER, then a 20 byte DDS_HEADER_DXT10 if the FourCC is "DX10". */
+    if (file.size() < 128 || memcmp(file.data(), "DDS ", 4) != 0)
+    {
+        error = "not a DDS file";
+        return false;
+    }
+
+    const unsigned char* header = file.data() + 4;
+    int height = (int)ReadU32(header + 8);
+    int width = (int)ReadU32(header + 12);
+    unsigned int levels = ReadU32(header + 24);
+    const unsigned char* fourCC = header + 80;
+    if (levels == 0)
+        levels = 1;
+
+    GLenum internalFormat = GL_NONE;
+    unsigned int offset = 128;
+    if (memcmp(fourCC, "DXT1", 4) == 0)
+        internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    else if (memcmp(fourCC, "DXT3", 4) == 0)
+        internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    else if (memcmp(fourCC, "DXT5", 4) == 0)
+        internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if (memcmp(fourCC, "ATI1", 4) == 0 || memcmp(fourCC, "BC4U", 4) == 0)
+        internalFormat = GL_COMPRESSED_RED_RGTC1;
+    else if (memcmp(fourCC, "ATI2", 4) == 0 || memcmp(fourCC, "BC5U", 4) == 0)
+        internalFormat = GL_COMPRESSED_RG_RGTC2;
+    else if (memcmp(fourCC, "DX10", 4) == 0)
+    {
+        if (file.size() < 148)
+        {
+            error = "truncated DDS header";
+            return false;
+        }
+
+        offset = 148;
+        switch (ReadU32(file.data() + 128)) // DXGI_FORMAT
+        {
+            case 71: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;         break; // BC1_UNORM
+            case 72: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;   break; // BC1_UNORM_SRGB
+            case 74: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;         break; // BC2_UNORM
+            case 75: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;   break; // BC2_UNORM_SRGB
+            case 77: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;         break; // BC3_UNORM
+            case 78: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;   break; // BC3_UNORM_SRGB
+            case 80: internalFormat = GL_COMPRESSED_RED_RGTC1;                  break; // BC4_UNORM
+            case 81: internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1;           break; // BC4_SNORM
+            case 83: internalFormat = GL_COMPRESSED_RG_RGTC2;                   break; // BC5_UNORM
+            case 84: internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2;            break; // BC5_SNORM
+            case 95: internalFormat = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB; break; // BC6H_UF16
+            case 96: internalFormat = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB;  break; // BC6H_SF16
+            case 98: internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;        break; // BC7_UNORM
+            case 99: internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB;  break; // BC7_UNORM_SRGB
+        }
+    }
+
+    if (internalFormat == GL_NONE || width <= 0 || height <= 0)
+    {
+        error = "unsupported DDS format (only BC1 to BC7)";
+        return false;
+    }
+    if (width > MaxSize || height > MaxSize)
+    {
+        error = "DDS too large";
+        return false;
+    }
+
+    /* More levels than the full chain would shift the level sizes past 0, and glTexStorage2D refuses them anyway. */
+    if (levels > Texture::GetMipLevelCount(width, height))
+    {
+        error = "more DDS mip levels than the image has";
+        return false;
+    }
+
+    return ReadCompressedLevels(file, offset, width, height, levels, internalFormat, image, error);
+}
+
+bool ImageDecoder::DecodeKTX(const std::vector<unsigned char>& file, Image& image, std::string& error)
+{
+    /* KTX 1.1: a 12 byte identifier, 13 32-bit fields, key/value data, then each level prefixed by its size. */
+    static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    if (file.size() < 64 || memcmp(file.data(), identifier, 12) != 0)
+    {
+        error = "not a KTX file";
+        return false;
+    }
+
+    const unsigned char* header = file.data() + 12;
+    if (ReadU32(header) != 0x04030201)
+    {
+        error = "big endian KTX files are not supported";
+        return false;
+    }
+
+    unsigned int glType = ReadU32(header + 4);
+    unsigned int glFormat = ReadU32(header + 12);
+    GLenum internalFormat = ReadU32(header + 16);
+    int width = (int)ReadU32(header + 24);
+    int height = (int)ReadU32(header + 28);
+    unsigned int depth = ReadU32(header + 32);
+    unsigned int arrayElements = ReadU32(header + 36);
+    unsigned int faces = ReadU32(header + 40);
+    unsigned int levels = ReadU32(header + 44);
+    unsigned int keyValueBytes = ReadU32(header + 48);
+    if (levels == 0)
+        levels = 1;
+
+    bool compressed = glType == 0 && Texture::IsCompressedFormat(internalFormat);
+    bool rgba8 = glType == GL_UNSIGNED_BYTE && glFormat == GL_RGBA && internalFormat == GL_RGBA8;
+    if ((!compressed && !rgba8) || depth > 1 || arrayElements > 0 || faces != 1 || width <= 0 || height <= 0)
+    {
+        error = "unsupported KTX (only 2D BC1 to BC7 or RGBA8)";
+        return false;
+    }
+    if (width > MaxSize || height > MaxSize)
+    {
+        error = "KTX too large";
+        return false;
+    }
+
+    if (levels > Texture::GetMipLevelCount(width, height))
+    {
+        error = "more KTX mip levels than the image has";
+        return false;
+    }
+
+    image.InternalFormat = internalFormat;
+    image.GenerateMipmaps = false;
+    image.Levels.clear();
+    image.Data.clear();
+
+    /* Each level is preceded by its size, and padded to 4 bytes, so we repack them tightly. */
+    size_t offset = 64 + keyValueBytes;
+    for (unsigned int level = 0; level < levels; level++)
+    {
+        if (offset + 4 > file.size())
+        {
+            error = "truncated KTX data";
+            return false;
+        }
+
+        unsigned int size = ReadU32(file.data() + offset);
+        offset += 4;
+
+        int levelWidth = width >> level > 0 ? width >> level : 1;
+        int levelHeight = height >> level > 0 ? height >> level : 1;
+        if (size != Texture::GetLevelSize(internalFormat, levelWidth, levelHeight) || offset + size > file.size())
+        {
+            error = "bad KTX level size";
+            return false;
+        }
+
+        image.Levels.push_back({ levelWidth, levelHeight, (unsigned int)image.Data.size(), size });
+        image.Data.insert(image.Data.end(), file.begin() + offset, file.begin() + offset + size);
+        offset += (size + 3) & ~3u;
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/* An image decoded into the layout OpenGL wants for upload. Decoding calls no OpenGL, */
+/* so it can run on any thread. */
+struct Image
+{
+    struct Level
+    {
+        int Width;
+        int Height;
+        unsigned int Offset; // Into Data
+        unsigned int Size;
+    };
+
+    std::vector<unsigned char> Data;
+    std::vector<Level> Levels;
+    GLenum InternalFormat = GL_NONE;
+
+    /* Uncompressed images come with level 0 only and want the rest generated on the GPU. */
+    bool GenerateMipmaps = false;
+};
+
+/* Decodes TGA (true color or grayscale, raw or RLE, converted to RGBA8), and reads DDS and KTX */
+/* (BC1 to BC7 with their mip levels) as they are, since the GPU samples those formats directly. */
+/* Rows are stored as in the file: TGA is flipped to OpenGL's bottom-up order, DDS and KTX are usually */
+/* top-down and can't be flipped without re-encoding, so those are sampled upside down. */
+class ImageDecoder
+{
+public:
+    /* Largest width and height accepted, like AssetPack::MaxTextureSize. Level sizes at this size */
+    /* still fit in 32 bits, so nothing computed from the header can overflow. */
+    static const int MaxSize = 16384;
+
+    /* Returns false and sets error if the file can't be read or its format is not supported. */
+    static bool Decode(const std::string& filepath, Image& image, std::string& error);
+
+private:
+    static bool DecodeTGA(const std::vector<unsigned char>& file, Image& image, std::string& error);
+    static bool DecodeDDS(const std::vector<unsigned char>& file, Image& image, std::string& error);
+    static bool DecodeKTX(const std::vector<unsigned char>& file, Image& image, std::string& error);
+};
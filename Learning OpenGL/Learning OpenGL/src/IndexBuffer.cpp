@@ -0,0 +1,89 @@
+#include "IndexBuffer.h"
+
+#include <vector>
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
+    : m_Count(count), m_Type(FitsShort(data, count) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+
+    if (m_Type == GL_UNSIGNED_SHORT)
+    {
+        std::vector<unsigned short> indices(data, data + count);
+        GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), indices.data(), GL_STATIC_DRAW));
+    }
+    else
+    {
+        GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
+    }
+    GpuMemory::Allocate(GpuMemory::Category::IndexBuffers, (uint64_t)count * GetIndexSize());
+}
+
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count)
+    : m_Count(count), m_Type(GL_UNSIGNED_SHORT)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), data, GL_STATIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::IndexBuffers, (uint64_t)count * GetIndexSize());
+}
+
+IndexBuffer::IndexBuffer(unsigned int count, unsigned int type)
+    : m_Count(count), m_Type(type)
+{
+    ASSERT(type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT);
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * GetIndexSize(), nullptr, GL_STATIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::IndexBuffers, (uint64_t)count * GetIndexSize());
+}
+
+IndexBuffer::~IndexBuffer()
+{
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::IndexBuffers, (uint64_t)m_Count * GetIndexSize());
+}
+
+void IndexBuffer::SetData(const unsigned int* data, unsigned int count, unsigned int first)
+{
+    ASSERT(first + count <= m_Count);
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+
+    if (m_Type == GL_UNSIGNED_SHORT)
+    {
+        ASSERT(FitsShort(data, count));
+        std::vector<unsigned short> indices(data, data + count);
+        GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(unsigned short), count * sizeof(unsigned short), indices.data()));
+    }
+    else
+    {
+        GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(unsigned int), count * sizeof(unsigned int), data));
+    }
+}
+
+void IndexBuffer::Bind() const
+{
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+}
+
+void IndexBuffer::Unbind() const
+{
+    StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+bool IndexBuffer::FitsShort(const unsigned int* data, unsigned int count)
+{
+    /* Primitive restart is never enabled, so 0xffff is an ordinary index. */
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (data[i] > 0xffff)
+            return false;
+    }
+    return true;
+}
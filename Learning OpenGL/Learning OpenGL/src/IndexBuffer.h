@@ -0,0 +1,41 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/* Indices are given as unsigned ints, but whenever every one of them fits in 16 bits the buffer */
+/* stores them as unsigned shorts, which halves its size and the index fetch of every draw. */
+/* Draw calls must therefore pass GetType() instead of GL_UNSIGNED_INT. */
+class IndexBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Count;
+    unsigned int m_Type; // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+
+public:
+    IndexBuffer(const unsigned int* data, unsigned int count);
+    IndexBuffer(const unsigned short* data, unsigned int count);
+
+    /* Creates an empty buffer with room for count indices of type, filled later through SetData. */
+    IndexBuffer(unsigned int count, unsigned int type = GL_UNSIGNED_INT);
+
+    ~IndexBuffer();
+
+    IndexBuffer(const IndexBuffer&) = delete;
+    IndexBuffer& operator=(const IndexBuffer&) = delete;
+
+    /* Replaces count indices starting at index first, converting them to the type of the buffer. */
+    /* The buffer is bound to GL_ELEMENT_ARRAY_BUFFER, which is state of the bound vertex array. */
+    void SetData(const unsigned int* data, unsigned int count, unsigned int first = 0);
+
+    void Bind() const;
+    void Unbind() const;
+
+    inline unsigned int GetCount() const { return m_Count; }
+    inline unsigned int GetType() const { return m_Type; }
+    inline unsigned int GetIndexSize() const { return m_Type == GL_UNSIGNED_SHORT ? 2 : 4; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+    /* True if every one of the count indices fits in an unsigned short. */
+    static bool FitsShort(const unsigned int* data, unsigned int count);
+};
@@ -0,0 +1,66 @@
+#include "IndirectCommandBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+IndirectCommandBuffer::IndirectCommandBuffer(unsigned int maxCommands, unsigned int firstInstance)
+    : m_MaxCommands(maxCommands), m_FirstInstance(firstInstance), m_InstanceCount(0)
+{
+    m_Commands.reserve(maxCommands);
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, maxCommands * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::IndirectBuffers, (uint64_t)maxCommands * sizeof(DrawElementsIndirectCommand));
+}
+
+IndirectCommandBuffer::~IndirectCommandBuffer()
+{
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::IndirectBuffers, (uint64_t)m_MaxCommands * sizeof(DrawElementsIndirectCommand));
+}
+
+void IndirectCommandBuffer::Clear()
+{
+    m_Commands.clear();
+    m_InstanceCount = 0;
+}
+
+unsigned int IndirectCommandBuffer::Add(const MeshPool::Mesh& mesh, unsigned int instanceCount)
+{
+    ASSERT(m_Commands.size() < m_MaxCommands);
+
+    DrawElementsIndirectCommand command;
+    command.Count = mesh.IndexCount;
+    command.InstanceCount = instanceCount;
+    command.FirstIndex = mesh.FirstIndex;
+    command.BaseVertex = mesh.BaseVertex;
+    command.BaseInstance = m_FirstInstance + m_InstanceCount;
+    m_Commands.push_back(command);
+
+    m_InstanceCount += instanceCount;
+    return command.BaseInstance;
+}
+
+void IndirectCommandBuffer::Upload()
+{
+    StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_Commands.size() * sizeof(DrawElementsIndirectCommand), m_Commands.data()));
+}
+
+void IndirectCommandBuffer::Bind() const
+{
+    StateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+}
+
+bool IndirectCommandBuffer::IsMultiDrawSupported()
+{
+    return GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+}
+
+bool IndirectCommandBuffer::IsSupported()
+{
+    return GLEW_VERSION_4_2 || GLEW_ARB_base_instance;
+}
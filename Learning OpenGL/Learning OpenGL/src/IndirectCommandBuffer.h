@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "MeshPool.h"
+
+/* The record glMultiDrawElementsIndirect reads for every draw, laid out exactly as OpenGL expects it. */
+struct DrawElementsIndirectCommand
+{
+    unsigned int Count;         // Number of indices
+    unsigned int InstanceCount;
+    unsigned int FirstIndex;    // In indices, not bytes
+    int BaseVertex;
+    unsigned int BaseInstance;  // Where the per-instance attributes of this draw start
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the layout OpenGL reads");
+
+/* A list of draws of meshes from a MeshPool, stored in a GL_DRAW_INDIRECT_BUFFER so the whole list */
+/* is submitted by Renderer::DrawIndirect with a single glMultiDrawElementsIndirect. */
+/*                                                                    */
+/* Every draw gets the next BaseInstance, so with a per-instance buffer added to the pool's vertex array */
+/* each draw reads its own transform, color, etc. That gives the vertex shader per-draw data without */
+/* needing gl_DrawID, which is only core in OpenGL 4.6. */
+class IndirectCommandBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_MaxCommands;
+    unsigned int m_FirstInstance;
+    unsigned int m_InstanceCount;
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+
+public:
+    /* firstInstance is the BaseInstance of the first draw, for several command buffers sharing one per-instance buffer. */
+    IndirectCommandBuffer(unsigned int maxCommands, unsigned int firstInstance = 0);
+    ~IndirectCommandBuffer();
+
+    IndirectCommandBuffer(const IndirectCommandBuffer&) = delete;
+    IndirectCommandBuffer& operator=(const IndirectCommandBuffer&) = delete;
+
+    void Clear();
+
+    /* Appends a draw of instanceCount copies of mesh. Returns the BaseInstance of the draw, */
+    /* i.e. the index of its first element in the per-instance buffers. */
+    unsigned int Add(const MeshPool::Mesh& mesh, unsigned int instanceCount = 1);
+
+    /* Copies the commands added since the last Clear to the GPU. Static scenes only do this once. */
+    void Upload();
+
+    void Bind() const;
+
+    inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+    inline unsigned int GetCommandCount() const { return (unsigned int)m_Commands.size(); }
+    inline unsigned int GetInstanceCount() const { return m_InstanceCount; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+    /* glMultiDrawElementsIndirect needs OpenGL 4.3 or GL_ARB_multi_draw_indirect. */
+    static bool IsMultiDrawSupported();
+
+    /* Drawing the commands one by one needs glDrawElementsInstancedBaseVertexBaseInstance, */
+    /* from OpenGL 4.2 or GL_ARB_base_instance. Without it per-draw data can't be addressed. */
+    static bool IsSupported();
+};
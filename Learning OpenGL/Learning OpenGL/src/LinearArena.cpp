@@ -0,0 +1,41 @@
+#include "LinearArena.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+/* Enough for the scratch data of a frame with room to spare, see GetPeak in the frame report. */
+static const size_t FrameArenaCapacity = 4 * 1024 * 1024;
+
+LinearArena::LinearArena(size_t capacity)
+    : m_Buffer((unsigned char*)malloc(capacity)), m_Capacity(capacity), m_Offset(0), m_Peak(0), m_Failures(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    free(m_Buffer);
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+    /* alignment is a power of two, so rounding up is a mask. It applies to the address, */
+    /* the buffer itself is only as aligned as malloc makes it. */
+    const uintptr_t base = (uintptr_t)m_Buffer;
+    size_t begin = (size_t)(((base + m_Offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+    if (!m_Buffer || begin + size > m_Capacity)
+    {
+        m_Failures++;
+        return nullptr;
+    }
+
+    m_Offset = begin + size;
+    if (m_Offset > m_Peak)
+        m_Peak = m_Offset;
+    return m_Buffer + begin;
+}
+
+LinearArena& LinearArena::GetFrameArena()
+{
+    static LinearArena arena(FrameArenaCapacity);
+    return arena;
+}
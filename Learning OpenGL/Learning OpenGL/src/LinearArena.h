@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/* A block of memory handed out front to back and released all at once. */
+/*                                                                    */
+/* Allocating is a pointer bump and freeing is free: Reset (or ResetTo a marker) just moves the offset back. */
+/* That makes it the right home for everything that only lives for one frame, like the scratch lists built */
+/* while recording or uploading, which would otherwise cost a heap allocation every frame. */
+/* Only trivially destructible data belongs here, since nothing is ever destroyed. */
+/* An arena is not thread safe; the frame arena belongs to the thread running the main loop. */
+class LinearArena
+{
+public:
+    typedef size_t Marker;
+
+private:
+    unsigned char* m_Buffer;
+    size_t m_Capacity;
+    size_t m_Offset;
+    size_t m_Peak;           // Largest offset since the last ResetPeak
+    unsigned int m_Failures; // Allocations that did not fit
+
+public:
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /* Returns null when the arena is full, the caller decides whether that is fatal. */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed");
+        return (T*)Allocate(count * sizeof(T), alignof(T));
+    }
+
+    /* Frees everything. */
+    inline void Reset() { m_Offset = 0; }
+
+    /* Frees everything allocated after the marker was taken. */
+    inline Marker GetMarker() const { return m_Offset; }
+    inline void ResetTo(Marker marker) { m_Offset = marker; }
+
+    inline size_t GetUsed() const { return m_Offset; }
+    inline size_t GetCapacity() const { return m_Capacity; }
+    inline size_t GetPeak() const { return m_Peak; }
+    inline unsigned int GetFailures() const { return m_Failures; }
+    inline void ResetPeak() { m_Peak = m_Offset; m_Failures = 0; }
+
+    /* Reset by the main loop at the start of every frame. Main thread only. */
+    static LinearArena& GetFrameArena();
+};
+
+/* Lets standard containers live in an arena, e.g. std::vector<int, ArenaAllocator<int>> list(ArenaAllocator<int>(arena)). */
+/* deallocate does nothing, so reserve up front: every reallocation leaves the old block behind until the reset. */
+template<typename T>
+class ArenaAllocator
+{
+private:
+    LinearArena* m_Arena;
+
+    template<typename U> friend class ArenaAllocator;
+
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(LinearArena& arena)
+        : m_Arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : m_Arena(other.m_Arena) {}
+
+    T* allocate(size_t count)
+    {
+        void* pointer = m_Arena->Allocate(count * sizeof(T), alignof(T));
+        if (!pointer)
+            throw std::bad_alloc();
+        return (T*)pointer;
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_Arena == other.m_Arena; }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_Arena != other.m_Arena; }
+};
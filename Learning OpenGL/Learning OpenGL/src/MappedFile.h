@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/* A whole file mapped read-only into the address space. Nothing is read up front: the OS pages the */
+/* file in as it is touched, straight from its file cache, so a pointer into the mapping can be handed */
+/* to glBufferData and the like without an intermediate copy. */
+class MappedFile
+{
+private:
+    const unsigned char* m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    void* m_File;    // HANDLE
+    void* m_Mapping; // HANDLE
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /* Maps filepath, closing whatever was mapped before. Returns false if the file can't be opened */
+    /* or is empty. */
+    bool Open(const std::string& filepath);
+    void Close();
+
+    inline bool IsOpen() const { return m_Data != nullptr; }
+    inline const unsigned char* GetData() const { return m_Data; }
+    inline size_t GetSize() const { return m_Size; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+/* The few bits of matrix math the renderer needs. Matrices are column-major, like OpenGL expects them. */
+struct Mat4
+{
+    float Elements[16];
+
+    static Mat4 Identity()
+    {
+        Mat4 result = {};
+        result.Elements[0] = result.Elements[5] = result.Elements[10] = result.Elements[15] = 1.0f;
+        return result;
+    }
+
+    static Mat4 Ortho(float left, float right, float bottom, float top, float zNear = -1.0f, float zFar = 1.0f)
+    {
+        Mat4 result = Identity();
+        result.Elements[0] = 2.0f / (right - left);
+        result.Elements[5] = 2.0f / (top - bottom);
+        result.Elements[10] = -2.0f / (zFar - zNear);
+        result.Elements[12] = -(right + left) / (right - left);
+        result.Elements[13] = -(top + bottom) / (top - bottom);
+        result.Elements[14] = -(zFar + zNear) / (zFar - zNear);
+        return result;
+    }
+
+    Mat4 operator*(const Mat4& other) const
+    {
+        Mat4 result;
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                float sum = 0.0f;
+                for (int i = 0; i < 4; i++)
+                    sum += Elements[i * 4 + row] * other.Elements[column * 4 + i];
+                result.Elements[column * 4 + row] = sum;
+            }
+        }
+        return result;
+    }
+};
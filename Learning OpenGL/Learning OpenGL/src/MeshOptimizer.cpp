@@ -0,0 +1,204 @@
+#include "MeshOptimizer.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Renderer.h"
+
+/* The cache size the scores are tuned for, a bit larger than the real cache works best. */
+static const int ScoreCacheSize = 32;
+
+/* The three vertices of the last triangle get a fixed score, so that the next triangle tends to */
+/* share an edge with it instead of only a vertex; older entries score less the older they are. */
+/* Vertices with few triangles left get a boost, which finishes off lone triangles before they */
+/* would need their vertices shaded again. */
+static float VertexScore(int cachePosition, unsigned int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = std::pow(1.0f - (float)(cachePosition - 3) / (ScoreCacheSize - 3), 1.5f);
+    }
+    return score + 2.0f / std::sqrt((float)remainingTriangles);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+    /* A vertex is in the FIFO if fewer than cacheSize misses happened since it was last added. */
+    std::vector<unsigned int> addedAt(vertexCount, 0);
+    unsigned int time = cacheSize + 1; // Every vertex starts out of the cache
+
+    CacheStats stats;
+    for (unsigned int i = 0; i < indexCount; i++)
+    {
+        const unsigned int vertex = indices[i];
+        ASSERT(vertex < vertexCount);
+        if (time - addedAt[vertex] > cacheSize)
+        {
+            addedAt[vertex] = time++;
+            stats.Misses++;
+        }
+    }
+
+    if (indexCount > 0)
+        stats.ACMR = (float)stats.Misses / (indexCount / 3);
+    if (vertexCount > 0)
+        stats.ATVR = (float)stats.Misses / vertexCount;
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount)
+{
+    const unsigned int triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    /* Adjacency: the triangles of vertex v are triangles[firstTriangle[v] .. firstTriangle[v] + remaining[v]). */
+    /* Emitted triangles are swapped to the end of the range, so the range always holds the ones left. */
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int i = 0; i < triangleCount * 3; i++)
+        remaining[indices[i]]++;
+
+    std::vector<unsigned int> firstTriangle(vertexCount, 0);
+    for (unsigned int v = 1; v < vertexCount; v++)
+        firstTriangle[v] = firstTriangle[v - 1] + remaining[v - 1];
+
+    std::vector<unsigned int> triangles(triangleCount * 3);
+    std::vector<unsigned int> filled(vertexCount, 0);
+    for (unsigned int t = 0; t < triangleCount; t++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            const unsigned int v = indices[t * 3 + c];
+            triangles[firstTriangle[v] + filled[v]++] = t;
+        }
+    }
+
+    std::vector<float> vertexScores(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; v++)
+        vertexScores[v] = VertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    for (unsigned int t = 0; t < triangleCount; t++)
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> output(triangleCount * 3);
+
+    /* The simulated LRU cache, with room for the 3 vertices that get pushed in front of it. */
+    unsigned int cache[ScoreCacheSize + 3];
+    unsigned int cacheCount = 0;
+
+    unsigned int scanCursor = 0; // Every triangle before it is emitted
+    int best = -1;
+    for (unsigned int emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        /* Nothing in the cache leads anywhere, so start over somewhere else. Every triangle left is now */
+        /* scored by the valence of its vertices alone, so the first one left is as good a start as any. */
+        if (best < 0)
+        {
+            while (emitted[scanCursor])
+                scanCursor++;
+            best = (int)scanCursor;
+        }
+
+        const unsigned int triangle = (unsigned int)best;
+        emitted[triangle] = true;
+        for (int c = 0; c < 3; c++)
+            output[emittedCount * 3 + c] = indices[triangle * 3 + c];
+
+        /* Push the vertices of the triangle to the front of the cache and drop the triangle from their lists. */
+        unsigned int newCache[ScoreCacheSize + 3];
+        unsigned int newCount = 0;
+        for (int c = 0; c < 3; c++)
+        {
+            const unsigned int v = indices[triangle * 3 + c];
+            newCache[newCount++] = v;
+
+            unsigned int* list = &triangles[firstTriangle[v]];
+            for (unsigned int i = 0; i < remaining[v]; i++)
+            {
+                if (list[i] == triangle)
+                {
+                    list[i] = list[remaining[v] - 1];
+                    list[remaining[v] - 1] = triangle;
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+        for (unsigned int i = 0; i < cacheCount; i++)
+        {
+            const unsigned int v = cache[i];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+                newCache[newCount++] = v;
+        }
+
+        /* Rescore every vertex that moved, including the ones that fell out, and their triangles. */
+        for (unsigned int i = 0; i < newCount; i++)
+        {
+            const unsigned int v = newCache[i];
+            const float score = VertexScore(i < (unsigned int)ScoreCacheSize ? (int)i : -1, remaining[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            const unsigned int* list = &triangles[firstTriangle[v]];
+            for (unsigned int j = 0; j < remaining[v]; j++)
+                triangleScores[list[j]] += delta;
+        }
+
+        cacheCount = newCount < (unsigned int)ScoreCacheSize ? newCount : ScoreCacheSize;
+        memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+        /* The next triangle is the best one that touches the cache. */
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int i = 0; i < cacheCount; i++)
+        {
+            const unsigned int v = cache[i];
+            const unsigned int* list = &triangles[firstTriangle[v]];
+            for (unsigned int j = 0; j < remaining[v]; j++)
+            {
+                if (triangleScores[list[j]] > bestScore)
+                {
+                    bestScore = triangleScores[list[j]];
+                    best = (int)list[j];
+                }
+            }
+        }
+    }
+
+    memcpy(indices, output.data(), triangleCount * 3 * sizeof(unsigned int));
+}
+
+unsigned int MeshOptimizer::OptimizeVertexFetch(void* vertices, unsigned int vertexSize, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount)
+{
+    const unsigned int unused = 0xffffffff;
+    std::vector<unsigned int> remap(vertexCount, unused);
+
+    unsigned int nextVertex = 0;
+    for (unsigned int i = 0; i < indexCount; i++)
+    {
+        unsigned int& newIndex = remap[indices[i]];
+        if (newIndex == unused)
+            newIndex = nextVertex++;
+        indices[i] = newIndex;
+    }
+
+    const unsigned char* source = (const unsigned char*)vertices;
+    std::vector<unsigned char> reordered((size_t)nextVertex * vertexSize);
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+        if (remap[v] != unused)
+            memcpy(&reordered[(size_t)remap[v] * vertexSize], source + (size_t)v * vertexSize, vertexSize);
+    }
+    memcpy(vertices, reordered.data(), reordered.size());
+    return nextVertex;
+}
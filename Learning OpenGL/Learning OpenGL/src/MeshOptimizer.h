@@ -0,0 +1,32 @@
+#pragma once
+
+/* Load-time reordering of indexed triangle meshes for the GPU's vertex caches. Neither step changes */
+/* what is drawn, only the order in which the GPU meets triangles and vertices: */
+/* - OptimizeVertexCache reorders triangles so that vertices shared between them are still in the */
+/*   post-transform cache when they come up again, and are not shaded twice (Tom Forsyth's */
+/*   "Linear-Speed Vertex Cache Optimisation"). */
+/* - OptimizeVertexFetch then renumbers vertices in the order the triangles first use them, so the vertex */
+/*   fetch walks the vertex buffer mostly forwards instead of jumping around in it. */
+/*                                                                    */
+/* The quality is measured as ACMR, the average number of cache misses (vertices shaded) per triangle. */
+/* It is 3 without any reuse and about 0.5 at best for a large regular grid. */
+class MeshOptimizer
+{
+public:
+    struct CacheStats
+    {
+        unsigned int Misses = 0;
+        float ACMR = 0.0f; // Misses per triangle
+        float ATVR = 0.0f; // Misses per vertex, 1 is ideal
+    };
+
+    /* Simulates a FIFO post-transform cache of cacheSize entries, roughly what current GPUs have. */
+    static CacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize = 16);
+
+    /* Reorders the triangles of indices in place. */
+    static void OptimizeVertexCache(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount);
+
+    /* Reorders the vertices (vertexSize bytes each) in place and rewrites indices to match. Vertices no */
+    /* triangle uses are dropped from the end; returns the number of vertices left. */
+    static unsigned int OptimizeVertexFetch(void* vertices, unsigned int vertexSize, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount);
+};
@@ -0,0 +1,40 @@
+#include "MeshPool.h"
+
+MeshPool::MeshPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices, unsigned int indexType)
+    : m_Layout(layout), m_MaxVertices(maxVertices), m_MaxIndices(maxIndices), m_IndexType(indexType), m_VertexCount(0), m_IndexCount(0)
+{
+    m_VertexArray.reset(new VertexArray());
+
+    m_VertexBuffer.reset(new VertexBuffer(maxVertices * layout.GetStride()));
+    m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+    /* The vertex array is still bound, so it picks up the index buffer. */
+    m_IndexBuffer.reset(new IndexBuffer(maxIndices, indexType));
+
+    m_VertexArray->Unbind();
+}
+
+int MeshPool::AddMesh(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+    if (m_VertexCount + vertexCount > m_MaxVertices || m_IndexCount + indexCount > m_MaxIndices)
+        return -1;
+    if (m_IndexType == GL_UNSIGNED_SHORT && !IndexBuffer::FitsShort(indices, indexCount))
+        return -1;
+
+    Mesh mesh;
+    mesh.FirstIndex = m_IndexCount;
+    mesh.IndexCount = indexCount;
+    mesh.BaseVertex = (int)m_VertexCount;
+
+    const unsigned int stride = m_Layout.GetStride();
+    m_VertexBuffer->SetData(vertices, vertexCount * stride, m_VertexCount * stride);
+
+    /* The index buffer binding belongs to the vertex array, so bind ours before touching it. */
+    m_VertexArray->Bind();
+    m_IndexBuffer->SetData(indices, indexCount, m_IndexCount);
+
+    m_VertexCount += vertexCount;
+    m_IndexCount += indexCount;
+    m_Meshes.push_back(mesh);
+    return (int)m_Meshes.size() - 1;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexBufferLayout.h"
+
+/* Packs many static meshes that share one vertex layout into a single vertex buffer and a single */
+/* index buffer, behind a single vertex array. A mesh is then just a range of indices plus the offset */
+/* of its first vertex, which is exactly what a DrawElementsIndirectCommand needs, so every mesh of the */
+/* pool can be drawn without touching any binding in between. */
+/*                                                                    */
+/* Both buffers are allocated once with their maximum size; meshes are appended and never removed. */
+/* Indices are relative to BaseVertex, so a pool of 16 bit indices only limits the size of each mesh, */
+/* not the size of the whole pool. */
+class MeshPool
+{
+public:
+    struct Mesh
+    {
+        unsigned int FirstIndex;
+        unsigned int IndexCount;
+        int BaseVertex; // Added to every index of the mesh, so its indices start at 0
+    };
+
+private:
+    VertexBufferLayout m_Layout;
+    unsigned int m_MaxVertices;
+    unsigned int m_MaxIndices;
+    unsigned int m_IndexType;
+    unsigned int m_VertexCount;
+    unsigned int m_IndexCount;
+
+    std::unique_ptr<VertexArray> m_VertexArray;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    std::vector<Mesh> m_Meshes;
+
+public:
+    /* indexType is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, see IndexBuffer. */
+    MeshPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices, unsigned int indexType = GL_UNSIGNED_INT);
+
+    /* Copies the mesh into the shared buffers. vertices must follow the layout given to the constructor */
+    /* and indices are relative to the first vertex of this mesh. Returns the id of the mesh, or -1 */
+    /* if the pool does not have room for it or its indices don't fit the index type. */
+    int AddMesh(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
+    inline const Mesh& GetMesh(int id) const { return m_Meshes[id]; }
+    inline unsigned int GetMeshCount() const { return (unsigned int)m_Meshes.size(); }
+
+    /* Per-draw data goes into extra buffers added here with VertexBufferLayout::PushInstanced, */
+    /* after the per-vertex attributes of the pool. */
+    inline VertexArray& GetVertexArray() { return *m_VertexArray; }
+    inline const VertexArray& GetVertexArray() const { return *m_VertexArray; }
+
+    inline unsigned int GetVertexCount() const { return m_VertexCount; }
+    inline unsigned int GetIndexCount() const { return m_IndexCount; }
+    inline unsigned int GetIndexType() const { return m_IndexType; }
+};
@@ -0,0 +1,136 @@
+#include "MeshQuantizer.h"
+
+#include <cmath>
+
+static short QuantizeSnorm16(float value)
+{
+    const float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    return (short)std::floor(clamped * 32767.0f + 0.5f);
+}
+
+static unsigned char QuantizeUnorm8(float value)
+{
+    const float clamped = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return (unsigned char)(clamped * 255.0f + 0.5f);
+}
+
+static float AngleBetween(const float* a, const float* b)
+{
+    const float lengths = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) * std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+    if (lengths == 0.0f)
+        return 0.0f;
+
+    float cosine = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / lengths;
+    cosine = cosine > 1.0f ? 1.0f : (cosine < -1.0f ? -1.0f : cosine);
+    return std::acos(cosine) * 57.2957795f;
+}
+
+MeshQuantizer::Result MeshQuantizer::Quantize(const MeshVertex* vertices, unsigned int count)
+{
+    Result result;
+    result.MaxPositionError = 0.0f;
+    result.MaxNormalError = 0.0f;
+
+    /* The bounding box tells us which range the shorts have to cover. */
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+    for (unsigned int i = 0; i < count; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            const float value = vertices[i].Position[c];
+            if (i == 0 || value < min[c])
+                min[c] = value;
+            if (i == 0 || value > max[c])
+                max[c] = value;
+        }
+    }
+    for (int c = 0; c < 3; c++)
+    {
+        result.PositionOffset[c] = (min[c] + max[c]) * 0.5f;
+        result.PositionScale[c] = (max[c] - min[c]) * 0.5f;
+        if (result.PositionScale[c] == 0.0f) // A flat mesh, any scale decodes to the offset
+            result.PositionScale[c] = 1.0f;
+    }
+
+    result.Vertices.resize(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const MeshVertex& source = vertices[i];
+        CompactVertex& vertex = result.Vertices[i];
+
+        for (int c = 0; c < 3; c++)
+            vertex.Position[c] = QuantizeSnorm16((source.Position[c] - result.PositionOffset[c]) / result.PositionScale[c]);
+        vertex.Position[3] = 0;
+
+        vertex.Normal = PackedNormal::FromFloats(source.Normal[0], source.Normal[1], source.Normal[2]);
+        vertex.Tangent = PackedNormal::FromFloats(source.Tangent[0], source.Tangent[1], source.Tangent[2], source.Tangent[3] < 0.0f ? -1.0f : 1.0f);
+        vertex.TexCoords[0] = Half::FromFloat(source.TexCoords[0]);
+        vertex.TexCoords[1] = Half::FromFloat(source.TexCoords[1]);
+        for (int c = 0; c < 4; c++)
+            vertex.Color[c] = QuantizeUnorm8(source.Color[c]);
+
+        /* Measure what the GPU will actually see, so the import can tell if a mesh loses too much. */
+        const MeshVertex decoded = Decode(vertex, result.PositionScale, result.PositionOffset);
+        float distance = 0.0f;
+        for (int c = 0; c < 3; c++)
+        {
+            const float delta = decoded.Position[c] - source.Position[c];
+            distance += delta * delta;
+        }
+        distance = std::sqrt(distance);
+        if (distance > result.MaxPositionError)
+            result.MaxPositionError = distance;
+
+        const float angle = AngleBetween(decoded.Normal, source.Normal);
+        if (angle > result.MaxNormalError)
+            result.MaxNormalError = angle;
+    }
+    return result;
+}
+
+MeshVertex MeshQuantizer::Decode(const CompactVertex& vertex, const float* positionScale, const float* positionOffset)
+{
+    MeshVertex decoded;
+    for (int c = 0; c < 3; c++)
+    {
+        /* Same as the GL rule for normalized signed integers: max(value / 32767, -1). */
+        float value = vertex.Position[c] / 32767.0f;
+        value = value < -1.0f ? -1.0f : value;
+        decoded.Position[c] = value * positionScale[c] + positionOffset[c];
+    }
+
+    float normal[4];
+    vertex.Normal.ToFloats(normal);
+    for (int c = 0; c < 3; c++)
+        decoded.Normal[c] = normal[c];
+    vertex.Tangent.ToFloats(decoded.Tangent);
+
+    decoded.TexCoords[0] = vertex.TexCoords[0].ToFloat();
+    decoded.TexCoords[1] = vertex.TexCoords[1].ToFloat();
+    for (int c = 0; c < 4; c++)
+        decoded.Color[c] = vertex.Color[c] / 255.0f;
+    return decoded;
+}
+
+VertexBufferLayout MeshQuantizer::GetSourceLayout()
+{
+    VertexBufferLayout layout;
+    layout.Push<float>(3); // Position
+    layout.Push<float>(3); // Normal
+    layout.Push<float>(4); // Tangent
+    layout.Push<float>(2); // Texture coordinates
+    layout.Push<float>(4); // Color
+    return layout;
+}
+
+VertexBufferLayout MeshQuantizer::GetCompactLayout()
+{
+    VertexBufferLayout layout;
+    layout.Push<short>(4);          // Position, w is padding and ignored by the vec3 input
+    layout.Push<PackedNormal>(4);   // Normal
+    layout.Push<PackedNormal>(4);   // Tangent
+    layout.Push<Half>(2);           // Texture coordinates
+    layout.Push<unsigned char>(4);  // Color
+    return layout;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include "VertexFormats.h"
+#include "VertexBufferLayout.h"
+
+/* A mesh vertex the way an importer produces it: everything in full floats, 64 bytes. */
+struct MeshVertex
+{
+    float Position[3];
+    float Normal[3];
+    float Tangent[4]; // xyz = tangent, w = +1 or -1, the handedness of the bitangent
+    float TexCoords[2];
+    float Color[4];
+};
+
+/* The same vertex in 24 bytes, see MeshQuantizer. */
+struct CompactVertex
+{
+    short Position[4];      // snorm16 inside the bounds of the mesh, w is padding
+    PackedNormal Normal;    // snorm 10_10_10
+    PackedNormal Tangent;   // snorm 10_10_10, the handedness in the 2 bit w
+    Half TexCoords[2];
+    unsigned char Color[4]; // unorm8
+};
+
+static_assert(sizeof(MeshVertex) == 64, "MeshVertex must stay tightly packed");
+static_assert(sizeof(CompactVertex) == 24, "CompactVertex must stay tightly packed");
+
+/* Turns imported MeshVertex data into CompactVertex data, which cuts vertex fetch bandwidth and VRAM */
+/* to 3/8 without a visible change: */
+/* - positions are mapped to [-1, 1] inside the bounding box and stored as normalized shorts. That is */
+/*   a step of 1/65535 of the mesh size, far finer than halves (1/2048 of the value) for the same size; */
+/*   the shader undoes the mapping with u_PositionScale and u_PositionOffset. */
+/* - normals and tangents are unit vectors, 10 bits per component is below what lighting can show. */
+/* - texture coordinates can leave [0, 1] when they tile, so they are halves rather than normalized. */
+/* - colors are 8 bits per channel, which is all the framebuffer has anyway. */
+/*                                                                    */
+/* The shader declares the same vec3/vec4 inputs for both formats, so one shader draws either. */
+class MeshQuantizer
+{
+public:
+    struct Result
+    {
+        std::vector<CompactVertex> Vertices;
+        float PositionScale[3];    // position = a_Position * scale + offset
+        float PositionOffset[3];
+        float MaxPositionError;    // The largest distance between an original and a decoded position
+        float MaxNormalError;      // In degrees
+    };
+
+    static Result Quantize(const MeshVertex* vertices, unsigned int count);
+
+    /* Decodes one vertex back to floats, which is what the GPU reads from it. */
+    static MeshVertex Decode(const CompactVertex& vertex, const float* positionScale, const float* positionOffset);
+
+    /* Both layouts give the same attribute locations: 0 position, 1 normal, 2 tangent, 3 texture coordinates, 4 color. */
+    static VertexBufferLayout GetSourceLayout();
+    static VertexBufferLayout GetCompactLayout();
+};
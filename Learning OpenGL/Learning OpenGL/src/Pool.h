@@ -0,0 +1,92 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Renderer.h"
+
+/* Fixed-size storage for many objects of one type that come and go, like meshes, materials or requests. */
+/*                                                                    */
+/* Objects are constructed in blocks of slots that are allocated once and never released until the pool is, */
+/* and a freed slot goes onto a free list for the next Create. Once the pool has grown to the peak number of */
+/* live objects, creating and destroying them never touches the heap, and objects never move. */
+/* Not thread safe. Every object must be destroyed before the pool is. */
+template<typename T>
+class Pool
+{
+private:
+    union Slot
+    {
+        Slot* Next; // While free
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_Blocks;
+    Slot* m_Free;
+    unsigned int m_BlockSize;
+    unsigned int m_Live;
+    unsigned int m_Peak;
+
+public:
+    /* Reserving enough slots (reservedSlots) up front keeps even the first frames free of allocations. */
+    explicit Pool(unsigned int blockSize = 64, unsigned int reservedSlots = 0)
+        : m_Free(nullptr), m_BlockSize(blockSize), m_Live(0), m_Peak(0)
+    {
+        for (unsigned int reserved = 0; reserved < reservedSlots; reserved += blockSize)
+            Grow();
+    }
+
+    ~Pool()
+    {
+        ASSERT(m_Live == 0); // Destroying the slots would leak whatever the live objects own
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args)
+    {
+        if (!m_Free)
+            Grow();
+
+        Slot* slot = m_Free;
+        m_Free = slot->Next;
+        T* object = new (&slot->Storage) T(std::forward<Args>(args)...);
+
+        m_Live++;
+        if (m_Live > m_Peak)
+            m_Peak = m_Live;
+        return object;
+    }
+
+    void Destroy(T* object)
+    {
+        if (!object)
+            return;
+
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->Next = m_Free;
+        m_Free = slot;
+        m_Live--;
+    }
+
+    inline unsigned int GetLiveCount() const { return m_Live; }
+    inline unsigned int GetPeakCount() const { return m_Peak; }
+    inline unsigned int GetCapacity() const { return (unsigned int)m_Blocks.size() * m_BlockSize; }
+
+private:
+    void Grow()
+    {
+        Slot* block = new Slot[m_BlockSize];
+        m_Blocks.emplace_back(block);
+        for (unsigned int i = m_BlockSize; i > 0; i--)
+        {
+            block[i - 1].Next = m_Free;
+            m_Free = &block[i - 1];
+        }
+    }
+};
@@ -0,0 +1,325 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "Renderer.h"
+
+namespace {
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    static const unsigned int FrameLatency = 2; // Frames between recording a scope and reading its GPU time
+    static const double AverageWeight = 0.05;  // Weight of the newest frame in the rolling averages
+
+    struct ScopeRecord
+    {
+        const char* Name;
+        unsigned int Depth;
+        double CpuBegin, CpuEnd; // Microseconds since Init
+        unsigned int QueryBegin, QueryEnd;
+    };
+
+    struct FrameRecord
+    {
+        std::vector<ScopeRecord> Scopes;
+        std::vector<unsigned int> Queries; // Pool of timestamp queries, grows as needed
+        unsigned int QueriesUsed = 0;
+        unsigned int LastQuery = 0; // Queries complete in order, so when this one is available all of them are
+        bool Pending = false;
+    };
+
+    struct ScopeStats
+    {
+        double CpuMilliseconds = 0.0;
+        double GpuMilliseconds = 0.0;
+        unsigned int Depth = 0;
+        unsigned int Order = 0; // Order of first appearance, so the summary reads like the frame
+        bool HasGpu = false;
+    };
+
+    struct CounterStats
+    {
+        double Value = 0.0;
+        unsigned int Order = 0;
+    };
+
+    struct TraceEvent
+    {
+        const char* Name;
+        bool Gpu;
+        double Begin; // Microseconds since Init
+        double Duration;
+    };
+
+    struct CounterEvent
+    {
+        const char* Name;
+        double Time; // Microseconds since Init
+        double Value;
+    };
+
+    Clock::time_point s_Start;
+    long long s_GpuOffset = 0; // GPU timestamp (ns) that corresponds to s_Start
+
+    FrameRecord s_Frames[FrameLatency];
+    unsigned int s_Frame = 0;
+    unsigned int s_Depth = 0;
+    bool s_InFrame = false;
+
+    /* Keyed by the address of the name: names are literals, and hashing a pointer never allocates, */
+    /* where building a std::string key for every scope of every frame would. */
+    std::unordered_map<const char*, ScopeStats> s_Stats;
+    std::unordered_map<const char*, CounterStats> s_Counters;
+    unsigned int s_DroppedFrames = 0;
+
+    bool s_Tracing = false;
+    std::vector<TraceEvent> s_Trace;
+    std::vector<CounterEvent> s_CounterTrace;
+
+    double Now()
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() - s_Start).count();
+    }
+
+    unsigned int AcquireQuery(FrameRecord& frame)
+    {
+        if (frame.QueriesUsed == frame.Queries.size())
+        {
+            unsigned int query;
+            GLCall(glGenQueries(1, &query));
+            frame.Queries.push_back(query);
+        }
+        return frame.Queries[frame.QueriesUsed++];
+    }
+
+    void Accumulate(double& average, double value)
+    {
+        average = average == 0.0 ? value : average + (value - average) * AverageWeight;
+    }
+
+    /* Reads the GPU results of a frame recorded FrameLatency frames ago, if they are ready. */
+    void Resolve(FrameRecord& frame)
+    {
+        if (!frame.Pending)
+            return;
+        frame.Pending = false;
+
+        bool available = false;
+        if (frame.LastQuery)
+        {
+            int result = GL_FALSE;
+            GLCall(glGetQueryObjectiv(frame.LastQuery, GL_QUERY_RESULT_AVAILABLE, &result));
+            available = result == GL_TRUE;
+            if (!available)
+                s_DroppedFrames++;
+        }
+
+        for (const ScopeRecord& scope : frame.Scopes)
+        {
+            auto inserted = s_Stats.emplace(scope.Name, ScopeStats());
+            ScopeStats& stats = inserted.first->second;
+            if (inserted.second)
+                stats.Order = (unsigned int)s_Stats.size();
+            stats.Depth = scope.Depth;
+            Accumulate(stats.CpuMilliseconds, (scope.CpuEnd - scope.CpuBegin) / 1000.0);
+
+            if (s_Tracing)
+                s_Trace.push_back({ scope.Name, false, scope.CpuBegin, scope.CpuEnd - scope.CpuBegin });
+
+            if (!available)
+                continue;
+
+            GLuint64 begin = 0, end = 0;
+            GLCall(glGetQueryObjectui64v(scope.QueryBegin, GL_QUERY_RESULT, &begin));
+            GLCall(glGetQueryObjectui64v(scope.QueryEnd, GL_QUERY_RESULT, &end));
+            stats.HasGpu = true;
+            Accumulate(stats.GpuMilliseconds, (end - begin) / 1000000.0);
+
+            if (s_Tracing)
+                s_Trace.push_back({ scope.Name, true, ((long long)begin - s_GpuOffset) / 1000.0, (end - begin) / 1000.0 });
+        }
+
+        frame.Scopes.clear();
+        frame.QueriesUsed = 0;
+        frame.LastQuery = 0;
+    }
+
+}
+
+void Profiler::Init()
+{
+    /* Reading GL_TIMESTAMP directly waits for the GPU, which is fine once at startup. */
+    /* It lets us put GPU scopes on the same timeline as the CPU ones in the trace. */
+    GLint64 gpuNow = 0;
+    GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuNow));
+    s_Start = Clock::now();
+    s_GpuOffset = gpuNow;
+}
+
+void Profiler::Shutdown()
+{
+    for (FrameRecord& frame : s_Frames)
+    {
+        if (!frame.Queries.empty())
+        {
+            GLCall(glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data()));
+        }
+        frame = FrameRecord();
+    }
+}
+
+void Profiler::BeginFrame()
+{
+    s_Frame = (s_Frame + 1) % FrameLatency;
+    Resolve(s_Frames[s_Frame]);
+    s_InFrame = true;
+    s_Depth = 0;
+}
+
+void Profiler::EndFrame()
+{
+    s_Frames[s_Frame].Pending = true;
+    s_InFrame = false;
+}
+
+unsigned int Profiler::BeginScope(const char* name)
+{
+    if (!s_InFrame)
+        return ~0u;
+
+    FrameRecord& frame = s_Frames[s_Frame];
+    ScopeRecord scope;
+    scope.Name = name;
+    scope.Depth = s_Depth++;
+    scope.QueryBegin = AcquireQuery(frame);
+    scope.QueryEnd = AcquireQuery(frame);
+    GLCall(glQueryCounter(scope.QueryBegin, GL_TIMESTAMP));
+    scope.CpuBegin = Now();
+    scope.CpuEnd = scope.CpuBegin;
+
+    frame.Scopes.push_back(scope);
+    return (unsigned int)frame.Scopes.size() - 1;
+}
+
+void Profiler::EndScope(unsigned int index)
+{
+    if (index == ~0u || !s_InFrame)
+        return;
+
+    FrameRecord& frame = s_Frames[s_Frame];
+    ScopeRecord& scope = frame.Scopes[index];
+    scope.CpuEnd = Now();
+    GLCall(glQueryCounter(scope.QueryEnd, GL_TIMESTAMP));
+    frame.LastQuery = scope.QueryEnd;
+    s_Depth--;
+}
+
+void Profiler::SetCounter(const char* name, double value)
+{
+    /* find first, emplace builds its node before it knows whether the key is new. */
+    auto found = s_Counters.find(name);
+    if (found == s_Counters.end())
+    {
+        CounterStats& stats = s_Counters[name];
+        stats.Order = (unsigned int)s_Counters.size();
+        stats.Value = value;
+    }
+    else
+    {
+        /* Not Accumulate, a counter that is really 0 would restart its average every frame. */
+        found->second.Value += (value - found->second.Value) * AverageWeight;
+    }
+
+    if (s_Tracing)
+        s_CounterTrace.push_back({ name, Now(), value });
+}
+
+void Profiler::PrintSummary(std::ostream& out)
+{
+    std::vector<std::pair<const char*, const ScopeStats*>> sorted;
+    for (const auto& entry : s_Stats)
+        sorted.push_back({ entry.first, &entry.second });
+
+    /* Insertion sort, there are only a handful of scopes. */
+    for (size_t i = 1; i < sorted.size(); i++)
+    {
+        for (size_t j = i; j > 0 && sorted[j].second->Order < sorted[j - 1].second->Order; j--)
+            std::swap(sorted[j], sorted[j - 1]);
+    }
+
+    char line[160];
+    for (const auto& entry : sorted)
+    {
+        const ScopeStats& stats = *entry.second;
+        std::string name = std::string(stats.Depth * 2, ' ') + entry.first;
+        if (stats.HasGpu)
+            snprintf(line, sizeof(line), "%-32s CPU %7.3f ms | GPU %7.3f ms", name.c_str(), stats.CpuMilliseconds, stats.GpuMilliseconds);
+        else
+            snprintf(line, sizeof(line), "%-32s CPU %7.3f ms | GPU     n/a", name.c_str(), stats.CpuMilliseconds);
+        out << line << std::endl;
+    }
+
+    std::vector<std::pair<const char*, const CounterStats*>> counters;
+    for (const auto& entry : s_Counters)
+        counters.push_back({ entry.first, &entry.second });
+    for (size_t i = 1; i < counters.size(); i++)
+    {
+        for (size_t j = i; j > 0 && counters[j].second->Order < counters[j - 1].second->Order; j--)
+            std::swap(counters[j], counters[j - 1]);
+    }
+    for (const auto& entry : counters)
+    {
+        snprintf(line, sizeof(line), "%-32s %11.1f", entry.first, entry.second->Value);
+        out << line << std::endl;
+    }
+
+    if (s_DroppedFrames)
+    {
+        out << "(" << s_DroppedFrames << " frames of GPU results were not ready in time and were skipped)" << std::endl;
+        s_DroppedFrames = 0;
+    }
+}
+
+void Profiler::StartTrace()
+{
+    s_Trace.clear();
+    s_Trace.reserve(64 * 1024); // So recording doesn't reallocate every few seconds, at least in short traces
+    s_CounterTrace.clear();
+    s_CounterTrace.reserve(16 * 1024);
+    s_Tracing = true;
+}
+
+bool Profiler::StopTrace(const std::string& filepath)
+{
+    s_Tracing = false;
+
+    FILE* file = fopen(filepath.c_str(), "w");
+    if (!file)
+        return false;
+
+    /* The Trace Event Format: complete ("X") events with microsecond timestamps. */
+    /* CPU scopes go on thread 1 and GPU scopes on thread 2 of the same process. */
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    for (const TraceEvent& event : s_Trace)
+    {
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+            event.Name, event.Gpu ? "gpu" : "cpu", event.Begin, event.Duration, event.Gpu ? 2 : 1);
+    }
+    /* Counters are drawn as graphs above the threads. */
+    for (const CounterEvent& event : s_CounterTrace)
+    {
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%.3f}}",
+            event.Name, event.Time, event.Value);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    s_Trace.clear();
+    s_CounterTrace.clear();
+    return true;
+}
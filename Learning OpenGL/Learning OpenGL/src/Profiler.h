@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+/* Profiling can be compiled out entirely from the project settings with PROFILING=0. */
+#ifndef PROFILING
+    #define PROFILING 1
+#endif
+
+#if PROFILING
+    #define PROFILE_CONCAT_INNER(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+    #define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+    #define PROFILE_COUNTER(name, value) Profiler::SetCounter(name, (double)(value))
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_COUNTER(name, value)
+#endif
+
+/* Measures CPU and GPU time of named scopes. */
+/*                                                                    */
+/* CPU time comes from std::chrono::high_resolution_clock. GPU time comes from a pair of */
+/* glQueryCounter(GL_TIMESTAMP) queries around each scope, which, unlike GL_TIME_ELAPSED, can nest. */
+/* The queries are double-buffered by frame: the results of a frame are only read two frames later, */
+/* and only if GL_QUERY_RESULT_AVAILABLE says so, so reading them never stalls the pipeline. */
+/* A frame whose results are still not available is dropped from the statistics instead of waited for. */
+/* Counters are per-frame numbers (objects drawn, culled, ...) averaged and printed alongside the scopes. */
+class Profiler
+{
+public:
+    /* Must be called with a current context, before the first frame. */
+    static void Init();
+    static void Shutdown();
+
+    static void BeginFrame();
+    static void EndFrame();
+
+    /* Use PROFILE_SCOPE instead of calling these directly. name must outlive the frame (a literal), */
+    /* and scopes are told apart by the address of their name, not its text. */
+    static unsigned int BeginScope(const char* name);
+    static void EndScope(unsigned int scope);
+
+    /* Use PROFILE_COUNTER. Records this frame's value of a counter, named like a scope. Render thread only. */
+    static void SetCounter(const char* name, double value);
+
+    /* Average CPU and GPU milliseconds of every scope, and the average of every counter, over the last second or so. */
+    static void PrintSummary(std::ostream& out);
+
+    /* Records every scope until StopTrace, which writes them as a Chrome trace */
+    /* (open it in chrome://tracing or https://ui.perfetto.dev). */
+    static void StartTrace();
+    static bool StopTrace(const std::string& filepath);
+};
+
+class ProfileScope
+{
+private:
+    unsigned int m_Scope;
+
+public:
+    ProfileScope(const char* name)
+        : m_Scope(Profiler::BeginScope(name)) {}
+
+    ~ProfileScope()
+    {
+        Profiler::EndScope(m_Scope);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
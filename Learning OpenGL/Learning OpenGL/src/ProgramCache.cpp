@@ -0,0 +1,163 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "Renderer.h"
+#include "FileSystem.h"
+
+std::string ProgramCache::s_Directory = "cache/shaders";
+
+/* Every cache file starts with this header, followed by the binary itself. */
+struct ProgramCacheHeader
+{
+    uint32_t Magic;   // 'LOPB'
+    uint32_t Format;  // The GLenum binaryFormat returned by glGetProgramBinary
+    uint32_t Length;  // Size of the binary in bytes
+    uint32_t Reserved;
+    uint64_t Key;     // Guards against hash collisions in the file name
+};
+
+static const uint32_t ProgramCacheMagic = 0x42504f4c;
+
+static uint64_t HashBytes(uint64_t hash, const char* data, size_t size)
+{
+    /* 64 bit FNV-1a, good enough to tell shader sources apart. */
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t HashString(uint64_t hash, const char* string)
+{
+    if (!string)
+        string = "";
+    /* The terminator is hashed as well so "ab" + "c" and "a" + "bc" differ. */
+    size_t size = 0;
+    while (string[size])
+        size++;
+    return HashBytes(hash, string, size + 1);
+}
+
+void ProgramCache::SetDirectory(const std::string& directory)
+{
+    s_Directory = directory;
+}
+
+bool ProgramCache::IsSupported()
+{
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+        return false;
+
+    int formats = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    return formats > 0;
+}
+
+uint64_t ProgramCache::ComputeKey(const ShaderProgramSource& source)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashString(hash, source.VertexSource.c_str());
+    hash = HashString(hash, source.FragmentSource.c_str());
+    hash = HashString(hash, source.ComputeSource.c_str());
+    hash = HashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = HashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = HashString(hash, (const char*)glGetString(GL_VERSION));
+    return hash;
+}
+
+std::string ProgramCache::GetPath(uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return s_Directory + "/" + name;
+}
+
+void ProgramCache::PrepareForLink(unsigned int program)
+{
+    if (IsSupported())
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+}
+
+unsigned int ProgramCache::Load(const ShaderProgramSource& source)
+{
+    if (!IsSupported())
+        return 0;
+
+    uint64_t key = ComputeKey(source);
+    std::string path = GetPath(key);
+
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return 0;
+
+    ProgramCacheHeader header;
+    if (!stream.read((char*)&header, sizeof(header)) || header.Magic != ProgramCacheMagic || header.Key != key)
+        return 0;
+
+    std::vector<char> binary(header.Length);
+    if (!stream.read(binary.data(), binary.size()))
+        return 0;
+    stream.close();
+
+    /* The driver may reject the binary (e.g. the format is no longer supported), which raises */
+    /* GL_INVALID_ENUM or leaves the program unlinked. That is an expected outcome here, not a bug, */
+    /* so this call deliberately bypasses GLCall and clears the error afterwards. */
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.Format, binary.data(), header.Length);
+    GLClearErrors();
+
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+    {
+        std::cout << "Shader cache: binary " << path << " rejected by the driver, recompiling" << std::endl;
+        GLCall(glDeleteProgram(program));
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    return program;
+}
+
+void ProgramCache::Store(unsigned int program, const ShaderProgramSource& source)
+{
+    if (!IsSupported())
+        return;
+
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+        return;
+
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+
+    ProgramCacheHeader header;
+    header.Magic = ProgramCacheMagic;
+    header.Format = format;
+    header.Length = (uint32_t)length;
+    header.Reserved = 0;
+    header.Key = ComputeKey(source);
+
+    FileSystem::MakeDirectories(s_Directory);
+    std::ofstream stream(GetPath(header.Key), std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return;
+
+    stream.write((const char*)&header, sizeof(header));
+    stream.write(binary.data(), length);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Shader.h"
+
+/* On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary). */
+/*                                                                    */
+/* Entries are keyed by a hash of the parsed sources plus the GL vendor, renderer and version strings, */
+/* so a driver update or a different GPU never even tries to load a stale binary. The driver is still */
+/* allowed to reject a binary, in which case Load returns 0 and the caller compiles from source again. */
+class ProgramCache
+{
+private:
+    static std::string s_Directory;
+
+public:
+    /* Defaults to "cache/shaders", relative to the working directory. */
+    static void SetDirectory(const std::string& directory);
+
+    /* True when the context supports program binaries in at least one format. */
+    static bool IsSupported();
+
+    /* Returns a linked program created from the cached binary, or 0 on a cache miss or rejected binary. */
+    static unsigned int Load(const ShaderProgramSource& source);
+
+    /* Saves the binary of a linked program. The program should have been linked with */
+    /* GL_PROGRAM_BINARY_RETRIEVABLE_HINT set, see PrepareForLink. */
+    static void Store(unsigned int program, const ShaderProgramSource& source);
+
+    /* Must be called before glLinkProgram for the driver to keep the binary around. */
+    static void PrepareForLink(unsigned int program);
+
+    static uint64_t ComputeKey(const ShaderProgramSource& source);
+
+private:
+    static std::string GetPath(uint64_t key);
+};
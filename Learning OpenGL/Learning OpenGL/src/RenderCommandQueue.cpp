@@ -0,0 +1,331 @@
+#include "RenderCommandQueue.h"
+#include "Renderer.h"
+#include "StateCache.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+RenderCommandBuffer::RenderCommandBuffer(unsigned int maxDraws, unsigned int maxUniforms, unsigned int maxValues)
+    : m_Draws(maxDraws), m_Uniforms(maxUniforms), m_Values(maxValues),
+      m_DrawCount(0), m_UniformCount(0), m_ValueCount(0), m_Dropped(0), m_Recording(false)
+{
+}
+
+void RenderCommandBuffer::Reset()
+{
+    m_DrawCount = m_UniformCount = m_ValueCount = m_Dropped = 0;
+    m_Recording = false;
+}
+
+bool RenderCommandBuffer::Draw(uint64_t key, const Shader& shader, unsigned int material, const VertexArray& va, const IndexBuffer& ib,
+    unsigned int instanceCount)
+{
+    if (m_DrawCount == m_Draws.size())
+    {
+        m_Dropped++;
+        m_Recording = false;
+        return false;
+    }
+
+    DrawCommand& draw = m_Draws[m_DrawCount++];
+    draw.Key = key;
+    draw.Program = shader.GetRendererID();
+    draw.VertexArray = va.GetRendererID();
+    draw.IndexBuffer = ib.GetRendererID();
+    draw.IndexCount = ib.GetCount();
+    draw.IndexType = ib.GetType();
+    draw.InstanceCount = instanceCount;
+    draw.Material = material;
+    draw.FirstUniform = m_UniformCount;
+    draw.UniformCount = 0;
+    m_Recording = true;
+    return true;
+}
+
+float* RenderCommandBuffer::AddUniform(int location, UniformType type, unsigned int valueCount)
+{
+    if (!m_Recording)
+        return nullptr;
+
+    /* A draw missing some of its uniforms would draw garbage, so it is taken back entirely. */
+    if (m_UniformCount == m_Uniforms.size() || m_ValueCount + valueCount > m_Values.size())
+    {
+        DrawCommand& draw = m_Draws[--m_DrawCount];
+        if (draw.UniformCount > 0)
+            m_ValueCount = m_Uniforms[draw.FirstUniform].Offset;
+        m_UniformCount = draw.FirstUniform;
+        m_Dropped++;
+        m_Recording = false;
+        return nullptr;
+    }
+
+    Uniform& uniform = m_Uniforms[m_UniformCount++];
+    uniform.Location = location;
+    uniform.Type = type;
+    uniform.Offset = m_ValueCount;
+    m_Draws[m_DrawCount - 1].UniformCount++;
+
+    float* values = &m_Values[m_ValueCount];
+    m_ValueCount += valueCount;
+    return values;
+}
+
+void RenderCommandBuffer::SetUniform1i(int location, int value)
+{
+    if (float* values = AddUniform(location, UniformType::Int, 1))
+        memcpy(values, &value, sizeof(int));
+}
+
+void RenderCommandBuffer::SetUniform1f(int location, float value)
+{
+    if (float* values = AddUniform(location, UniformType::Float, 1))
+        values[0] = value;
+}
+
+void RenderCommandBuffer::SetUniform4f(int location, float v0, float v1, float v2, float v3)
+{
+    if (float* values = AddUniform(location, UniformType::Float4, 4))
+    {
+        values[0] = v0;
+        values[1] = v1;
+        values[2] = v2;
+        values[3] = v3;
+    }
+}
+
+void RenderCommandBuffer::SetUniformMat4f(int location, const float* matrix)
+{
+    if (float* values = AddUniform(location, UniformType::Mat4, 16))
+        memcpy(values, matrix, 16 * sizeof(float));
+}
+
+const unsigned int RenderCommandQueue::MaxPasses;
+const unsigned int RenderCommandQueue::MaxMaterials;
+
+RenderCommandQueue::RenderCommandQueue(unsigned int bufferCount, unsigned int maxDrawsPerBuffer,
+    unsigned int maxUniformsPerBuffer, unsigned int maxValuesPerBuffer)
+{
+    m_Buffers.reserve(bufferCount);
+    for (unsigned int i = 0; i < bufferCount; i++)
+        m_Buffers.emplace_back(maxDrawsPerBuffer, maxUniformsPerBuffer, maxValuesPerBuffer);
+    m_Sorted.reserve(bufferCount * maxDrawsPerBuffer);
+    m_SortScratch.reserve(bufferCount * maxDrawsPerBuffer);
+    m_Materials.push_back(Material());
+}
+
+unsigned int RenderCommandQueue::AddMaterial(const Material& material)
+{
+    ASSERT(m_Materials.size() < MaxMaterials);
+    m_Materials.push_back(material);
+    return (unsigned int)m_Materials.size() - 1;
+}
+
+void RenderCommandQueue::SetMaterial(unsigned int index, const Material& material)
+{
+    ASSERT(m_Materials[index].IsTranslucent() == material.IsTranslucent());
+    m_Materials[index] = material;
+}
+
+uint64_t RenderCommandQueue::MakeKey(unsigned int pass, const Shader& shader, unsigned int material, float depth) const
+{
+    ASSERT(pass < MaxPasses && material < m_Materials.size());
+    depth = std::min(std::max(depth, 0.0f), 1.0f);
+    const uint64_t quantizedDepth = (uint64_t)(depth * 0xffffff);
+    const uint64_t program = shader.GetRendererID() & 0xffff;
+
+    uint64_t key = (uint64_t)pass << 60;
+    if (m_Materials[material].IsTranslucent())
+        key |= (1ull << 59) | ((0xffffff - quantizedDepth) << 35) | (program << 19) | ((uint64_t)material << 7);
+    else
+        key |= (program << 43) | ((uint64_t)material << 31) | (quantizedDepth << 7);
+    return key;
+}
+
+void RenderCommandQueue::Sort()
+{
+    PROFILE_SCOPE("RenderCommandQueue::Sort");
+
+    const size_t count = m_Sorted.size();
+    if (count < 2)
+        return;
+
+    /* One counting pass over the keys gives the histograms of all 8 digits. */
+    unsigned int histograms[8][256] = {};
+    for (const SortEntry& entry : m_Sorted)
+    {
+        for (unsigned int digit = 0; digit < 8; digit++)
+            histograms[digit][(entry.Key >> (digit * 8)) & 0xff]++;
+    }
+
+    /* Least significant digit first. Each pass is stable, so after the last one the keys are in order */
+    /* and equal keys are still in the order they were collected in. */
+    m_SortScratch.resize(count); // Reserved up front, never allocates
+    SortEntry* source = m_Sorted.data();
+    SortEntry* destination = m_SortScratch.data();
+    for (unsigned int digit = 0; digit < 8; digit++)
+    {
+        const unsigned int shift = digit * 8;
+        unsigned int* histogram = histograms[digit];
+        if (histogram[(source[0].Key >> shift) & 0xff] == count)
+            continue; // Every key has the same digit here, the pass would not move anything
+
+        unsigned int offset = 0;
+        for (unsigned int bucket = 0; bucket < 256; bucket++)
+        {
+            const unsigned int bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; i++)
+            destination[histogram[(source[i].Key >> shift) & 0xff]++] = source[i];
+
+        std::swap(source, destination);
+        m_Stats.SortPasses++;
+    }
+
+    /* Swapping the vectors swaps their storage, nothing is copied. */
+    if (source != m_Sorted.data())
+        m_Sorted.swap(m_SortScratch);
+}
+
+RenderCommandQueue::Changes RenderCommandQueue::CountChanges() const
+{
+    Changes changes;
+    const RenderCommandBuffer::DrawCommand* previous = nullptr;
+    for (const SortEntry& entry : m_Sorted)
+    {
+        const RenderCommandBuffer::DrawCommand& draw = m_Buffers[entry.Buffer].GetDraw(entry.Index);
+        const Material& material = m_Materials[draw.Material];
+        if (!previous)
+        {
+            /* The first draw binds everything it needs. */
+            changes.Programs++;
+            changes.Materials++;
+            changes.Textures += material.Texture != 0;
+            changes.Blends++;
+        }
+        else
+        {
+            const Material& previousMaterial = m_Materials[previous->Material];
+            changes.Programs += draw.Program != previous->Program;
+            changes.Materials += draw.Material != previous->Material;
+            changes.Textures += material.Texture != 0 && material.Texture != previousMaterial.Texture;
+            changes.Blends += material.Blend != previousMaterial.Blend;
+        }
+        previous = &draw;
+    }
+    return changes;
+}
+
+void RenderCommandQueue::ApplyMaterial(const Material& material)
+{
+    if (material.Texture)
+        StateCache::BindTexture(0, GL_TEXTURE_2D, material.Texture);
+
+    switch (material.Blend)
+    {
+        case BlendMode::Opaque:
+            StateCache::SetBlend(false);
+            StateCache::SetDepthMask(true);
+            break;
+        case BlendMode::Alpha:
+            StateCache::SetBlend(true);
+            StateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            StateCache::SetDepthMask(false);
+            break;
+        case BlendMode::Additive:
+            StateCache::SetBlend(true);
+            StateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            StateCache::SetDepthMask(false);
+            break;
+    }
+}
+
+void RenderCommandQueue::Execute(bool sort)
+{
+    m_Stats = Stats();
+
+    m_Sorted.clear();
+    for (unsigned int b = 0; b < m_Buffers.size(); b++)
+    {
+        const RenderCommandBuffer& buffer = m_Buffers[b];
+        for (unsigned int i = 0; i < buffer.GetDrawCount(); i++)
+            m_Sorted.push_back({ buffer.GetDraw(i).Key, b, i });
+        m_Stats.Dropped += buffer.GetDroppedCount();
+    }
+
+    /* Counting costs a walk over the draws, cheap next to submitting them, and tells what sorting saves. */
+    m_Stats.Recorded = CountChanges();
+    if (sort)
+    {
+        Sort();
+        m_Stats.Submitted = CountChanges();
+    }
+    else
+    {
+        m_Stats.Submitted = m_Stats.Recorded;
+    }
+
+    unsigned int material = ~0u;
+    for (const SortEntry& entry : m_Sorted)
+    {
+        const RenderCommandBuffer& buffer = m_Buffers[entry.Buffer];
+        const RenderCommandBuffer::DrawCommand& draw = buffer.GetDraw(entry.Index);
+
+        StateCache::UseProgram(draw.Program);
+        StateCache::BindVertexArray(draw.VertexArray);
+        StateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, draw.IndexBuffer);
+        if (draw.Material != material)
+        {
+            /* The StateCache would drop the repeated binds too, this saves asking it. */
+            ApplyMaterial(m_Materials[draw.Material]);
+            material = draw.Material;
+        }
+
+        for (unsigned int u = 0; u < draw.UniformCount; u++)
+        {
+            const RenderCommandBuffer::Uniform& uniform = buffer.GetUniform(draw.FirstUniform + u);
+            const float* values = buffer.GetValues(uniform.Offset);
+            switch (uniform.Type)
+            {
+                case RenderCommandBuffer::UniformType::Int:
+                {
+                    int value;
+                    memcpy(&value, values, sizeof(int));
+                    GLCall(glUniform1i(uniform.Location, value));
+                    break;
+                }
+                case RenderCommandBuffer::UniformType::Float:
+                    GLCall(glUniform1f(uniform.Location, values[0]));
+                    break;
+                case RenderCommandBuffer::UniformType::Float4:
+                    GLCall(glUniform4fv(uniform.Location, 1, values));
+                    break;
+                case RenderCommandBuffer::UniformType::Mat4:
+                    GLCall(glUniformMatrix4fv(uniform.Location, 1, GL_FALSE, values));
+                    break;
+            }
+        }
+
+        if (draw.InstanceCount > 1)
+        {
+            GLCall(glDrawElementsInstanced(GL_TRIANGLES, draw.IndexCount, draw.IndexType, nullptr, draw.InstanceCount));
+        }
+        else
+        {
+            GLCall(glDrawElements(GL_TRIANGLES, draw.IndexCount, draw.IndexType, nullptr));
+        }
+    }
+    m_Stats.Draws = (unsigned int)m_Sorted.size();
+
+    StateCache::SetBlend(false);
+    StateCache::SetDepthMask(true);
+
+    for (RenderCommandBuffer& buffer : m_Buffers)
+        buffer.Reset();
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Shader;
+class VertexArray;
+class IndexBuffer;
+
+/* Draws recorded by one thread. */
+/*                                                                    */
+/* Every draw is a plain data packet: the objects it uses (as GL names), its per-draw uniforms and */
+/* a sort key. Recording calls no OpenGL at all, so any thread can record into its own buffer while */
+/* the GL thread is busy, and all the memory is allocated up front, so recording never allocates. */
+/* A full buffer drops draws and counts them instead of growing. */
+/*                                                                    */
+/* Uniforms are recorded by location, because looking names up touches the Shader's cache and the */
+/* driver. Get the locations once on the GL thread with Shader::GetUniformLocation. */
+class RenderCommandBuffer
+{
+public:
+    enum class UniformType : unsigned char
+    {
+        Int, Float, Float4, Mat4
+    };
+
+    struct Uniform
+    {
+        int Location;
+        UniformType Type;
+        unsigned int Offset;     // Into the value array, in 4 byte values
+    };
+
+    struct DrawCommand
+    {
+        uint64_t Key;
+        unsigned int Program;
+        unsigned int VertexArray;
+        unsigned int IndexBuffer;
+        unsigned int IndexCount;
+        unsigned int IndexType;
+        unsigned int InstanceCount;
+        unsigned int Material;   // Index into the queue's materials, see RenderCommandQueue::AddMaterial
+        unsigned int FirstUniform;
+        unsigned int UniformCount;
+    };
+
+private:
+    std::vector<DrawCommand> m_Draws;
+    std::vector<Uniform> m_Uniforms;
+    std::vector<float> m_Values; // Ints are stored bit for bit
+
+    unsigned int m_DrawCount;
+    unsigned int m_UniformCount;
+    unsigned int m_ValueCount;
+    unsigned int m_Dropped;
+    bool m_Recording;            // False after a dropped draw, so its uniforms are dropped too
+
+    float* AddUniform(int location, UniformType type, unsigned int valueCount);
+
+public:
+    RenderCommandBuffer(unsigned int maxDraws, unsigned int maxUniforms, unsigned int maxValues);
+
+    /* Forgets every recorded command, keeping the memory. */
+    void Reset();
+
+    /* Starts a draw. The uniforms set after it, up to the next Draw, belong to it. */
+    /* key comes from RenderCommandQueue::MakeKey with the same shader and material. */
+    /* Returns false if the buffer is full and the draw was dropped. */
+    bool Draw(uint64_t key, const Shader& shader, unsigned int material, const VertexArray& va, const IndexBuffer& ib,
+        unsigned int instanceCount = 1);
+
+    void SetUniform1i(int location, int value);
+    void SetUniform1f(int location, float value);
+    void SetUniform4f(int location, float v0, float v1, float v2, float v3);
+    void SetUniformMat4f(int location, const float* matrix);
+
+    inline unsigned int GetDrawCount() const { return m_DrawCount; }
+    inline unsigned int GetDroppedCount() const { return m_Dropped; }
+    inline const DrawCommand& GetDraw(unsigned int index) const { return m_Draws[index]; }
+    inline const Uniform& GetUniform(unsigned int index) const { return m_Uniforms[index]; }
+    inline const float* GetValues(unsigned int offset) const { return &m_Values[offset]; }
+};
+
+/* Collects the draws of several threads and submits them from the GL thread, sorted by key. */
+/*                                                                    */
+/* The key decides the order: draws sharing a program, then a material, end up next to each other, */
+/* so the StateCache drops most of the binds in between. See MakeKey for the layout. */
+/* The keys are radix sorted, 8 bits per pass, skipping the passes in which every key has the same */
+/* digit. With a few programs and materials most of the 8 passes are skipped. */
+class RenderCommandQueue
+{
+public:
+    enum class BlendMode : unsigned char
+    {
+        Opaque,   // No blending, writes depth
+        Alpha,    // src * a + dst * (1 - a), doesn't write depth
+        Additive  // src * a + dst, doesn't write depth
+    };
+
+    /* Everything a draw binds besides its program and geometry. */
+    struct Material
+    {
+        unsigned int Texture = 0; // Bound to unit 0 as GL_TEXTURE_2D, 0 for none
+        BlendMode Blend = BlendMode::Opaque;
+
+        inline bool IsTranslucent() const { return Blend != BlendMode::Opaque; }
+    };
+
+    /* How often consecutive draws differ, which is what the driver has to validate. */
+    struct Changes
+    {
+        unsigned int Programs = 0;
+        unsigned int Materials = 0;
+        unsigned int Textures = 0;
+        unsigned int Blends = 0;
+    };
+
+    struct Stats
+    {
+        unsigned int Draws = 0;
+        unsigned int Dropped = 0;
+        unsigned int SortPasses = 0; // Out of 8, see the class comment
+        Changes Recorded;            // In the order the draws were recorded, which is what an unsorted Execute submits
+        Changes Submitted;           // In the order they were submitted
+    };
+
+    static const unsigned int MaxPasses = 16;
+    static const unsigned int MaxMaterials = 4096;
+
+private:
+    struct SortEntry
+    {
+        uint64_t Key;
+        unsigned int Buffer;
+        unsigned int Index;
+    };
+
+    std::vector<RenderCommandBuffer> m_Buffers;
+    std::vector<Material> m_Materials;
+    std::vector<SortEntry> m_Sorted;
+    std::vector<SortEntry> m_SortScratch; // Every other radix pass scatters into this
+    Stats m_Stats;
+
+    void Sort();
+    Changes CountChanges() const;
+    static void ApplyMaterial(const Material& material);
+
+public:
+    /* One buffer per recording thread, e.g. ThreadPool::GetThreadCount(). */
+    RenderCommandQueue(unsigned int bufferCount, unsigned int maxDrawsPerBuffer = 16384,
+        unsigned int maxUniformsPerBuffer = 32768, unsigned int maxValuesPerBuffer = 131072);
+
+    /* Each thread records into the buffer with its own index, so recording needs no locks. */
+    inline RenderCommandBuffer& GetBuffer(unsigned int index) { return m_Buffers[index]; }
+    inline unsigned int GetBufferCount() const { return (unsigned int)m_Buffers.size(); }
+
+    /* Returns the index draws refer to the material by. Material 0, without texture and blending, */
+    /* always exists. Only on the GL thread, and not while other threads are recording. */
+    unsigned int AddMaterial(const Material& material);
+    /* Changes a material in place, e.g. once its texture has loaded. Its blend mode has to stay */
+    /* translucent or opaque, the keys already recorded depend on it. */
+    void SetMaterial(unsigned int index, const Material& material);
+    inline const Material& GetMaterial(unsigned int index) const { return m_Materials[index]; }
+    inline unsigned int GetMaterialCount() const { return (unsigned int)m_Materials.size(); }
+
+    /* Sorts everything recorded since the last Execute, submits it and resets the buffers. */
+    /* Leaves blending off and depth writes on, like every other draw path expects. */
+    /* Only on the GL thread, and not while other threads are still recording. */
+    void Execute(bool sort = true);
+
+    inline const Stats& GetStats() const { return m_Stats; }
+
+    /* From the most to the least significant bits: */
+    /* pass (4 bits), translucent (1 bit), then for opaque materials */
+    /* program (16 bits), material (12 bits), depth (24 bits), */
+    /* and for translucent ones */
+    /* inverted depth (24 bits), program (16 bits), material (12 bits). */
+    /* The pass orders whole passes (world, then overlay...). Within a pass opaque draws come first, */
+    /* grouped by state and front to back so early depth testing rejects what is hidden; translucent */
+    /* draws follow back to front, because blending only looks right in that order, and are grouped */
+    /* by state only where the depths are equal. Depth in [0, 1] is quantized, 0 is nearest. */
+    /* Can be called from any thread, it only reads the material's blend mode. */
+    uint64_t MakeKey(unsigned int pass, const Shader& shader, unsigned int material, float depth) const;
+};
@@ -0,0 +1,146 @@
+#include "Renderer.h"
+
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "IndirectCommandBuffer.h"
+#include "MeshPool.h"
+
+#include <iostream>
+#include <cstdio>
+
+void GLClearErrors()
+{
+    while (glGetError() != GL_NO_ERROR);
+}
+
+bool GLLogCall(const char* function, const char* file, int line)
+{
+    while (GLenum error = glGetError())
+    {
+        std::cout << "[OpenGL Error] (" << error << "): " << function << " " << file << ":" << line << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool GLCheckFrameErrors(const char* label)
+{
+#if GLCALL_CHECK_LEVEL == GLCALL_CHECK_NONE
+    (void)label;
+    return true;
+#else
+    bool ok = true;
+    while (GLenum error = glGetError())
+    {
+        std::cout << "[OpenGL Error] (" << error << "): during " << label << std::endl;
+        ok = false;
+    }
+    return ok;
+#endif
+}
+
+static const char* GLDebugSourceName(GLenum source)
+{
+    switch (source)
+    {
+        case GL_DEBUG_SOURCE_API:             return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "Window System";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader Compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:     return "Third Party";
+        case GL_DEBUG_SOURCE_APPLICATION:     return "Application";
+        default:                              return "Other";
+    }
+}
+
+static const char* GLDebugSeverityName(GLenum severity)
+{
+    switch (severity)
+    {
+        case GL_DEBUG_SEVERITY_HIGH:   return "High";
+        case GL_DEBUG_SEVERITY_MEDIUM: return "Medium";
+        case GL_DEBUG_SEVERITY_LOW:    return "Low";
+        default:                       return "Notification";
+    }
+}
+
+/* This callback may be called from a driver thread when the output is asynchronous, */
+/* so it only uses fprintf, which writes each message in one go. */
+static void GLAPIENTRY GLDebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* message, const void* userParam)
+{
+    (void)length;
+    (void)userParam;
+
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+        return;
+
+    fprintf(stderr, "[OpenGL %s] (%u) %s%s: %s\n", GLDebugSeverityName(severity), id, GLDebugSourceName(source),
+        type == GL_DEBUG_TYPE_ERROR ? " error" : "", message);
+}
+
+bool GLEnableDebugOutput(bool synchronous)
+{
+    if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+        return false;
+
+    GLCall(glEnable(GL_DEBUG_OUTPUT));
+    if (synchronous)
+    {
+        GLCall(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+    }
+    else
+    {
+        GLCall(glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+    }
+    GLCall(glDebugMessageCallback(GLDebugMessageCallback, nullptr));
+    return true;
+}
+
+void Renderer::Clear() const
+{
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+}
+
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const
+{
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr));
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const
+{
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr, instanceCount));
+}
+
+unsigned int Renderer::DrawIndirect(const MeshPool& pool, const IndirectCommandBuffer& commands, const Shader& shader, bool multiDraw) const
+{
+    if (commands.GetCommandCount() == 0)
+        return 0;
+
+    shader.Bind();
+    pool.GetVertexArray().Bind();
+    const unsigned int indexType = pool.GetIndexType();
+    const unsigned int indexSize = indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+
+    if (multiDraw && IndirectCommandBuffer::IsMultiDrawSupported())
+    {
+        /* The GPU reads the commands straight from the bound GL_DRAW_INDIRECT_BUFFER, */
+        /* the offset is into that buffer and stride 0 means the commands are tightly packed. */
+        commands.Bind();
+        GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr, commands.GetCommandCount(), 0));
+        return 1;
+    }
+
+    for (const DrawElementsIndirectCommand& command : commands.GetCommands())
+    {
+        GLCall(glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.Count, indexType,
+            (const void*)(size_t)(command.FirstIndex * indexSize), command.InstanceCount, command.BaseVertex, command.BaseInstance));
+    }
+    return commands.GetCommandCount();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <GL/glew.h> // We need to include glew.h before any OpenGL .h file
+
+/* GLCall can check for errors at three different levels. */
+/* Every glGetError is a round-trip to the driver that may force a client/server sync, */
+/* so checking after every single call is only something we want while debugging. */
+#define GLCALL_CHECK_NONE  0 // GLCall expands to the bare call and GLCheckFrameErrors does nothing
+#define GLCALL_CHECK_FRAME 1 // GLCall expands to the bare call and errors are drained once per frame
+#define GLCALL_CHECK_CALL  2 // Errors are cleared before and checked after every call
+
+/* The level can be forced from the project settings, e.g. GLCALL_CHECK_LEVEL=0 for profiling builds. */
+#ifndef GLCALL_CHECK_LEVEL
+    #ifdef _DEBUG
+        #define GLCALL_CHECK_LEVEL GLCALL_CHECK_CALL
+    #else
+        #define GLCALL_CHECK_LEVEL GLCALL_CHECK_FRAME
+    #endif
+#endif
+
+#define ASSERT(x) if (!(x)) __debugbreak(); // Compiler intrinsic function
+
+#if GLCALL_CHECK_LEVEL == GLCALL_CHECK_CALL
+    #define GLCall(x) GLClearErrors();\
+        x;\
+        ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#else
+    #define GLCall(x) x
+#endif
+
+// #x turns the function name into a string
+// __FILE__ indicates the file from which the function was called
+// __LINE__ indicates the line of the function that was called
+
+void GLClearErrors();
+bool GLLogCall(const char* function, const char* file, int line);
+
+/* Drains the error queue once. Meant to be called once per frame (e.g. right before swapping buffers), */
+/* so release builds still notice errors without paying for a glGetError after every call. */
+/* Returns false if any error was found. */
+bool GLCheckFrameErrors(const char* label);
+
+/* Installs glDebugMessageCallback when GL_KHR_debug (or OpenGL 4.3) is available. */
+/* With synchronous = false the driver reports errors asynchronously and nothing blocks, */
+/* with synchronous = true the callback runs inside the offending call so the call stack is meaningful. */
+/* Returns false if the extension is not supported. */
+bool GLEnableDebugOutput(bool synchronous);
+
+class VertexArray;
+class IndexBuffer;
+class Shader;
+class IndirectCommandBuffer;
+class MeshPool;
+
+class Renderer
+{
+public:
+    void Clear() const;
+
+    void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+
+    /* Draws instanceCount copies of the mesh with one glDrawElementsInstanced. */
+    /* Per-instance data comes from the buffers added to va with VertexBufferLayout::PushInstanced. */
+    void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
+
+    /* Draws every command of the buffer from the meshes of pool with one glMultiDrawElementsIndirect. */
+    /* With multiDraw = false, or where multi-draw is not supported, the commands are submitted one by one instead, */
+    /* which is also what the benchmark compares against. Returns the number of draw calls issued. */
+    unsigned int DrawIndirect(const MeshPool& pool, const IndirectCommandBuffer& commands, const Shader& shader, bool multiDraw = true) const;
+};
+
+/* Per-frame data shared by every program through the "Frame" uniform block (std140). */
+/* layout(std140) uniform Frame { mat4 u_ViewProjection; float u_Time; }; */
+struct FrameData
+{
+    static const unsigned int BindingPoint = 0;
+
+    float ViewProjection[16];
+    float Time;
+    float Padding[3]; // std140 rounds the block size up to a multiple of 16 bytes
+};
+
+static_assert(sizeof(FrameData) == 80, "FrameData must match the std140 layout of the Frame block");
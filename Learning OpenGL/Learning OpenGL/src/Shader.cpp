@@ -0,0 +1,421 @@
+#include "Shader.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+#include "ProgramCache.h"
+#include "ShaderPreprocessor.h"
+#include "HotReloader.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <iostream>
+
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& defines)
+    : m_FilePath(filepath), m_RendererID(0), m_Defines(defines), m_ReloadCount(0)
+{
+    ShaderProgramSource source = ParseShader(filepath, defines);
+    SetFiles(source.Files);
+    HotReloader::Register(this);
+
+    /* Compiling and linking from source is slow, so we first try the binary the driver gave us last time. */
+    m_RendererID = ProgramCache::Load(source);
+    if (!m_RendererID)
+    {
+        PendingProgram pending = SubmitProgram(source);
+        m_RendererID = FinishProgram(pending, filepath);
+        if (m_RendererID)
+            ProgramCache::Store(m_RendererID, source);
+    }
+
+    if (m_RendererID)
+        GpuMemory::Allocate(GpuMemory::Category::Programs, 0);
+}
+
+Shader::Shader(const std::string& filepath, unsigned int program, const std::vector<std::string>& defines, const std::vector<std::string>& files)
+    : m_FilePath(filepath), m_RendererID(program), m_Defines(defines), m_ReloadCount(0)
+{
+    SetFiles(files);
+    HotReloader::Register(this);
+
+    if (m_RendererID)
+        GpuMemory::Allocate(GpuMemory::Category::Programs, 0);
+}
+
+Shader::~Shader()
+{
+    HotReloader::Unregister(this);
+    StateCache::OnDeleteProgram(m_RendererID);
+    GLCall(glDeleteProgram(m_RendererID));
+    if (m_RendererID)
+        GpuMemory::Free(GpuMemory::Category::Programs, 0);
+}
+
+void Shader::SetFiles(const std::vector<std::string>& files)
+{
+    m_Files.clear();
+    for (const std::string& file : files)
+        m_Files.push_back(FileSystem::NormalizePath(file));
+}
+
+bool Shader::DependsOn(const std::string& path) const
+{
+    return std::find(m_Files.begin(), m_Files.end(), path) != m_Files.end();
+}
+
+void Shader::ReplaceProgram(unsigned int program, const std::vector<std::string>& files)
+{
+    ASSERT(program);
+
+    /* 0 if the file didn't compile at startup, there is nothing to carry over then. */
+    if (m_RendererID)
+    {
+        CopyUniforms(m_RendererID, program);
+        StateCache::OnDeleteProgram(m_RendererID);
+        GLCall(glDeleteProgram(m_RendererID));
+    }
+    else
+    {
+        GpuMemory::Allocate(GpuMemory::Category::Programs, 0);
+    }
+    m_RendererID = program;
+    m_UniformLocationCache.clear();
+    m_ReloadCount++;
+
+    if (!files.empty())
+        SetFiles(files);
+}
+
+void Shader::CopyUniforms(unsigned int from, unsigned int to)
+{
+    /* Block bindings are program state, usually set once right after the program was created. */
+    int blockCount = 0;
+    GLCall(glGetProgramiv(from, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount));
+    for (int block = 0; block < blockCount; block++)
+    {
+        char name[256];
+        int binding = 0;
+        GLCall(glGetActiveUniformBlockName(from, block, sizeof(name), nullptr, name));
+        GLCall(glGetActiveUniformBlockiv(from, block, GL_UNIFORM_BLOCK_BINDING, &binding));
+        unsigned int index = glGetUniformBlockIndex(to, name);
+        if (index != GL_INVALID_INDEX)
+        {
+            GLCall(glUniformBlockBinding(to, index, binding));
+        }
+    }
+
+    /* Default block uniforms, element by element. glUniform* writes to the program in use, */
+    /* so the new program is bound for the copy. Bindless handles are not copied. */
+    StateCache::UseProgram(to);
+    int uniformCount = 0;
+    GLCall(glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &uniformCount));
+    for (int uniform = 0; uniform < uniformCount; uniform++)
+    {
+        char name[256];
+        int size = 0;
+        GLenum type = GL_NONE;
+        GLCall(glGetActiveUniform(from, uniform, sizeof(name), nullptr, &size, &type, name));
+
+        /* Arrays are reported once as "name[0]", their elements are looked up one by one. */
+        std::string base = name;
+        if (size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+            base.resize(base.size() - 3);
+
+        for (int element = 0; element < size; element++)
+        {
+            std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : base;
+            int source = glGetUniformLocation(from, elementName.c_str());
+            int target = glGetUniformLocation(to, elementName.c_str());
+            if (source < 0 || target < 0) // In a uniform block, or gone from the new program
+                continue;
+
+            float f[16];
+            int i[4];
+            unsigned int u[4];
+            switch (type)
+            {
+                case GL_FLOAT:             GLCall(glGetUniformfv(from, source, f)); GLCall(glUniform1fv(target, 1, f)); break;
+                case GL_FLOAT_VEC2:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniform2fv(target, 1, f)); break;
+                case GL_FLOAT_VEC3:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniform3fv(target, 1, f)); break;
+                case GL_FLOAT_VEC4:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniform4fv(target, 1, f)); break;
+                case GL_FLOAT_MAT2:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniformMatrix2fv(target, 1, GL_FALSE, f)); break;
+                case GL_FLOAT_MAT3:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniformMatrix3fv(target, 1, GL_FALSE, f)); break;
+                case GL_FLOAT_MAT4:        GLCall(glGetUniformfv(from, source, f)); GLCall(glUniformMatrix4fv(target, 1, GL_FALSE, f)); break;
+                case GL_BOOL_VEC2:
+                case GL_INT_VEC2:          GLCall(glGetUniformiv(from, source, i)); GLCall(glUniform2iv(target, 1, i)); break;
+                case GL_BOOL_VEC3:
+                case GL_INT_VEC3:          GLCall(glGetUniformiv(from, source, i)); GLCall(glUniform3iv(target, 1, i)); break;
+                case GL_BOOL_VEC4:
+                case GL_INT_VEC4:          GLCall(glGetUniformiv(from, source, i)); GLCall(glUniform4iv(target, 1, i)); break;
+                case GL_UNSIGNED_INT:      GLCall(glGetUniformuiv(from, source, u)); GLCall(glUniform1uiv(target, 1, u)); break;
+                case GL_UNSIGNED_INT_VEC2: GLCall(glGetUniformuiv(from, source, u)); GLCall(glUniform2uiv(target, 1, u)); break;
+                case GL_UNSIGNED_INT_VEC3: GLCall(glGetUniformuiv(from, source, u)); GLCall(glUniform3uiv(target, 1, u)); break;
+                case GL_UNSIGNED_INT_VEC4: GLCall(glGetUniformuiv(from, source, u)); GLCall(glUniform4uiv(target, 1, u)); break;
+                default:
+                    /* int, bool, samplers and images are all set as ints. */
+                    GLCall(glGetUniformiv(from, source, i));
+                    GLCall(glUniform1iv(target, 1, i));
+                    break;
+            }
+        }
+    }
+}
+
+ShaderProgramSource Shader::ParseShader(const std::string& filepath, const std::vector<std::string>& defines)
+{
+    ShaderPreprocessor preprocessor;
+    preprocessor.AddDefines(defines);
+
+    ShaderProgramSource source;
+    preprocessor.Process(filepath, source);
+    return source;
+}
+
+unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+{
+    // glCreateShader creates an empty shader object and returns a non-zero value by which it can be referenced. 
+    // A shader object is used to maintain the source code strings that define a shader.
+    unsigned int id = glCreateShader(type);
+
+    const char* src = source.c_str(); // This is a pointer to the beginning of the string data
+
+    // glShaderSource sets the source code in shader to the source code in the array of strings specified by string.
+    // Any source code previously stored in the shader object is completely replaced.The number of strings in the array is specified by count.
+    // If length is NULL, each string is assumed to be null terminated.
+    // If length is a value other than NULL, it points to an array containing a string length for each of the corresponding elements of string.
+    glShaderSource(id, 1, &src, nullptr);
+
+    // glCompileShader compiles the source code strings that have been stored in the shader object specified by shader.
+    // The driver is free to compile in the background, we only wait for it once we ask for GL_COMPILE_STATUS
+    // in CheckShader, which is why that check lives in FinishProgram and not here.
+    glCompileShader(id);
+
+    return id;
+}
+
+const char* Shader::GetStageName(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_VERTEX_SHADER:   return "vertex";
+        case GL_FRAGMENT_SHADER: return "fragment";
+        case GL_COMPUTE_SHADER:  return "compute";
+    }
+    return "unknown";
+}
+
+bool Shader::CheckShader(unsigned int id, unsigned int type, const std::string& name)
+{
+    if (!id) // The program doesn't have this stage
+        return true;
+
+    // The next code is used for checking any possible error in the compilation of the shader
+    int result;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
+    if (result == GL_FALSE) // The shader has not compiled successfully
+    {
+        int length;
+        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
+        // The log can be as long as the driver likes, far too much for the stack, and we only get here when
+        // something is already broken, so a heap allocation is fine.
+        std::vector<char> message(length > 0 ? length : 1, '\0');
+        glGetShaderInfoLog(id, (GLsizei)message.size(), &length, message.data());
+        std::cout << "Failed to compile " << GetStageName(type) << " shader of " << name << "!" << std::endl;
+        std::cout << message.data() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// This function will provide OpenGL with the source code of the vertex shader and the fragment shader.
+// And we want OpenGL to compile that program and link them together. Nothing in here asks for a status,
+// so with GL_KHR_parallel_shader_compile the driver can do all the work on its own threads.
+Shader::PendingProgram Shader::SubmitProgram(const ShaderProgramSource& source)
+{
+    PendingProgram pending;
+
+    // glCreateProgram creates an empty program object and returns a non-zero value by which it can be referenced. 
+    // A program object is an object to which shader objects can be attached. This provides a mechanism to specify the shader objects 
+    // that will be linked to create a program. It also provides a means for checking the compatibility of the shaders that will 
+    // be used to create a program (for instance, checking the compatibility between a vertex shader and a fragment shader). 
+    // When no longer needed as part of a program object, shader objects can be detached.
+    pending.Program = glCreateProgram();
+
+    pending.VertexShader = 0;
+    pending.FragmentShader = 0;
+    pending.ComputeShader = 0;
+    if (!source.ComputeSource.empty())
+    {
+        // A compute program is made of a single compute shader and can't be combined with other stages.
+        pending.ComputeShader = CompileShader(GL_COMPUTE_SHADER, source.ComputeSource);
+        GLCall(glAttachShader(pending.Program, pending.ComputeShader));
+
+        ProgramCache::PrepareForLink(pending.Program);
+        GLCall(glLinkProgram(pending.Program));
+        return pending;
+    }
+
+    pending.VertexShader = CompileShader(GL_VERTEX_SHADER, source.VertexSource);
+    pending.FragmentShader = CompileShader(GL_FRAGMENT_SHADER, source.FragmentSource);
+
+    // In order to create a complete shader program, there must be a way to specify the list of things that will be linked together.
+    // Program objects provide this mechanism. Shaders that are to be linked together in a program object must first be attached to that program object.
+    // glAttachShader attaches the shader object specified by shader to the program object specified by program.This indicates that shader will 
+    // be included in link operations that will be performed on program.
+    GLCall(glAttachShader(pending.Program, pending.VertexShader));
+    GLCall(glAttachShader(pending.Program, pending.FragmentShader));
+
+    // glLinkProgram links the program object specified by program. 
+    // If any shader objects of type GL_VERTEX_SHADER are attached to program, they will be used to create an executable that will run on the programmable vertex processor. 
+    // If any shader objects of type GL_GEOMETRY_SHADER are attached to program, they will be used to create an executable that will run on the programmable geometry processor. 
+    // If any shader objects of type GL_FRAGMENT_SHADER are attached to program, they will be used to create an executable that will run on the programmable fragment processor.
+    ProgramCache::PrepareForLink(pending.Program); // Asks the driver to keep the binary so it can be cached
+    GLCall(glLinkProgram(pending.Program));
+
+    return pending;
+}
+
+bool Shader::IsProgramComplete(const PendingProgram& pending)
+{
+    /* Without the extension there is no way to ask without blocking, so we report it as complete */
+    /* and FinishProgram will wait for it. */
+    if (!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile)
+        return true;
+
+    int complete = GL_FALSE;
+    GLCall(glGetProgramiv(pending.Program, GL_COMPLETION_STATUS_KHR, &complete));
+    return complete == GL_TRUE;
+}
+
+unsigned int Shader::FinishProgram(PendingProgram& pending, const std::string& name)
+{
+    bool compiled = CheckShader(pending.VertexShader, GL_VERTEX_SHADER, name);
+    compiled = CheckShader(pending.FragmentShader, GL_FRAGMENT_SHADER, name) && compiled;
+    compiled = CheckShader(pending.ComputeShader, GL_COMPUTE_SHADER, name) && compiled;
+
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(pending.Program, GL_LINK_STATUS, &linked));
+    if (compiled && linked == GL_FALSE)
+    {
+        int length;
+        GLCall(glGetProgramiv(pending.Program, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(length > 0 ? length : 1, '\0');
+        GLCall(glGetProgramInfoLog(pending.Program, (GLsizei)message.size(), &length, message.data()));
+        std::cout << "Failed to link " << name << "!" << std::endl;
+        std::cout << message.data() << std::endl;
+    }
+
+#ifdef _DEBUG
+    // glValidateProgram checks to see whether the executables contained in program can execute given the current OpenGL state. 
+    // The information generated by the validation process will be stored in program's information log. 
+    // The validation information may consist of an empty string, or it may be a string containing information about how the current program object 
+    // interacts with the rest of current OpenGL state. This provides a way for OpenGL implementers to convey more information about why the current 
+    // program is inefficient, suboptimal, failing to execute, and so on.
+    // It has to wait for the link to finish, so release builds skip it.
+    if (linked == GL_TRUE)
+    {
+        GLCall(glValidateProgram(pending.Program));
+    }
+#endif
+
+    // Deleting shader 0 is silently ignored, so the stages the program doesn't have need no check.
+    GLCall(glDeleteShader(pending.VertexShader));
+    GLCall(glDeleteShader(pending.FragmentShader));
+    GLCall(glDeleteShader(pending.ComputeShader));
+
+    if (!compiled || linked == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(pending.Program));
+        return 0;
+    }
+
+    return pending.Program;
+}
+
+bool Shader::IsComputeSupported()
+{
+    return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader;
+}
+
+void Shader::Bind() const
+{
+    StateCache::UseProgram(m_RendererID);
+}
+
+void Shader::Unbind() const
+{
+    StateCache::UseProgram(0);
+}
+
+void Shader::SetUniform1i(const std::string& name, int value)
+{
+    GLCall(glUniform1i(GetUniformLocation(name), value));
+}
+
+void Shader::SetUniform1iv(const std::string& name, int count, const int* values)
+{
+    GLCall(glUniform1iv(GetUniformLocation(name), count, values));
+}
+
+void Shader::SetUniform1f(const std::string& name, float value)
+{
+    GLCall(glUniform1f(GetUniformLocation(name), value));
+}
+
+void Shader::SetUniform2f(const std::string& name, float v0, float v1)
+{
+    GLCall(glUniform2f(GetUniformLocation(name), v0, v1));
+}
+
+void Shader::SetUniform2i(const std::string& name, int v0, int v1)
+{
+    GLCall(glUniform2i(GetUniformLocation(name), v0, v1));
+}
+
+void Shader::SetUniform3f(const std::string& name, float v0, float v1, float v2)
+{
+    GLCall(glUniform3f(GetUniformLocation(name), v0, v1, v2));
+}
+
+void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
+{
+    GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+}
+
+void Shader::SetUniformMat4f(const std::string& name, const float* matrix)
+{
+    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, matrix));
+}
+
+void Shader::SetUniform4fv(const std::string& name, int count, const float* values)
+{
+    GLCall(glUniform4fv(GetUniformLocation(name), count, values));
+}
+
+bool Shader::SetUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint)
+{
+    GLCall(unsigned int index = glGetUniformBlockIndex(m_RendererID, blockName.c_str()));
+    if (index == GL_INVALID_INDEX)
+    {
+        std::cout << "Warning: uniform block '" << blockName << "' doesn't exist in " << m_FilePath << std::endl;
+        return false;
+    }
+
+    GLCall(glUniformBlockBinding(m_RendererID, index, bindingPoint));
+    return true;
+}
+
+int Shader::GetUniformLocation(const std::string& name) const
+{
+    auto it = m_UniformLocationCache.find(name);
+    if (it != m_UniformLocationCache.end())
+        return it->second;
+
+    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
+    if (location == -1)
+        std::cout << "Warning: uniform '" << name << "' doesn't exist in " << m_FilePath << std::endl;
+
+    m_UniformLocationCache[name] = location;
+    return location;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ShaderProgramSource
+{
+    std::string VertexSource;
+    std::string FragmentSource;
+    std::string ComputeSource; // A file with a compute stage has no other stage
+
+    /* Every file the sources were built from, the main file first, so a change to any of them can be */
+    /* picked up, see HotReloader. Not part of the ProgramCache key. */
+    std::vector<std::string> Files;
+};
+
+class Shader
+{
+private:
+    std::string m_FilePath;
+    unsigned int m_RendererID;
+    std::vector<std::string> m_Defines;
+    std::vector<std::string> m_Files; // Normalized, see ShaderProgramSource::Files
+    unsigned int m_ReloadCount;
+
+    /* glGetUniformLocation is a string lookup inside the driver, so every name is only looked up once. */
+    /* Names that don't exist in the program are cached as -1 so we only warn about them once. */
+    mutable std::unordered_map<std::string, int> m_UniformLocationCache;
+
+public:
+    /* A program whose shaders have been submitted to the driver but not checked yet. */
+    struct PendingProgram
+    {
+        unsigned int Program;
+        unsigned int VertexShader;   // 0 for compute programs
+        unsigned int FragmentShader; // 0 for compute programs
+        unsigned int ComputeShader;  // 0 unless the file has a #shader compute stage
+    };
+
+    /* Compiles and links the program right away, blocking until the driver is done. */
+    /* defines are injected into every stage, see ShaderPreprocessor. */
+    Shader(const std::string& filepath, const std::vector<std::string>& defines = std::vector<std::string>());
+
+    /* Takes ownership of an already linked program, see ShaderCompiler. files are the files it was built from. */
+    Shader(const std::string& filepath, unsigned int program, const std::vector<std::string>& defines, const std::vector<std::string>& files);
+    ~Shader();
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    void Bind() const;
+    void Unbind() const;
+
+    /* The setters upload to the program that is currently bound, so Bind has to be called first. */
+    void SetUniform1i(const std::string& name, int value);
+    void SetUniform1iv(const std::string& name, int count, const int* values);
+    void SetUniform1f(const std::string& name, float value);
+    void SetUniform2f(const std::string& name, float v0, float v1);
+    void SetUniform2i(const std::string& name, int v0, int v1);
+    void SetUniform3f(const std::string& name, float v0, float v1, float v2);
+    void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
+    void SetUniformMat4f(const std::string& name, const float* matrix);
+    void SetUniform4fv(const std::string& name, int count, const float* values);
+
+    /* Connects the uniform block called blockName to a uniform buffer binding point. */
+    /* Data shared by many programs (camera matrices, time) lives in one UniformBuffer bound to that point, */
+    /* so it is uploaded once per frame instead of once per program. Returns false if there is no such block. */
+    bool SetUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline const std::string& GetFilePath() const { return m_FilePath; }
+    inline const std::vector<std::string>& GetDefines() const { return m_Defines; }
+
+    /* True if path (normalized) is one of the files the program was built from. */
+    bool DependsOn(const std::string& path) const;
+
+    /* Swaps in a new linked program built from the same file, e.g. after an edit. Uniform values and */
+    /* uniform block bindings of the old program are copied over, and the old program is deleted. */
+    /* The program ID changes, so anything that caches uniform locations must look them up again when */
+    /* GetRendererID changes. files replaces the dependencies when it isn't empty. */
+    void ReplaceProgram(unsigned int program, const std::vector<std::string>& files);
+    inline unsigned int GetReloadCount() const { return m_ReloadCount; }
+
+    /* Compute shaders need OpenGL 4.3 or GL_ARB_compute_shader, and in practice also shader storage buffers */
+    /* and image load/store to be of any use, which 4.3 guarantees as well. */
+    static bool IsComputeSupported();
+
+    /* Public for code that records uniforms by location, like RenderCommandBuffer. */
+    /* Only call it on the thread the context is current on. */
+    int GetUniformLocation(const std::string& name) const;
+
+    /* Runs the file through ShaderPreprocessor. */
+    static ShaderProgramSource ParseShader(const std::string& filepath, const std::vector<std::string>& defines = std::vector<std::string>());
+
+    /* Compiles and links without asking for any status, so the call doesn't wait for the driver. */
+    static PendingProgram SubmitProgram(const ShaderProgramSource& source);
+
+    /* Non-blocking check through GL_KHR_parallel_shader_compile. Always true when the extension is missing. */
+    static bool IsProgramComplete(const PendingProgram& pending);
+
+    /* Checks compile and link status (waiting if necessary), prints the logs and deletes the shader objects. */
+    /* Returns the program, or 0 if it failed, in which case the program is deleted too. */
+    static unsigned int FinishProgram(PendingProgram& pending, const std::string& name);
+
+private:
+    static unsigned int CompileShader(unsigned int type, const std::string& source);
+    static bool CheckShader(unsigned int id, unsigned int type, const std::string& name);
+    static const char* GetStageName(unsigned int type);
+    static void CopyUniforms(unsigned int from, unsigned int to);
+    void SetFiles(const std::vector<std::string>& files);
+};
@@ -0,0 +1,127 @@
+#include "ShaderCompiler.h"
+
+#include "Renderer.h"
+#include "ProgramCache.h"
+
+ShaderCompiler::ShaderCompiler()
+    : m_PendingCount(0)
+{
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    /* Programs nobody took are still ours to delete. */
+    for (Job& job : m_Jobs)
+    {
+        if (job.State == Status::Pending)
+        {
+            job.Program = Shader::FinishProgram(job.Pending, job.FilePath);
+            job.State = Status::Ready;
+        }
+
+        if (job.State == Status::Ready && job.Program)
+        {
+            GLCall(glDeleteProgram(job.Program));
+        }
+    }
+}
+
+bool ShaderCompiler::IsParallelCompileSupported()
+{
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+bool ShaderCompiler::EnableParallelCompile()
+{
+    /* 0xFFFFFFFF means "as many threads as the implementation wants". */
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+        return true;
+    }
+    if (GLEW_ARB_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+        return true;
+    }
+    return false;
+}
+
+ShaderCompiler::Handle ShaderCompiler::Submit(const std::string& filepath, const std::vector<std::string>& defines)
+{
+    Job job;
+    job.FilePath = filepath;
+    job.Defines = defines;
+    job.Source = Shader::ParseShader(filepath, defines);
+    job.Files = job.Source.Files;
+    job.Program = ProgramCache::Load(job.Source);
+    job.Pending = Shader::PendingProgram();
+
+    if (job.Program)
+    {
+        job.State = Status::Ready;
+    }
+    else
+    {
+        job.Pending = Shader::SubmitProgram(job.Source);
+        job.State = Status::Pending;
+        m_PendingCount++;
+    }
+
+    m_Jobs.push_back(job);
+    return (Handle)m_Jobs.size() - 1;
+}
+
+void ShaderCompiler::Finish(Job& job)
+{
+    job.Program = Shader::FinishProgram(job.Pending, job.FilePath);
+    job.State = job.Program ? Status::Ready : Status::Failed;
+    if (job.Program)
+        ProgramCache::Store(job.Program, job.Source);
+
+    /* The source is only needed for the cache key, no need to keep it around. */
+    job.Source = ShaderProgramSource();
+    m_PendingCount--;
+}
+
+void ShaderCompiler::Poll()
+{
+    if (m_PendingCount == 0)
+        return;
+
+    bool parallel = IsParallelCompileSupported();
+    for (Job& job : m_Jobs)
+    {
+        if (job.State != Status::Pending)
+            continue;
+
+        if (parallel)
+        {
+            if (Shader::IsProgramComplete(job.Pending))
+                Finish(job);
+        }
+        else
+        {
+            /* Finishing blocks, so we only do one per call. */
+            Finish(job);
+            return;
+        }
+    }
+}
+
+ShaderCompiler::Status ShaderCompiler::GetStatus(Handle handle) const
+{
+    ASSERT(handle < m_Jobs.size());
+    return m_Jobs[handle].State;
+}
+
+std::unique_ptr<Shader> ShaderCompiler::Take(Handle handle)
+{
+    ASSERT(handle < m_Jobs.size());
+    Job& job = m_Jobs[handle];
+    if (job.State != Status::Ready)
+        return nullptr;
+
+    job.State = Status::Taken;
+    return std::unique_ptr<Shader>(new Shader(job.FilePath, job.Program, job.Defines, job.Files));
+}
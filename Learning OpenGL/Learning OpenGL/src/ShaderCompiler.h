@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+
+/* Compiles many programs without blocking the main thread. */
+/*                                                                    */
+/* Submit hands the sources to the driver and returns straight away. With GL_KHR_parallel_shader_compile */
+/* (or the ARB version) the driver compiles on its own threads and Poll only picks up the programs whose */
+/* GL_COMPLETION_STATUS_KHR says they are done. Without the extension Poll finishes at most one program */
+/* per call, so the cost is at least spread across frames instead of freezing a single one. */
+/* Programs found in the binary cache are ready as soon as they are submitted. */
+class ShaderCompiler
+{
+public:
+    typedef unsigned int Handle;
+
+    enum class Status { Pending, Ready, Failed, Taken };
+
+private:
+    struct Job
+    {
+        std::string FilePath;
+        std::vector<std::string> Defines;
+        std::vector<std::string> Files;   // Kept after Source is dropped, the shader needs them to hot-reload
+        ShaderProgramSource Source;
+        Shader::PendingProgram Pending;
+        unsigned int Program;
+        Status State;
+    };
+
+    std::vector<Job> m_Jobs;
+    unsigned int m_PendingCount;
+
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+    /* Lets the driver use as many compiler threads as it wants. Called once the context is current. */
+    static bool EnableParallelCompile();
+    static bool IsParallelCompileSupported();
+
+    Handle Submit(const std::string& filepath, const std::vector<std::string>& defines = std::vector<std::string>());
+
+    /* Never blocks when parallel compilation is supported. */
+    void Poll();
+
+    Status GetStatus(Handle handle) const;
+    inline unsigned int GetPendingCount() const { return m_PendingCount; }
+
+    /* Returns the finished shader once its status is Ready, null otherwise. Each handle can only be taken once. */
+    std::unique_ptr<Shader> Take(Handle handle);
+
+private:
+    void Finish(Job& job);
+};
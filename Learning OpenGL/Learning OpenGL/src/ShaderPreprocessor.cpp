@@ -0,0 +1,222 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+ShaderPreprocessor::Stats ShaderPreprocessor::s_TotalStats;
+
+static std::string GetDirectory(const std::string& filepath)
+{
+    size_t slash = filepath.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : filepath.substr(0, slash + 1);
+}
+
+/* True if [begin, end) starts with the given directive name followed by a space or the end of the line. */
+static bool MatchDirective(const char* begin, const char* end, const char* directive, const char*& rest)
+{
+    size_t length = strlen(directive);
+    if ((size_t)(end - begin) < length || memcmp(begin, directive, length) != 0)
+        return false;
+    if (begin + length != end && begin[length] != ' ' && begin[length] != '\t' && begin[length] != '\r')
+        return false;
+
+    rest = begin + length;
+    while (rest < end && (*rest == ' ' || *rest == '\t'))
+        rest++;
+    return true;
+}
+
+static std::string LineDirective(unsigned int line)
+{
+    return "#line " + std::to_string(line) + "\n";
+}
+
+void ShaderPreprocessor::AddDefine(const std::string& define)
+{
+    m_Defines.push_back(define);
+}
+
+void ShaderPreprocessor::AddDefines(const std::vector<std::string>& defines)
+{
+    m_Defines.insert(m_Defines.end(), defines.begin(), defines.end());
+}
+
+bool ShaderPreprocessor::ReadFile(const std::string& filepath, std::string& out)
+{
+    std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+    if (!stream)
+        return false;
+
+    std::streamoff size = stream.tellg();
+    out.resize((size_t)size);
+    stream.seekg(0);
+    return size == 0 || (bool)stream.read(&out[0], size);
+}
+
+void ShaderPreprocessor::AppendDefines(std::string& stage, unsigned int nextLine)
+{
+    if (m_Defines.empty())
+        return;
+
+    for (const std::string& define : m_Defines)
+    {
+        stage += "#define ";
+        stage += define;
+        stage += '\n';
+    }
+    stage += LineDirective(nextLine);
+}
+
+bool ShaderPreprocessor::Process(const std::string& filepath, ShaderProgramSource& out)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    m_Stats = Stats();
+    m_Files.clear();
+    for (auto& included : m_Included)
+        included.clear();
+
+    std::string stages[(int)ShaderType::COUNT];
+    ShaderType type = ShaderType::NONE;
+    bool ok = ProcessFile(filepath, stages, type, true);
+
+    out.VertexSource = std::move(stages[(int)ShaderType::VERTEX]);
+    out.FragmentSource = std::move(stages[(int)ShaderType::FRAGMENT]);
+    out.ComputeSource = std::move(stages[(int)ShaderType::COMPUTE]);
+    out.Files = std::move(m_Files);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.Milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    s_TotalStats.Milliseconds += m_Stats.Milliseconds;
+    s_TotalStats.Files += m_Stats.Files;
+    s_TotalStats.Bytes += m_Stats.Bytes;
+    s_TotalStats.Includes += m_Stats.Includes;
+    s_TotalStats.SkippedIncludes += m_Stats.SkippedIncludes;
+
+    return ok;
+}
+
+bool ShaderPreprocessor::ProcessFile(const std::string& filepath, std::string* stages, ShaderType& type, bool isMain)
+{
+    /* Recorded before reading, so a shader that failed on a missing include reloads once it exists. */
+    if (std::find(m_Files.begin(), m_Files.end(), filepath) == m_Files.end())
+        m_Files.push_back(filepath);
+
+    std::string text;
+    if (!ReadFile(filepath, text))
+    {
+        std::cout << "Shader preprocessor: can't read " << filepath << std::endl;
+        return false;
+    }
+
+    m_Stats.Files++;
+    m_Stats.Bytes += (unsigned int)text.size();
+
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    const char* pending = cursor; // Start of the text not yet appended to the current stage
+    unsigned int lineNumber = 1;
+    bool warnedPreamble = false;
+
+    while (cursor < end)
+    {
+        const char* lineEnd = (const char*)memchr(cursor, '\n', end - cursor);
+        if (!lineEnd)
+            lineEnd = end;
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+
+        const char* first = cursor;
+        while (first < lineEnd && (*first == ' ' || *first == '\t'))
+            first++;
+
+        const char* rest;
+        if (first < lineEnd && *first == '#')
+        {
+            if (isMain && MatchDirective(first, lineEnd, "#shader", rest))
+            {
+                if (type != ShaderType::NONE)
+                    stages[(int)type].append(pending, cursor);
+
+                if (MatchDirective(rest, lineEnd, "vertex", rest))
+                    type = ShaderType::VERTEX;
+                else if (MatchDirective(rest, lineEnd, "fragment", rest))
+                    type = ShaderType::FRAGMENT;
+                else if (MatchDirective(rest, lineEnd, "compute", rest))
+                    type = ShaderType::COMPUTE;
+                else
+                {
+                    std::cout << filepath << ":" << lineNumber << ": unknown #shader type" << std::endl;
+                    type = ShaderType::NONE;
+                }
+
+                pending = next;
+            }
+            else if (MatchDirective(first, lineEnd, "#include", rest))
+            {
+                if (type != ShaderType::NONE)
+                {
+                    std::string& stage = stages[(int)type];
+                    stage.append(pending, cursor);
+
+                    const char* open = (const char*)memchr(rest, '"', lineEnd - rest);
+                    const char* close = open ? (const char*)memchr(open + 1, '"', lineEnd - open - 1) : nullptr;
+                    if (!close)
+                    {
+                        std::cout << filepath << ":" << lineNumber << ": malformed #include" << std::endl;
+                        return false;
+                    }
+
+                    std::string path = GetDirectory(filepath) + std::string(open + 1, close);
+                    if (m_Included[(int)type].insert(path).second)
+                    {
+                        m_Stats.Includes++;
+                        stage += LineDirective(1);
+                        if (!ProcessFile(path, stages, type, false))
+                            return false;
+                        stage += LineDirective(lineNumber + 1);
+                    }
+                    else
+                    {
+                        m_Stats.SkippedIncludes++;
+                    }
+                }
+                pending = next;
+            }
+            else if (isMain && type != ShaderType::NONE && MatchDirective(first, lineEnd, "#version", rest))
+            {
+                /* Defines can only come after #version, which has to be the first thing in the stage. */
+                std::string& stage = stages[(int)type];
+                stage.append(pending, next);
+                if (next == end)
+                    stage += '\n';
+                AppendDefines(stage, lineNumber + 1);
+                pending = next;
+            }
+        }
+        else if (type == ShaderType::NONE && first < lineEnd && *first != '\r' && isMain && !warnedPreamble)
+        {
+            std::cout << filepath << ":" << lineNumber << ": text before the first #shader directive is ignored" << std::endl;
+            warnedPreamble = true;
+        }
+
+        if (type == ShaderType::NONE)
+            pending = next;
+
+        cursor = next;
+        lineNumber++;
+    }
+
+    if (type != ShaderType::NONE)
+    {
+        std::string& stage = stages[(int)type];
+        stage.append(pending, end);
+        if (!stage.empty() && stage.back() != '\n')
+            stage += '\n';
+    }
+
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Shader.h"
+
+/* Turns a .shader file into the sources of each stage. */
+/*                                                                    */
+/* The file is read with a single read and scanned in place: only lines starting with '#' are looked at, */
+/* and the text between directives is appended to the current stage as whole ranges, not line by line. */
+/*   #shader vertex|fragment|compute  starts a new stage; text before the first one is ignored */
+/*   #include "path"                  pastes a file, relative to the file that includes it, once per stage */
+/* Defines added with AddDefine are injected right after the #version line of every stage, which is how */
+/* permutations of the same file are built. #line directives keep the compiler's line numbers meaningful. */
+class ShaderPreprocessor
+{
+public:
+    struct Stats
+    {
+        double Milliseconds = 0.0;
+        unsigned int Files = 0;           // Files read, the main file included
+        unsigned int Bytes = 0;           // Bytes read from disk
+        unsigned int Includes = 0;        // #include directives that pasted a file
+        unsigned int SkippedIncludes = 0; // #include directives skipped because the file was already pasted
+    };
+
+private:
+    enum class ShaderType { NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2, COUNT = 3 };
+
+    std::vector<std::string> m_Defines;
+    std::unordered_set<std::string> m_Included[(int)ShaderType::COUNT];
+    std::vector<std::string> m_Files;
+    Stats m_Stats;
+
+    static Stats s_TotalStats;
+
+public:
+    /* "NAME" or "NAME VALUE", exactly what would follow #define. */
+    void AddDefine(const std::string& define);
+    void AddDefines(const std::vector<std::string>& defines);
+
+    /* Returns false if the file (or a file it includes) can't be read. */
+    /* out.Files lists every file the result depends on, the main file first. */
+    bool Process(const std::string& filepath, ShaderProgramSource& out);
+
+    inline const Stats& GetStats() const { return m_Stats; }
+
+    /* Accumulated over every Process call of every preprocessor. */
+    static inline const Stats& GetTotalStats() { return s_TotalStats; }
+
+    /* Reads a whole file with one read. */
+    static bool ReadFile(const std::string& filepath, std::string& out);
+
+private:
+    bool ProcessFile(const std::string& filepath, std::string* stages, ShaderType& type, bool isMain);
+    void AppendDefines(std::string& stage, unsigned int nextLine);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+
+/* Hands simulation state over to the renderer, possibly from another thread. */
+/*                                                                    */
+/* The simulation keeps its own working copy and publishes it after every step. The latest two published */
+/* states are kept together, so the renderer always gets a matching pair to interpolate between. */
+/* Publish writes into the back snapshot and Acquire copies it into the front one only if it changed, */
+/* so the lock is held for two copies of State at most and the renderer can use its snapshot as long as it */
+/* likes. State should therefore be small: what rendering needs, not everything the simulation knows. */
+template<typename State>
+class SimulationState
+{
+public:
+    struct Snapshot
+    {
+        State Previous;
+        State Current;
+    };
+
+private:
+    std::mutex m_Mutex;
+    Snapshot m_Back;
+    Snapshot m_Front;
+    bool m_Changed;
+
+public:
+    explicit SimulationState(const State& initial = State())
+        : m_Back{ initial, initial }, m_Front{ initial, initial }, m_Changed(false) {}
+
+    void Publish(const State& state)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Back.Previous = m_Back.Current;
+        m_Back.Current = state;
+        m_Changed = true;
+    }
+
+    const Snapshot& Acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Changed)
+        {
+            m_Front = m_Back;
+            m_Changed = false;
+        }
+        return m_Front;
+    }
+};
@@ -0,0 +1,68 @@
+#include "SimulationThread.h"
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+SimulationThread::SimulationThread(double rate)
+    : m_Running(false), m_LastStepTime(Clock::now().time_since_epoch().count()), m_StepCount(0), m_Step(1.0 / rate)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+void SimulationThread::Start(std::function<void(float)> step)
+{
+    Stop();
+    m_Running = true;
+    m_LastStepTime = Clock::now().time_since_epoch().count();
+    m_Thread = std::thread(&SimulationThread::Run, this, step);
+}
+
+void SimulationThread::Stop()
+{
+    m_Running = false;
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+void SimulationThread::Run(std::function<void(float)> step)
+{
+    FixedTimestep timestep(1.0 / m_Step);
+    Clock::time_point last = Clock::now();
+
+    while (m_Running)
+    {
+        Clock::time_point now = Clock::now();
+        unsigned int steps = timestep.Advance(std::chrono::duration<double>(now - last).count());
+        last = now;
+
+        for (unsigned int i = 0; i < steps; i++)
+            step(timestep.GetStep());
+
+        /* The last step stands for a moment slightly before now, the remainder of the accumulator ago. */
+        if (steps > 0)
+        {
+            Clock::duration remainder = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timestep.GetAlpha() * m_Step));
+            m_LastStepTime = (now - remainder).time_since_epoch().count();
+            m_StepCount += steps;
+        }
+
+        /* Sleep until the next step is due. Waking up late only makes that step a bit late, */
+        /* the accumulator keeps the rate right on average. */
+        double untilNext = (1.0 - timestep.GetAlpha()) * m_Step;
+        std::this_thread::sleep_for(std::chrono::duration<double>(untilNext));
+    }
+}
+
+float SimulationThread::GetAlpha() const
+{
+    Clock::duration sinceStep = Clock::now().time_since_epoch() - Clock::duration(m_LastStepTime.load());
+    double alpha = std::chrono::duration<double>(sinceStep).count() / m_Step;
+    return (float)std::min(std::max(alpha, 0.0), 1.0);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+/* Runs the fixed-step simulation on its own thread, so its cost overlaps with rendering */
+/* instead of adding to the frame time. */
+/*                                                                    */
+/* The step function must not touch OpenGL (the context is current on the main thread) and has */
+/* to hand its results to the renderer through something like SimulationState. */
+class SimulationThread
+{
+private:
+    std::thread m_Thread;
+    std::atomic<bool> m_Running;
+    std::atomic<long long> m_LastStepTime; // steady_clock ticks
+    std::atomic<unsigned int> m_StepCount;
+    double m_Step;
+
+    void Run(std::function<void(float)> step);
+
+public:
+    explicit SimulationThread(double rate = 60.0);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void Start(std::function<void(float)> step);
+    void Stop();
+
+    /* How far the current time is past the last step, as a fraction of a step. */
+    float GetAlpha() const;
+
+    /* Steps run since the last call. */
+    unsigned int TakeStepCount() { return m_StepCount.exchange(0); }
+
+    inline bool IsRunning() const { return m_Running; }
+};
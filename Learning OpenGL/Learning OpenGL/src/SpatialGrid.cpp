@@ -0,0 +1,128 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Renderer.h"
+
+SpatialGrid::SpatialGrid(float minX, float minY, float maxX, float maxY, float cellSize)
+    : m_MinX(minX), m_MinY(minY), m_CellSize(cellSize), m_InvCellSize(1.0f / cellSize),
+      m_MaxHalfWidth(0.0f), m_MaxHalfHeight(0.0f), m_Count(0)
+{
+    ASSERT(maxX > minX && maxY > minY && cellSize > 0.0f);
+    m_Columns = std::max(1, (int)std::ceil((maxX - minX) * m_InvCellSize));
+    m_Rows = std::max(1, (int)std::ceil((maxY - minY) * m_InvCellSize));
+    m_Cells.resize((size_t)m_Columns * m_Rows);
+}
+
+unsigned int SpatialGrid::GetCell(float x, float y) const
+{
+    int column = std::min(std::max((int)std::floor((x - m_MinX) * m_InvCellSize), 0), m_Columns - 1);
+    int row = std::min(std::max((int)std::floor((y - m_MinY) * m_InvCellSize), 0), m_Rows - 1);
+    return (unsigned int)(row * m_Columns + column);
+}
+
+void SpatialGrid::AddToCell(unsigned int cell, const Entry& entry)
+{
+    Object& object = m_Objects[entry.Handle];
+    object.Cell = cell;
+    object.Slot = (unsigned int)m_Cells[cell].size();
+    m_Cells[cell].push_back(entry);
+}
+
+void SpatialGrid::RemoveFromCell(const Object& object)
+{
+    /* The last entry takes the place of the removed one, and its object has to know. */
+    std::vector<Entry>& entries = m_Cells[object.Cell];
+    if (object.Slot + 1 < entries.size())
+    {
+        entries[object.Slot] = entries.back();
+        m_Objects[entries[object.Slot].Handle].Slot = object.Slot;
+    }
+    entries.pop_back();
+}
+
+unsigned int SpatialGrid::Insert(float x, float y, float halfWidth, float halfHeight)
+{
+    unsigned int handle;
+    if (!m_FreeHandles.empty())
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    }
+    else
+    {
+        handle = (unsigned int)m_Objects.size();
+        m_Objects.push_back(Object());
+    }
+
+    m_MaxHalfWidth = std::max(m_MaxHalfWidth, halfWidth);
+    m_MaxHalfHeight = std::max(m_MaxHalfHeight, halfHeight);
+
+    AddToCell(GetCell(x, y), Entry{ handle, x, y, halfWidth, halfHeight });
+    m_Count++;
+    return handle;
+}
+
+void SpatialGrid::Remove(unsigned int handle)
+{
+    Object& object = m_Objects[handle];
+    ASSERT(object.Cell != ~0u);
+    RemoveFromCell(object);
+    object.Cell = ~0u;
+    m_FreeHandles.push_back(handle);
+    m_Count--;
+}
+
+void SpatialGrid::Move(unsigned int handle, float x, float y)
+{
+    const Object object = m_Objects[handle];
+    ASSERT(object.Cell != ~0u);
+
+    Entry& entry = m_Cells[object.Cell][object.Slot];
+    const unsigned int cell = GetCell(x, y);
+    if (cell == object.Cell)
+    {
+        /* By far the common case for anything slower than a cell per frame. */
+        entry.X = x;
+        entry.Y = y;
+        return;
+    }
+
+    Entry moved = entry;
+    moved.X = x;
+    moved.Y = y;
+    RemoveFromCell(object);
+    AddToCell(cell, moved);
+}
+
+unsigned int SpatialGrid::Query(float minX, float minY, float maxX, float maxY, std::vector<unsigned int>& result)
+{
+    m_Stats = Stats();
+
+    /* An object overlapping the rectangle can have its center up to its half extent outside of it. */
+    const unsigned int first = GetCell(minX - m_MaxHalfWidth, minY - m_MaxHalfHeight);
+    const unsigned int last = GetCell(maxX + m_MaxHalfWidth, maxY + m_MaxHalfHeight);
+    const unsigned int firstColumn = first % m_Columns, lastColumn = last % m_Columns;
+    const unsigned int firstRow = first / m_Columns, lastRow = last / m_Columns;
+
+    const size_t initialSize = result.size();
+    for (unsigned int row = firstRow; row <= lastRow; row++)
+    {
+        for (unsigned int column = firstColumn; column <= lastColumn; column++)
+        {
+            const std::vector<Entry>& entries = m_Cells[row * m_Columns + column];
+            for (const Entry& entry : entries)
+            {
+                if (entry.X + entry.HalfWidth >= minX && entry.X - entry.HalfWidth <= maxX
+                    && entry.Y + entry.HalfHeight >= minY && entry.Y - entry.HalfHeight <= maxY)
+                    result.push_back(entry.Handle);
+            }
+            m_Stats.ObjectsTested += (unsigned int)entries.size();
+        }
+    }
+
+    m_Stats.CellsVisited = (lastRow - firstRow + 1) * (lastColumn - firstColumn + 1);
+    m_Stats.ObjectsFound = (unsigned int)(result.size() - initialSize);
+    return m_Stats.ObjectsFound;
+}
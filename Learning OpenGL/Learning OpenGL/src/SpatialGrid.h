@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+/* A loose uniform grid over a 2D world, to find the objects that overlap a rectangle (the camera) */
+/* without looking at all of them. */
+/*                                                                    */
+/* Each object lives in the one cell that holds its center, whatever its size. A query therefore grows */
+/* its rectangle by the largest half extent ever inserted, visits the cells under it and tests the */
+/* bounds of every object found there. Keeping objects in a single cell makes moving them cheap: */
+/* Move only updates the stored center, unless the center crosses into another cell, where it is a */
+/* swap-remove from one list and a push onto another. Cells store the bounds next to the handles, */
+/* so a query reads each cell's list front to back and never the object table. */
+/* Cell size is the tuning knob: too small and queries visit many empty cells, too large and they test */
+/* many objects outside the rectangle. The query stats show which. Objects outside the grid's bounds */
+/* are kept in its border cells, they are found correctly but make those cells expensive. */
+class SpatialGrid
+{
+public:
+    struct Stats
+    {
+        unsigned int CellsVisited = 0;
+        unsigned int ObjectsTested = 0;
+        unsigned int ObjectsFound = 0;
+    };
+
+private:
+    struct Entry
+    {
+        unsigned int Handle;
+        float X, Y;                   // Center
+        float HalfWidth, HalfHeight;
+    };
+
+    struct Object
+    {
+        unsigned int Cell; // ~0u while the handle is free
+        unsigned int Slot; // Index in the cell's entries
+    };
+
+    float m_MinX, m_MinY;
+    float m_CellSize;
+    float m_InvCellSize;
+    int m_Columns, m_Rows;
+    float m_MaxHalfWidth, m_MaxHalfHeight; // Largest ever inserted, how much queries grow by
+
+    std::vector<std::vector<Entry>> m_Cells;
+    std::vector<Object> m_Objects;   // By handle
+    std::vector<unsigned int> m_FreeHandles;
+    unsigned int m_Count;
+
+    Stats m_Stats;
+
+    unsigned int GetCell(float x, float y) const;
+    void AddToCell(unsigned int cell, const Entry& entry);
+    void RemoveFromCell(const Object& object);
+
+public:
+    /* The world is [minX, maxX) x [minY, maxY), split into square cells of cellSize. */
+    SpatialGrid(float minX, float minY, float maxX, float maxY, float cellSize);
+
+    /* Returns the handle of the new object, which stays valid until it is removed. */
+    unsigned int Insert(float x, float y, float halfWidth, float halfHeight);
+    void Remove(unsigned int handle);
+
+    /* Moves the center of an object, its size stays the same. */
+    void Move(unsigned int handle, float x, float y);
+
+    /* Appends the handles of every object overlapping [minX, maxX] x [minY, maxY] to result, in no */
+    /* particular order. Returns how many were appended. */
+    unsigned int Query(float minX, float minY, float maxX, float maxY, std::vector<unsigned int>& result);
+
+    /* Of the last query. */
+    inline const Stats& GetStats() const { return m_Stats; }
+
+    inline unsigned int GetCount() const { return m_Count; }
+    inline unsigned int GetCellCount() const { return (unsigned int)m_Cells.size(); }
+    inline float GetCellSize() const { return m_CellSize; }
+};
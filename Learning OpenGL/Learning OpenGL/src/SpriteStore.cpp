@@ -0,0 +1,385 @@
+#include "SpriteStore.h"
+#include "Renderer.h"
+
+#include <cmath>
+
+/* SSE2 is part of x64, and 32 bit builds only get it when the compiler may assume it. */
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define SPRITES_SSE2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SPRITES_TARGET_AVX2
+#else
+/* GCC and Clang only emit AVX2 and FMA instructions in functions marked for them, the rest of the */
+/* program keeps the baseline instruction set and the kernel is only called after checking the CPU. */
+#define SPRITES_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+/* What every kernel reads, already offset to the first sprite to write. */
+struct SpriteRange
+{
+    const float* X;
+    const float* Y;
+    const float* Rotation;
+    const float* Width;
+    const float* Height;
+    const uint32_t* Color;
+};
+
+static const float InvColorScale = 1.0f / 255.0f;
+
+static void WriteScalar(const SpriteRange& sprites, QuadVertex* out, unsigned int count, float texIndex)
+{
+    static const float texCoords[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const float c = std::cos(sprites.Rotation[i]);
+        const float s = std::sin(sprites.Rotation[i]);
+        const float hx = sprites.Width[i] * 0.5f;
+        const float hy = sprites.Height[i] * 0.5f;
+
+        /* The half extents rotated, the corners are the center plus or minus each of them. */
+        const float a = hx * c, b = hx * s;
+        const float d = hy * s, e = hy * c;
+        const float xpd = sprites.X[i] + d, xmd = sprites.X[i] - d;
+        const float ype = sprites.Y[i] + e, yme = sprites.Y[i] - e;
+        const float positions[4][2] = { { xpd - a, yme - b }, { xpd + a, yme + b }, { xmd + a, ype + b }, { xmd - a, ype - b } };
+
+        const uint32_t color = sprites.Color[i];
+        const float rgba[4] = { (float)(color & 0xff) * InvColorScale, (float)(color >> 8 & 0xff) * InvColorScale,
+            (float)(color >> 16 & 0xff) * InvColorScale, (float)(color >> 24) * InvColorScale };
+
+        QuadVertex* vertex = &out[i * 4];
+        for (int k = 0; k < 4; k++)
+        {
+            vertex[k].Position[0] = positions[k][0];
+            vertex[k].Position[1] = positions[k][1];
+            vertex[k].Color[0] = rgba[0];
+            vertex[k].Color[1] = rgba[1];
+            vertex[k].Color[2] = rgba[2];
+            vertex[k].Color[3] = rgba[3];
+            vertex[k].TexCoords[0] = texCoords[k][0];
+            vertex[k].TexCoords[1] = texCoords[k][1];
+            vertex[k].TexIndex = texIndex;
+        }
+    }
+}
+
+#if SPRITES_SSE2
+
+/* The sine and cosine polynomials of Cephes' sinf and cosf. The angle is reduced to [-pi/4, pi/4] by */
+/* subtracting the nearest multiple j of pi/2, in three parts so the product stays exact, and the quadrant */
+/* j & 3 then swaps and negates the two results. */
+static const float TwoOverPi = 0.636619772367581343f;
+static const float HalfPi1 = 1.5703125f;
+static const float HalfPi2 = 4.837512969970703125e-4f;
+static const float HalfPi3 = 7.54978995489188216e-8f;
+static const float Sin1 = -1.9515295891e-4f, Sin2 = 8.3321608736e-3f, Sin3 = -1.6666654611e-1f;
+static const float Cos1 = 2.443315711809948e-5f, Cos2 = -1.388731625493765e-3f, Cos3 = 4.166664568298827e-2f;
+
+static inline void SinCos4(__m128 x, __m128& sin, __m128& cos)
+{
+    const __m128i j = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TwoOverPi)));
+    const __m128 fj = _mm_cvtepi32_ps(j);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(fj, _mm_set1_ps(HalfPi1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(fj, _mm_set1_ps(HalfPi2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(fj, _mm_set1_ps(HalfPi3)));
+    const __m128 z = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Sin1), z), _mm_set1_ps(Sin2));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(Sin3));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), r), r);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Cos1), z), _mm_set1_ps(Cos2));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(Cos3));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    /* Odd quadrants swap sine and cosine, sine is negative in quadrants 2 and 3, cosine in 1 and 2. */
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, one), one));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, two), 30));
+    const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, one), two), 30));
+    sin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sinSign);
+    cos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosSign);
+}
+
+/* Each vertex is written front to back with two 16 byte stores, [x y r g] and [b a u v], and the texture */
+/* index. Vertices are 36 bytes, so the stores are unaligned, which costs nothing when they stay sequential. */
+static inline void StoreVertex(QuadVertex& vertex, __m128 positionColor, __m128 colorTexCoords, __m128 texIndex)
+{
+    float* data = (float*)&vertex;
+    _mm_storeu_ps(data, positionColor);
+    _mm_storeu_ps(data + 4, colorTexCoords);
+    _mm_store_ss(&vertex.TexIndex, texIndex);
+}
+
+/* Turns 4 sprites, one per lane, into their 16 vertices. The lanes are transposed two sprites at a time: */
+/* interleaving x with y and r with g gives [x0 y0 x1 y1] and [r0 g0 r1 g1], and a shuffle of the two */
+/* halves is the first store of either sprite. */
+static inline void StoreQuads4(QuadVertex* out, const __m128 cornerX[4], const __m128 cornerY[4],
+    __m128 r, __m128 g, __m128 b, __m128 a, __m128 texIndex)
+{
+    const __m128 texCoords[4] = { _mm_setr_ps(0.0f, 0.0f, 0.0f, 0.0f), _mm_setr_ps(1.0f, 0.0f, 1.0f, 0.0f),
+        _mm_setr_ps(1.0f, 1.0f, 1.0f, 1.0f), _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f) };
+
+    for (int pair = 0; pair < 2; pair++)
+    {
+        const __m128 rg = pair ? _mm_unpackhi_ps(r, g) : _mm_unpacklo_ps(r, g);
+        const __m128 ba = pair ? _mm_unpackhi_ps(b, a) : _mm_unpacklo_ps(b, a);
+        __m128 xy[4];
+        for (int k = 0; k < 4; k++)
+            xy[k] = pair ? _mm_unpackhi_ps(cornerX[k], cornerY[k]) : _mm_unpacklo_ps(cornerX[k], cornerY[k]);
+
+        QuadVertex* vertex = &out[pair * 8];
+        for (int k = 0; k < 4; k++)
+            StoreVertex(vertex[k], _mm_shuffle_ps(xy[k], rg, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm_shuffle_ps(ba, texCoords[k], _MM_SHUFFLE(1, 0, 1, 0)), texIndex);
+        for (int k = 0; k < 4; k++)
+            StoreVertex(vertex[4 + k], _mm_shuffle_ps(xy[k], rg, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm_shuffle_ps(ba, texCoords[k], _MM_SHUFFLE(1, 0, 3, 2)), texIndex);
+    }
+}
+
+/* Returns how many sprites were written, a multiple of 4. */
+static unsigned int WriteSSE2(const SpriteRange& sprites, QuadVertex* out, unsigned int count, float texIndex)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 colorScale = _mm_set1_ps(InvColorScale);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128 index = _mm_set1_ps(texIndex);
+
+    const unsigned int end = count & ~3u;
+    for (unsigned int i = 0; i < end; i += 4)
+    {
+        __m128 s, c;
+        SinCos4(_mm_loadu_ps(&sprites.Rotation[i]), s, c);
+        const __m128 hx = _mm_mul_ps(_mm_loadu_ps(&sprites.Width[i]), half);
+        const __m128 hy = _mm_mul_ps(_mm_loadu_ps(&sprites.Height[i]), half);
+        const __m128 x = _mm_loadu_ps(&sprites.X[i]);
+        const __m128 y = _mm_loadu_ps(&sprites.Y[i]);
+
+        const __m128 a = _mm_mul_ps(hx, c), b = _mm_mul_ps(hx, s);
+        const __m128 d = _mm_mul_ps(hy, s), e = _mm_mul_ps(hy, c);
+        const __m128 xpd = _mm_add_ps(x, d), xmd = _mm_sub_ps(x, d);
+        const __m128 ype = _mm_add_ps(y, e), yme = _mm_sub_ps(y, e);
+        const __m128 cornerX[4] = { _mm_sub_ps(xpd, a), _mm_add_ps(xpd, a), _mm_add_ps(xmd, a), _mm_sub_ps(xmd, a) };
+        const __m128 cornerY[4] = { _mm_sub_ps(yme, b), _mm_add_ps(yme, b), _mm_add_ps(ype, b), _mm_sub_ps(ype, b) };
+
+        const __m128i color = _mm_loadu_si128((const __m128i*)&sprites.Color[i]);
+        const __m128 red = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(color, byteMask)), colorScale);
+        const __m128 green = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color, 8), byteMask)), colorScale);
+        const __m128 blue = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color, 16), byteMask)), colorScale);
+        const __m128 alpha = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(color, 24)), colorScale);
+
+        StoreQuads4(&out[i * 4], cornerX, cornerY, red, green, blue, alpha, index);
+    }
+    return end;
+}
+
+/* The same as SinCos4 on 8 lanes, with the multiply-adds fused. */
+SPRITES_TARGET_AVX2
+static inline void SinCos8(__m256 x, __m256& sin, __m256& cos)
+{
+    const __m256i j = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi)));
+    const __m256 fj = _mm256_cvtepi32_ps(j);
+    __m256 r = _mm256_fnmadd_ps(fj, _mm256_set1_ps(HalfPi1), x);
+    r = _mm256_fnmadd_ps(fj, _mm256_set1_ps(HalfPi2), r);
+    r = _mm256_fnmadd_ps(fj, _mm256_set1_ps(HalfPi3), r);
+    const __m256 z = _mm256_mul_ps(r, r);
+
+    __m256 s = _mm256_fmadd_ps(_mm256_set1_ps(Sin1), z, _mm256_set1_ps(Sin2));
+    s = _mm256_fmadd_ps(s, z, _mm256_set1_ps(Sin3));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, z), r, r);
+
+    __m256 c = _mm256_fmadd_ps(_mm256_set1_ps(Cos1), z, _mm256_set1_ps(Cos2));
+    c = _mm256_fmadd_ps(c, z, _mm256_set1_ps(Cos3));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+    c = _mm256_add_ps(_mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), c), _mm256_set1_ps(1.0f));
+
+    const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2);
+    const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, one), one));
+    const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, two), 30));
+    const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(j, one), two), 30));
+    sin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+    cos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+/* Returns how many sprites were written, a multiple of 8. The math runs on 8 lanes, the stores go */
+/* through StoreQuads4 one half at a time, 256 bit shuffles only work within 128 bit lanes anyway. */
+SPRITES_TARGET_AVX2
+static unsigned int WriteAVX2(const SpriteRange& sprites, QuadVertex* out, unsigned int count, float texIndex)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 colorScale = _mm256_set1_ps(InvColorScale);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m128 index = _mm_set1_ps(texIndex);
+
+    const unsigned int end = count & ~7u;
+    for (unsigned int i = 0; i < end; i += 8)
+    {
+        __m256 s, c;
+        SinCos8(_mm256_loadu_ps(&sprites.Rotation[i]), s, c);
+        const __m256 hx = _mm256_mul_ps(_mm256_loadu_ps(&sprites.Width[i]), half);
+        const __m256 hy = _mm256_mul_ps(_mm256_loadu_ps(&sprites.Height[i]), half);
+        const __m256 x = _mm256_loadu_ps(&sprites.X[i]);
+        const __m256 y = _mm256_loadu_ps(&sprites.Y[i]);
+
+        const __m256 a = _mm256_mul_ps(hx, c), b = _mm256_mul_ps(hx, s);
+        const __m256 d = _mm256_mul_ps(hy, s), e = _mm256_mul_ps(hy, c);
+        const __m256 xpd = _mm256_add_ps(x, d), xmd = _mm256_sub_ps(x, d);
+        const __m256 ype = _mm256_add_ps(y, e), yme = _mm256_sub_ps(y, e);
+        const __m256 cornerX[4] = { _mm256_sub_ps(xpd, a), _mm256_add_ps(xpd, a), _mm256_add_ps(xmd, a), _mm256_sub_ps(xmd, a) };
+        const __m256 cornerY[4] = { _mm256_sub_ps(yme, b), _mm256_add_ps(yme, b), _mm256_add_ps(ype, b), _mm256_sub_ps(ype, b) };
+
+        const __m256i color = _mm256_loadu_si256((const __m256i*)&sprites.Color[i]);
+        const __m256 rgba[4] = {
+            _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(color, byteMask)), colorScale),
+            _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(color, 8), byteMask)), colorScale),
+            _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(color, 16), byteMask)), colorScale),
+            _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(color, 24)), colorScale)
+        };
+
+        __m128 lowX[4], lowY[4], highX[4], highY[4];
+        for (int k = 0; k < 4; k++)
+        {
+            lowX[k] = _mm256_castps256_ps128(cornerX[k]);
+            lowY[k] = _mm256_castps256_ps128(cornerY[k]);
+            highX[k] = _mm256_extractf128_ps(cornerX[k], 1);
+            highY[k] = _mm256_extractf128_ps(cornerY[k], 1);
+        }
+
+        StoreQuads4(&out[i * 4], lowX, lowY, _mm256_castps256_ps128(rgba[0]), _mm256_castps256_ps128(rgba[1]),
+            _mm256_castps256_ps128(rgba[2]), _mm256_castps256_ps128(rgba[3]), index);
+        StoreQuads4(&out[i * 4 + 16], highX, highY, _mm256_extractf128_ps(rgba[0], 1), _mm256_extractf128_ps(rgba[1], 1),
+            _mm256_extractf128_ps(rgba[2], 1), _mm256_extractf128_ps(rgba[3], 1), index);
+    }
+    return end;
+}
+
+static bool CpuHasAVX2()
+{
+#ifdef _MSC_VER
+    /* AVX needs the OS to save the upper halves of the registers, which XCR0 bits 1 and 2 say it does. */
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || !fma || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    /* The runtime checks XCR0 too. */
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#endif
+
+SpriteStore::SpriteStore(unsigned int capacity)
+{
+    m_X.reserve(capacity);
+    m_Y.reserve(capacity);
+    m_Rotation.reserve(capacity);
+    m_Width.reserve(capacity);
+    m_Height.reserve(capacity);
+    m_Color.reserve(capacity);
+}
+
+unsigned int SpriteStore::Add(float x, float y, float rotation, float width, float height, uint32_t color)
+{
+    m_X.push_back(x);
+    m_Y.push_back(y);
+    m_Rotation.push_back(rotation);
+    m_Width.push_back(width);
+    m_Height.push_back(height);
+    m_Color.push_back(color);
+    return GetCount() - 1;
+}
+
+void SpriteStore::Clear()
+{
+    m_X.clear();
+    m_Y.clear();
+    m_Rotation.clear();
+    m_Width.clear();
+    m_Height.clear();
+    m_Color.clear();
+}
+
+void SpriteStore::WriteVertices(QuadVertex* out, unsigned int first, unsigned int count, float texIndex, Kernel kernel) const
+{
+    ASSERT(first + count <= GetCount());
+    if (count == 0)
+        return;
+
+    SpriteRange sprites = { m_X.data() + first, m_Y.data() + first, m_Rotation.data() + first, m_Width.data() + first,
+        m_Height.data() + first, m_Color.data() + first };
+    unsigned int written = 0;
+
+#if SPRITES_SSE2
+    if (kernel == Kernel::AVX2 && IsSupported(Kernel::AVX2))
+        written = WriteAVX2(sprites, out, count, texIndex);
+
+    if (kernel != Kernel::Scalar && count - written >= 4)
+    {
+        SpriteRange rest = { sprites.X + written, sprites.Y + written, sprites.Rotation + written, sprites.Width + written,
+            sprites.Height + written, sprites.Color + written };
+        written += WriteSSE2(rest, &out[written * 4], count - written, texIndex);
+    }
+#endif
+
+    if (written < count)
+    {
+        SpriteRange rest = { sprites.X + written, sprites.Y + written, sprites.Rotation + written, sprites.Width + written,
+            sprites.Height + written, sprites.Color + written };
+        WriteScalar(rest, &out[written * 4], count - written, texIndex);
+    }
+}
+
+bool SpriteStore::IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Scalar:
+        return true;
+#if SPRITES_SSE2
+    case Kernel::SSE2:
+        return true;
+    case Kernel::AVX2:
+    {
+        static const bool supported = CpuHasAVX2();
+        return supported;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+SpriteStore::Kernel SpriteStore::GetBestKernel()
+{
+    if (IsSupported(Kernel::AVX2))
+        return Kernel::AVX2;
+    if (IsSupported(Kernel::SSE2))
+        return Kernel::SSE2;
+    return Kernel::Scalar;
+}
+
+const char* SpriteStore::GetKernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::SSE2:
+        return "SSE2";
+    case Kernel::AVX2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
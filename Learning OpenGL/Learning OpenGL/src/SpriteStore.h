@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "BatchRenderer.h"
+
+/* Many sprites stored as a structure of arrays, turned into batch renderer quads in one pass. */
+/*                                                                    */
+/* Each attribute is its own tightly packed array, so the transform reads exactly the bytes it needs and */
+/* loads 4 (SSE2) or 8 (AVX2) sprites per instruction. A sprite is a rotated rectangle around its center: */
+/* its four corners come from one sin/cos pair, evaluated with a polynomial in the SIMD kernels (within */
+/* a few 1e-7 of std::sin and std::cos over a full turn), against two library calls per sprite on the */
+/* scalar path. Vertices are written in order with whole 16 byte stores, which is what write-combined */
+/* memory like a mapped StreamBuffer wants. WriteVertices only reads the store, so disjoint ranges can be */
+/* written from several threads at once, see SceneSprites. */
+class SpriteStore
+{
+public:
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+private:
+    std::vector<float> m_X;        // Center
+    std::vector<float> m_Y;
+    std::vector<float> m_Rotation; // Radians, counter-clockwise
+    std::vector<float> m_Width;
+    std::vector<float> m_Height;
+    std::vector<uint32_t> m_Color; // RGBA8, red in the lowest byte
+
+public:
+    explicit SpriteStore(unsigned int capacity = 0);
+
+    /* Returns the index of the new sprite. */
+    unsigned int Add(float x, float y, float rotation, float width, float height, uint32_t color);
+    void Clear();
+
+    inline unsigned int GetCount() const { return (unsigned int)m_X.size(); }
+
+    /* The arrays themselves, to update sprites in place in the same data-oriented way. */
+    inline float* GetX() { return m_X.data(); }
+    inline float* GetY() { return m_Y.data(); }
+    inline float* GetRotation() { return m_Rotation.data(); }
+    inline float* GetWidth() { return m_Width.data(); }
+    inline float* GetHeight() { return m_Height.data(); }
+    inline uint32_t* GetColor() { return m_Color.data(); }
+
+    /* Writes the 4 vertices of sprites [first, first + count) to out, in the corner and texture coordinate */
+    /* order of BatchRenderer::DrawQuad. texIndex is the batch texture slot, 0 for untextured sprites. */
+    /* The SIMD kernels work on 8 or 4 sprites at a time and leave the rest to the next narrower one. */
+    /* Their sine and cosine are accurate for rotations within a few hundred turns, so wrap larger ones. */
+    void WriteVertices(QuadVertex* out, unsigned int first, unsigned int count, float texIndex, Kernel kernel) const;
+
+    /* Whether the build and the CPU both support kernel. Scalar always is. */
+    static bool IsSupported(Kernel kernel);
+    static Kernel GetBestKernel();
+    static const char* GetKernelName(Kernel kernel);
+
+    static inline uint32_t PackColor(float r, float g, float b, float a)
+    {
+        return (uint32_t)(r * 255.0f + 0.5f) | (uint32_t)(g * 255.0f + 0.5f) << 8 | (uint32_t)(b * 255.0f + 0.5f) << 16
+            | (uint32_t)(a * 255.0f + 0.5f) << 24;
+    }
+};
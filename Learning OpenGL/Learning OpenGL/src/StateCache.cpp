@@ -0,0 +1,266 @@
+#include "StateCache.h"
+
+#include "Renderer.h"
+
+/* A fresh context starts with everything unbound and the default fixed function state. */
+unsigned int StateCache::s_Program = 0;
+unsigned int StateCache::s_VertexArray = 0;
+unsigned int StateCache::s_Buffers[BufferSlotCount] = {};
+std::unordered_map<unsigned int, unsigned int> StateCache::s_ElementBuffers;
+unsigned int StateCache::s_ActiveTexture = 0;
+StateCache::TextureBinding StateCache::s_Textures[MaxTextureUnits] = {};
+
+int StateCache::s_Blend = 0;
+GLenum StateCache::s_BlendSrc = GL_ONE;
+GLenum StateCache::s_BlendDst = GL_ZERO;
+int StateCache::s_DepthTest = 0;
+int StateCache::s_DepthMask = 1;
+GLenum StateCache::s_DepthFunc = GL_LESS;
+int StateCache::s_CullFace = 0;
+
+StateCache::Stats StateCache::s_Stats;
+
+int StateCache::GetBufferSlot(GLenum target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:              return ArrayBuffer;
+        case GL_UNIFORM_BUFFER:            return UniformBuffer;
+        case GL_COPY_READ_BUFFER:          return CopyReadBuffer;
+        case GL_COPY_WRITE_BUFFER:         return CopyWriteBuffer;
+        case GL_PIXEL_PACK_BUFFER:         return PixelPackBuffer;
+        case GL_PIXEL_UNPACK_BUFFER:       return PixelUnpackBuffer;
+        case GL_DRAW_INDIRECT_BUFFER:      return DrawIndirectBuffer;
+        case GL_DISPATCH_INDIRECT_BUFFER:  return DispatchIndirectBuffer;
+        case GL_SHADER_STORAGE_BUFFER:     return ShaderStorageBuffer;
+        case GL_TEXTURE_BUFFER:            return TextureBuffer;
+        default:                           return -1;
+    }
+}
+
+void StateCache::UseProgram(unsigned int program)
+{
+    if (s_Program == program && Skip())
+        return;
+
+    GLCall(glUseProgram(program));
+    s_Program = program;
+    s_Stats.Issued++;
+}
+
+void StateCache::BindVertexArray(unsigned int vertexArray)
+{
+    if (s_VertexArray == vertexArray && Skip())
+        return;
+
+    GLCall(glBindVertexArray(vertexArray));
+    s_VertexArray = vertexArray;
+    s_Stats.Issued++;
+}
+
+void StateCache::BindBuffer(GLenum target, unsigned int buffer)
+{
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        /* Binding an element buffer modifies the currently bound vertex array, so it is tracked per VAO. */
+        auto it = s_ElementBuffers.find(s_VertexArray);
+        if (it != s_ElementBuffers.end() && it->second == buffer && Skip())
+            return;
+
+        GLCall(glBindBuffer(target, buffer));
+        s_ElementBuffers[s_VertexArray] = buffer;
+        s_Stats.Issued++;
+        return;
+    }
+
+    int slot = GetBufferSlot(target);
+    if (slot >= 0 && s_Buffers[slot] == buffer && Skip())
+        return;
+
+    GLCall(glBindBuffer(target, buffer));
+    if (slot >= 0)
+        s_Buffers[slot] = buffer;
+    s_Stats.Issued++;
+}
+
+void StateCache::BindBufferBase(GLenum target, unsigned int index, unsigned int buffer)
+{
+    GLCall(glBindBufferBase(target, index, buffer));
+    int slot = GetBufferSlot(target);
+    if (slot >= 0)
+        s_Buffers[slot] = buffer;
+    s_Stats.Issued++;
+}
+
+void StateCache::ActiveTexture(unsigned int unit)
+{
+    if (s_ActiveTexture == unit)
+        return;
+
+    GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+    s_ActiveTexture = unit;
+    s_Stats.Issued++;
+}
+
+void StateCache::BindTexture(unsigned int unit, GLenum target, unsigned int texture)
+{
+    ASSERT(unit < MaxTextureUnits);
+
+    /* Only the last target bound on each unit is remembered. That can cost a redundant bind */
+    /* when one unit is used with several targets, but it can never skip a bind that was needed. */
+    TextureBinding& binding = s_Textures[unit];
+    if (binding.Target == target && binding.Texture == texture && Skip())
+        return;
+
+    ActiveTexture(unit);
+    GLCall(glBindTexture(target, texture));
+    binding.Target = target;
+    binding.Texture = texture;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetBlend(bool enabled)
+{
+    if (s_Blend == (int)enabled && Skip())
+        return;
+
+    if (enabled)
+    {
+        GLCall(glEnable(GL_BLEND));
+    }
+    else
+    {
+        GLCall(glDisable(GL_BLEND));
+    }
+    s_Blend = enabled;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetBlendFunc(GLenum src, GLenum dst)
+{
+    if (s_BlendSrc == src && s_BlendDst == dst && Skip())
+        return;
+
+    GLCall(glBlendFunc(src, dst));
+    s_BlendSrc = src;
+    s_BlendDst = dst;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetDepthTest(bool enabled)
+{
+    if (s_DepthTest == (int)enabled && Skip())
+        return;
+
+    if (enabled)
+    {
+        GLCall(glEnable(GL_DEPTH_TEST));
+    }
+    else
+    {
+        GLCall(glDisable(GL_DEPTH_TEST));
+    }
+    s_DepthTest = enabled;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetDepthMask(bool enabled)
+{
+    if (s_DepthMask == (int)enabled && Skip())
+        return;
+
+    GLCall(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+    s_DepthMask = enabled;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetDepthFunc(GLenum func)
+{
+    if (s_DepthFunc == func && Skip())
+        return;
+
+    GLCall(glDepthFunc(func));
+    s_DepthFunc = func;
+    s_Stats.Issued++;
+}
+
+void StateCache::SetCullFace(bool enabled)
+{
+    if (s_CullFace == (int)enabled && Skip())
+        return;
+
+    if (enabled)
+    {
+        GLCall(glEnable(GL_CULL_FACE));
+    }
+    else
+    {
+        GLCall(glDisable(GL_CULL_FACE));
+    }
+    s_CullFace = enabled;
+    s_Stats.Issued++;
+}
+
+void StateCache::OnDeleteProgram(unsigned int program)
+{
+    /* A program that is in use is only flagged for deletion, it stays current until something else is used. */
+    (void)program;
+}
+
+void StateCache::OnDeleteVertexArray(unsigned int vertexArray)
+{
+    if (s_VertexArray == vertexArray)
+        s_VertexArray = 0;
+    s_ElementBuffers.erase(vertexArray);
+}
+
+void StateCache::OnDeleteBuffer(unsigned int buffer)
+{
+    for (unsigned int& bound : s_Buffers)
+    {
+        if (bound == buffer)
+            bound = 0;
+    }
+
+    /* Only the current VAO loses the binding, but the name may be reused, so we forget it everywhere. */
+    for (auto it = s_ElementBuffers.begin(); it != s_ElementBuffers.end();)
+    {
+        if (it->second == buffer)
+            it = s_ElementBuffers.erase(it);
+        else
+            ++it;
+    }
+}
+
+void StateCache::OnDeleteTexture(unsigned int texture)
+{
+    for (TextureBinding& binding : s_Textures)
+    {
+        if (binding.Texture == texture)
+            binding.Texture = 0;
+    }
+}
+
+void StateCache::Invalidate()
+{
+    s_Program = Unknown;
+    s_VertexArray = Unknown;
+    for (unsigned int& bound : s_Buffers)
+        bound = Unknown;
+    s_ElementBuffers.clear();
+    s_ActiveTexture = Unknown;
+    for (TextureBinding& binding : s_Textures)
+        binding.Texture = Unknown;
+
+    s_Blend = -1;
+    s_BlendSrc = s_BlendDst = Unknown;
+    s_DepthTest = -1;
+    s_DepthMask = -1;
+    s_DepthFunc = Unknown;
+    s_CullFace = -1;
+}
+
+void StateCache::ResetStats()
+{
+    s_Stats = Stats();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <unordered_map>
+
+/* Remembers what is currently bound in the (single) OpenGL context and drops every bind or state change */
+/* that would not change anything. The driver validates each of those calls even when they are no-ops, */
+/* which adds up at thousands of draws per frame. */
+/*                                                                    */
+/* Everything that binds programs, vertex arrays, buffers or textures, or toggles blending and depth state, */
+/* has to go through here, otherwise the cache goes out of sync. Code that touches the state directly */
+/* can call Invalidate afterwards. Deleting an object must be reported with the matching OnDelete function, */
+/* because OpenGL silently unbinds deleted objects. */
+class StateCache
+{
+public:
+    struct Stats
+    {
+        unsigned int Issued = 0;  // Calls that reached OpenGL
+        unsigned int Skipped = 0; // Redundant calls that were dropped
+    };
+
+    static const unsigned int MaxTextureUnits = 32;
+
+private:
+    enum BufferSlot
+    {
+        ArrayBuffer, UniformBuffer, CopyReadBuffer, CopyWriteBuffer, PixelPackBuffer, PixelUnpackBuffer,
+        DrawIndirectBuffer, DispatchIndirectBuffer, ShaderStorageBuffer, TextureBuffer, BufferSlotCount
+    };
+
+    struct TextureBinding
+    {
+        GLenum Target;
+        unsigned int Texture;
+    };
+
+    static const unsigned int Unknown = 0xffffffff;
+
+    static unsigned int s_Program;
+    static unsigned int s_VertexArray;
+    static unsigned int s_Buffers[BufferSlotCount];
+    static std::unordered_map<unsigned int, unsigned int> s_ElementBuffers; // The element buffer is VAO state
+    static unsigned int s_ActiveTexture;
+    static TextureBinding s_Textures[MaxTextureUnits];
+
+    static int s_Blend;
+    static GLenum s_BlendSrc, s_BlendDst;
+    static int s_DepthTest;
+    static int s_DepthMask;
+    static GLenum s_DepthFunc;
+    static int s_CullFace;
+
+    static Stats s_Stats;
+
+public:
+    static void UseProgram(unsigned int program);
+    static void BindVertexArray(unsigned int vertexArray);
+    static void BindBuffer(GLenum target, unsigned int buffer);
+    static void BindTexture(unsigned int unit, GLenum target, unsigned int texture);
+
+    /* Indexed bindings are not cached, but glBindBufferBase also replaces the generic binding of target. */
+    static void BindBufferBase(GLenum target, unsigned int index, unsigned int buffer);
+
+    static void SetBlend(bool enabled);
+    static void SetBlendFunc(GLenum src, GLenum dst);
+    static void SetDepthTest(bool enabled);
+    static void SetDepthMask(bool enabled);
+    static void SetDepthFunc(GLenum func);
+    static void SetCullFace(bool enabled); // Culls back faces, counter-clockwise is front
+
+    static void OnDeleteProgram(unsigned int program);
+    static void OnDeleteVertexArray(unsigned int vertexArray);
+    static void OnDeleteBuffer(unsigned int buffer);
+    static void OnDeleteTexture(unsigned int texture);
+
+    /* Forgets everything, so the next call of each kind always reaches OpenGL. */
+    static void Invalidate();
+
+    static inline const Stats& GetStats() { return s_Stats; }
+    static void ResetStats();
+
+private:
+    static int GetBufferSlot(GLenum target);
+    static void ActiveTexture(unsigned int unit);
+    static inline bool Skip() { s_Stats.Skipped++; return true; }
+};
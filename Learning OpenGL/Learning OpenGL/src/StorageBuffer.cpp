@@ -0,0 +1,40 @@
+#include "StorageBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+StorageBuffer::StorageBuffer(const void* data, unsigned int size)
+    : m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::StorageBuffers, size);
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::StorageBuffers, m_Size);
+}
+
+void StorageBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data));
+}
+
+void StorageBuffer::GetData(void* data, unsigned int size, unsigned int offset) const
+{
+    ASSERT(offset + size <= m_Size);
+    StateCache::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+    GLCall(glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data));
+}
+
+void StorageBuffer::BindBase(unsigned int index) const
+{
+    StateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_RendererID);
+}
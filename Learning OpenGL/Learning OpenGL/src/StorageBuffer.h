@@ -0,0 +1,31 @@
+#pragma once
+
+/* A shader storage buffer object (OpenGL 4.3), the read/write buffers compute shaders work on. */
+/* Unlike uniform buffers they can be as big as the GPU memory allows and the shader declares their */
+/* last member as an unsized array. The data has to follow the std430 layout of the block it backs. */
+class StorageBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Size;
+
+public:
+    /* data may be null, in which case the content is undefined until written. */
+    StorageBuffer(const void* data, unsigned int size);
+    ~StorageBuffer();
+
+    StorageBuffer(const StorageBuffer&) = delete;
+    StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+    void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+    /* Copies the content back to the CPU. This waits for every command writing the buffer, */
+    /* so only call it once those are known to be finished (e.g. their fence has signaled). */
+    void GetData(void* data, unsigned int size, unsigned int offset = 0) const;
+
+    /* Attaches the buffer to binding point index, i.e. layout(std430, binding = index) in the shader. */
+    void BindBase(unsigned int index) const;
+
+    inline unsigned int GetSize() const { return m_Size; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+};
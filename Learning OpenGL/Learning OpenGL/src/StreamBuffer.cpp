@@ -0,0 +1,119 @@
+#include "StreamBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+bool StreamBuffer::IsPersistentMappingSupported()
+{
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+StreamBuffer::StreamBuffer(GLenum target, unsigned int regionSize, unsigned int regionCount)
+    : m_Target(target), m_RegionSize(regionSize), m_RegionCount(regionCount), m_Region(0),
+      m_Persistent(IsPersistentMappingSupported()), m_Mapped(false), m_MappedData(nullptr), m_StallCount(0)
+{
+    ASSERT(regionCount > 0);
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(m_Target, m_RendererID);
+
+    if (m_Persistent)
+    {
+        /* The storage is immutable, so its size and flags can never change. In exchange the driver lets us */
+        /* keep the mapping for the whole lifetime of the buffer, and coherent means we don't need to flush. */
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall(glBufferStorage(m_Target, (GLsizeiptr)m_RegionSize * m_RegionCount, nullptr, flags));
+        GLCall(m_MappedData = (unsigned char*)glMapBufferRange(m_Target, 0, (GLsizeiptr)m_RegionSize * m_RegionCount, flags));
+        ASSERT(m_MappedData);
+
+        m_Fences.resize(m_RegionCount, nullptr);
+    }
+    else
+    {
+        m_RegionCount = 1;
+        m_Staging.resize(m_RegionSize);
+        GLCall(glBufferData(m_Target, m_RegionSize, nullptr, GL_STREAM_DRAW));
+    }
+
+    /* Orphaning lets the driver keep a few old copies around too, but it doesn't tell us how many. */
+    GpuMemory::Allocate(GpuMemory::Category::StreamBuffers, (uint64_t)m_RegionSize * m_RegionCount);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+
+    if (m_Persistent)
+    {
+        StateCache::BindBuffer(m_Target, m_RendererID);
+        GLCall(glUnmapBuffer(m_Target));
+    }
+
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::StreamBuffers, (uint64_t)m_RegionSize * m_RegionCount);
+}
+
+void* StreamBuffer::Map()
+{
+    ASSERT(!m_Mapped);
+    m_Mapped = true;
+
+    if (!m_Persistent)
+        return m_Staging.data();
+
+    GLsync& fence = m_Fences[m_Region];
+    if (fence)
+    {
+        /* With enough regions the fence has signalled long ago and this returns immediately. */
+        GLCall(GLenum result = glClientWaitSync(fence, 0, 0));
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            m_StallCount++;
+            do
+            {
+                /* The first wait without the flush bit could wait forever if the fence was never submitted. */
+                GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000)); // 1 ms
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        GLCall(glDeleteSync(fence));
+        fence = nullptr;
+    }
+
+    return m_MappedData + GetOffset();
+}
+
+void StreamBuffer::Unmap(unsigned int size)
+{
+    ASSERT(m_Mapped);
+    ASSERT(size <= m_RegionSize);
+    m_Mapped = false;
+
+    if (m_Persistent || size == 0)
+        return;
+
+    StateCache::BindBuffer(m_Target, m_RendererID);
+    GLCall(glBufferData(m_Target, m_RegionSize, nullptr, GL_STREAM_DRAW)); // Orphan the old storage
+    GLCall(glBufferSubData(m_Target, 0, size, m_Staging.data()));
+}
+
+void StreamBuffer::Lock()
+{
+    if (!m_Persistent)
+        return;
+
+    GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_Region = (m_Region + 1) % m_RegionCount;
+}
+
+void StreamBuffer::Bind() const
+{
+    StateCache::BindBuffer(m_Target, m_RendererID);
+}
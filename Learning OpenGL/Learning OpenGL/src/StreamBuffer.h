@@ -0,0 +1,62 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+/* A buffer for data that is rewritten every frame (or every batch). */
+/*                                                                    */
+/* With OpenGL 4.4 / GL_ARB_buffer_storage the buffer is allocated once with glBufferStorage and mapped */
+/* persistently and coherently, so the CPU writes straight into memory the GPU reads from. The storage */
+/* is split into regionCount regions used as a ring: each region is fenced with glFenceSync after the */
+/* draws that read it, and we only wait on that fence when the ring wraps around to it again. */
+/*                                                                    */
+/* On plain 3.3 contexts we fall back to a CPU staging copy that is uploaded with glBufferSubData */
+/* right after orphaning the buffer with glBufferData(nullptr), so the driver can hand us fresh storage */
+/* instead of waiting for the GPU to be done with the old one. */
+class StreamBuffer
+{
+private:
+    unsigned int m_RendererID;
+    GLenum m_Target;
+    unsigned int m_RegionSize;
+    unsigned int m_RegionCount;
+    unsigned int m_Region;
+    bool m_Persistent;
+    bool m_Mapped;
+
+    unsigned char* m_MappedData;           // Start of the persistent mapping
+    std::vector<unsigned char> m_Staging;  // Fallback path only
+    std::vector<GLsync> m_Fences;          // One per region, null when the region is free
+
+    unsigned int m_StallCount; // How many times Map had to wait for the GPU
+
+public:
+    StreamBuffer(GLenum target, unsigned int regionSize, unsigned int regionCount = 3);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /* Returns a pointer to regionSize writable bytes of the current region. */
+    /* Only waits if the GPU is still reading the region from regionCount uses ago. */
+    void* Map();
+
+    /* Ends writing. size is how many bytes were written, starting at the pointer returned by Map. */
+    void Unmap(unsigned int size);
+
+    /* Must be called after issuing the draw calls that read the current region. */
+    /* Fences the region and moves on to the next one. */
+    void Lock();
+
+    void Bind() const;
+
+    /* Byte offset of the current region inside the buffer. Draws should add it to their vertex/index offset. */
+    inline unsigned int GetOffset() const { return m_Persistent ? m_Region * m_RegionSize : 0; }
+    inline unsigned int GetRegionSize() const { return m_RegionSize; }
+    inline bool IsPersistent() const { return m_Persistent; }
+    inline unsigned int GetStallCount() const { return m_StallCount; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+    /* True when the current context supports glBufferStorage. */
+    static bool IsPersistentMappingSupported();
+};
@@ -0,0 +1,161 @@
+#include "Texture.h"
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+Texture::Texture(const std::string& filepath)
+    : m_RendererID(0), m_FilePath(filepath), m_Width(0), m_Height(0), m_Levels(0), m_InternalFormat(GL_NONE), m_Ready(false),
+      m_BindlessHandle(0)
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    GpuMemory::Allocate(GpuMemory::Category::Textures, 0); // Sized by Allocate
+}
+
+Texture::~Texture()
+{
+    if (m_BindlessHandle)
+    {
+        GLCall(glMakeTextureHandleNonResidentARB(m_BindlessHandle));
+    }
+    StateCache::OnDeleteTexture(m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::Textures, GetStorageSize());
+}
+
+unsigned int Texture::GetMipLevelCount(int width, int height)
+{
+    unsigned int levels = 1;
+    int size = width > height ? width : height;
+    while (size > 1)
+    {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+bool Texture::IsCompressedFormat(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB:
+        case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+unsigned int Texture::GetLevelSize(GLenum internalFormat, int width, int height)
+{
+    if (!IsCompressedFormat(internalFormat))
+        return width * height * 4;
+
+    /* Block compressed formats store 4x4 texels in 8 (BC1, BC4) or 16 bytes (the others). */
+    bool smallBlocks = internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ||
+        internalFormat == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT || internalFormat == GL_COMPRESSED_RED_RGTC1 ||
+        internalFormat == GL_COMPRESSED_SIGNED_RED_RGTC1;
+    return ((width + 3) / 4) * ((height + 3) / 4) * (smallBlocks ? 8 : 16);
+}
+
+void Texture::Allocate(int width, int height, GLenum internalFormat, unsigned int levels)
+{
+    ASSERT(m_Levels == 0);
+    m_Width = width;
+    m_Height = height;
+    m_InternalFormat = internalFormat;
+    m_Levels = levels;
+    GpuMemory::Resize(GpuMemory::Category::Textures, 0, GetStorageSize());
+
+    StateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+    /* Immutable storage lets the driver skip the completeness checks it does on every draw otherwise. */
+    if (GLEW_ARB_texture_storage)
+    {
+        GLCall(glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height));
+    }
+    else
+    {
+        bool compressed = IsCompressedFormat(internalFormat);
+        for (unsigned int level = 0; level < levels; level++)
+        {
+            int levelWidth = width >> level > 0 ? width >> level : 1;
+            int levelHeight = height >> level > 0 ? height >> level : 1;
+            if (compressed)
+            {
+                unsigned int size = GetLevelSize(internalFormat, levelWidth, levelHeight);
+                GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, levelWidth, levelHeight, 0, size, nullptr));
+            }
+            else
+            {
+                GLCall(glTexImage2D(GL_TEXTURE_2D, level, internalFormat, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+            }
+        }
+    }
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+}
+
+void Texture::SetLevel(unsigned int level, int width, int height, GLenum format, GLenum type, const void* data, unsigned int size)
+{
+    ASSERT(level < m_Levels);
+    StateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+    if (IsCompressedFormat(m_InternalFormat))
+    {
+        GLCall(glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, m_InternalFormat, size, data));
+    }
+    else
+    {
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, format, type, data));
+    }
+}
+
+void Texture::GenerateMipmaps()
+{
+    StateCache::BindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+}
+
+uint64_t Texture::GetStorageSize() const
+{
+    return m_Levels ? GpuMemory::GetTextureSize(m_InternalFormat, m_Width, m_Height, m_Levels) : 0;
+}
+
+bool Texture::IsBindlessSupported()
+{
+    return GLEW_ARB_bindless_texture != 0;
+}
+
+uint64_t Texture::GetBindlessHandle() const
+{
+    ASSERT(m_Ready);
+    if (!m_BindlessHandle)
+    {
+        GLCall(m_BindlessHandle = glGetTextureHandleARB(m_RendererID));
+        GLCall(glMakeTextureHandleResidentARB(m_BindlessHandle));
+    }
+    return m_BindlessHandle;
+}
+
+void Texture::Bind(unsigned int slot) const
+{
+    StateCache::BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
+}
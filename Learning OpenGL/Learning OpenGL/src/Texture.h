@@ -0,0 +1,72 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+/* A 2D texture with a full set of storage allocated up front, so loading only ever fills levels in. */
+/* Most textures come from TextureLoader, which creates them empty and fills them in the background: */
+/* until IsReady returns true the texture has no storage and samples as black. */
+class Texture
+{
+private:
+    unsigned int m_RendererID;
+    std::string m_FilePath;
+    int m_Width;
+    int m_Height;
+    unsigned int m_Levels;
+    GLenum m_InternalFormat;
+    bool m_Ready;
+    mutable uint64_t m_BindlessHandle; // 0 until first asked for
+
+public:
+    /* Creates the texture object only, see Allocate. */
+    explicit Texture(const std::string& filepath = std::string());
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    /* Allocates levels mip levels of internalFormat (compressed or not) and sets trilinear filtering. */
+    /* Can only be called once, the storage is immutable when glTexStorage2D is available. */
+    void Allocate(int width, int height, GLenum internalFormat, unsigned int levels);
+
+    /* Uploads one level. data is an offset into GL_PIXEL_UNPACK_BUFFER when one is bound, a pointer otherwise. */
+    /* For compressed formats format and type are ignored and size is required. */
+    void SetLevel(unsigned int level, int width, int height, GLenum format, GLenum type, const void* data, unsigned int size);
+
+    /* Fills every level below 0 from level 0 on the GPU. */
+    void GenerateMipmaps();
+
+    /* Called by the loader when every level has been uploaded. */
+    inline void SetReady() { m_Ready = true; }
+
+    void Bind(unsigned int slot = 0) const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline const std::string& GetFilePath() const { return m_FilePath; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline unsigned int GetLevels() const { return m_Levels; }
+    inline GLenum GetInternalFormat() const { return m_InternalFormat; }
+    inline bool IsReady() const { return m_Ready; }
+
+    /* Bytes of the whole mip chain, 0 until Allocate. What GpuMemory counts for this texture. */
+    uint64_t GetStorageSize() const;
+
+    /* With GL_ARB_bindless_texture shaders can sample the texture through this 64-bit handle */
+    /* without it being bound to any unit. The texture is made resident the first time, and its */
+    /* parameters and storage can't change after that, so only ask once it is ready. */
+    uint64_t GetBindlessHandle() const;
+
+    static bool IsBindlessSupported();
+
+    /* Number of levels in a full mip chain down to 1x1. */
+    static unsigned int GetMipLevelCount(int width, int height);
+
+    /* True for the formats that glCompressedTexSubImage2D has to be used with. */
+    static bool IsCompressedFormat(GLenum internalFormat);
+
+    /* Bytes of one level. Uncompressed formats are assumed to be uploaded as RGBA8. */
+    static unsigned int GetLevelSize(GLenum internalFormat, int width, int height);
+};
@@ -0,0 +1,70 @@
+#include "TextureArray.h"
+#include "Texture.h"
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+TextureArray::TextureArray(int width, int height, unsigned int layers, GLenum internalFormat)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_Layers(layers),
+      m_Levels(Texture::GetMipLevelCount(width, height)), m_InternalFormat(internalFormat)
+{
+    ASSERT(layers <= GetMaxLayers());
+
+    GLCall(glGenTextures(1, &m_RendererID));
+    StateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+    if (GLEW_ARB_texture_storage)
+    {
+        GLCall(glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_Levels, internalFormat, width, height, layers));
+    }
+    else
+    {
+        for (unsigned int level = 0; level < m_Levels; level++)
+        {
+            int levelWidth = width >> level > 0 ? width >> level : 1;
+            int levelHeight = height >> level > 0 ? height >> level : 1;
+            GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, levelWidth, levelHeight, layers, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        }
+    }
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_Levels - 1));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+    GpuMemory::Allocate(GpuMemory::Category::Textures, GpuMemory::GetTextureSize(internalFormat, width, height, m_Levels, layers));
+}
+
+TextureArray::~TextureArray()
+{
+    StateCache::OnDeleteTexture(m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::Textures, GpuMemory::GetTextureSize(m_InternalFormat, m_Width, m_Height, m_Levels, m_Layers));
+}
+
+unsigned int TextureArray::GetMaxLayers()
+{
+    int layers;
+    GLCall(glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &layers));
+    return (unsigned int)layers;
+}
+
+void TextureArray::SetLayer(unsigned int layer, const void* pixels)
+{
+    ASSERT(layer < m_Layers);
+    StateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+    GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+}
+
+void TextureArray::GenerateMipmaps()
+{
+    StateCache::BindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+    StateCache::BindTexture(slot, GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
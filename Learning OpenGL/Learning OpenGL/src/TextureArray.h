@@ -0,0 +1,43 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/* A GL_TEXTURE_2D_ARRAY: many layers of the same size and format behind a single binding. */
+/* Shaders pick the layer with the third texture coordinate, so draws using different */
+/* images of the same kind don't need anything rebound between them. */
+class TextureArray
+{
+private:
+    unsigned int m_RendererID;
+    int m_Width;
+    int m_Height;
+    unsigned int m_Layers;
+    unsigned int m_Levels;
+    GLenum m_InternalFormat;
+
+public:
+    /* Allocates every layer with a full mip chain, immutable when glTexStorage3D is available. */
+    /* internalFormat has to be uncompressed, layers are uploaded as RGBA8. */
+    TextureArray(int width, int height, unsigned int layers, GLenum internalFormat = GL_RGBA8);
+    ~TextureArray();
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+    /* Uploads level 0 of one layer from width * height RGBA8 pixels, or from an offset into a bound unpack buffer. */
+    void SetLayer(unsigned int layer, const void* pixels);
+
+    /* Fills the smaller levels of every layer from level 0 on the GPU, after the layers have been set. */
+    void GenerateMipmaps();
+
+    /* Bind to a unit and point the shader's sampler2DArray at it with Shader::SetUniform1i. */
+    void Bind(unsigned int slot = 0) const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline unsigned int GetLayerCount() const { return m_Layers; }
+
+    /* GL_MAX_ARRAY_TEXTURE_LAYERS, at least 256 on OpenGL 3.3 and 2048 on 4.5. */
+    static unsigned int GetMaxLayers();
+};
@@ -0,0 +1,271 @@
+#include "TextureLoader.h"
+#include "Renderer.h"
+#include "StateCache.h"
+#include "LinearArena.h"
+#include "HotReloader.h"
+#include "FileSystem.h"
+
+#include <cstring>
+#include <iostream>
+
+TextureLoader::TextureLoader(unsigned int decodeThreads, unsigned int uploadBudget)
+    : m_Stop(false)
+{
+    /* Three regions: the GPU may still be copying from the last two when we fill the third. */
+    m_Staging.reset(new StreamBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBudget, 3));
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    for (unsigned int i = 0; i < decodeThreads; i++)
+        m_Workers.emplace_back(&TextureLoader::WorkerMain, this);
+
+    HotReloader::Register(this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    HotReloader::Unregister(this);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkReady.notify_all();
+
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    for (Request* request : m_Queued)
+        m_Requests.Destroy(request);
+    for (Request* request : m_Decoded)
+        m_Requests.Destroy(request);
+    for (Request* request : m_Uploads)
+        m_Requests.Destroy(request);
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string& filepath)
+{
+    std::weak_ptr<Texture>& cached = m_Cache[filepath];
+    if (std::shared_ptr<Texture> texture = cached.lock())
+        return texture;
+
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>(filepath);
+    cached = texture;
+
+    Request* request = m_Requests.Create();
+    request->Target = texture;
+    request->FilePath = filepath;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Queued.push_back(request);
+    }
+    m_WorkReady.notify_one();
+
+    m_Stats.Requested++;
+    m_Stats.Pending++;
+    return texture;
+}
+
+bool TextureLoader::Reload(const std::string& path)
+{
+    for (auto& cached : m_Cache)
+    {
+        std::shared_ptr<Texture> texture = cached.second.lock();
+        if (!texture || FileSystem::NormalizePath(cached.first) != path)
+            continue;
+
+        Request* request = m_Requests.Create();
+        request->Target = texture;
+        request->FilePath = cached.first;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queued.push_back(request);
+        }
+        m_WorkReady.notify_one();
+
+        m_Stats.Requested++;
+        m_Stats.Pending++;
+        return true;
+    }
+    return false;
+}
+
+void TextureLoader::WorkerMain()
+{
+    while (true)
+    {
+        Request* request;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkReady.wait(lock, [this] { return m_Stop || !m_Queued.empty(); });
+            if (m_Stop)
+                return;
+
+            request = m_Queued.front();
+            m_Queued.pop_front();
+        }
+
+        /* Nobody wants the texture anymore, don't bother decoding it. */
+        if (!request->Target.expired())
+            request->Failed = !ImageDecoder::Decode(request->FilePath, request->Decoded, request->Error);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Decoded.push_back(request);
+    }
+}
+
+static bool IsFormatSupported(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            return GLEW_EXT_texture_compression_s3tc != 0;
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return GLEW_EXT_texture_compression_s3tc && GLEW_EXT_texture_sRGB;
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB:
+        case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:
+            return GLEW_ARB_texture_compression_bptc != 0;
+        default:
+            return true; // RGBA8 and RGTC are core since OpenGL 3.0
+    }
+}
+
+void TextureLoader::Upload(Request& request, const unsigned char* data, bool fromStaging)
+{
+    std::shared_ptr<Texture> texture = request.Target.lock();
+    if (!texture)
+        return;
+
+    const Image& image = request.Decoded;
+    unsigned int levels = image.GenerateMipmaps ? Texture::GetMipLevelCount(image.Levels[0].Width, image.Levels[0].Height)
+        : (unsigned int)image.Levels.size();
+
+    /* Without glTexStorage2D, allocating passes a null pointer, which would be read as offset 0 */
+    /* into a bound unpack buffer, so the staging buffer is only bound for the uploads themselves. */
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (texture->GetLevels() == 0)
+    {
+        texture->Allocate(image.Levels[0].Width, image.Levels[0].Height, image.InternalFormat, levels);
+    }
+    else if (texture->GetWidth() != image.Levels[0].Width || texture->GetHeight() != image.Levels[0].Height
+        || texture->GetLevels() != levels || texture->GetInternalFormat() != image.InternalFormat)
+    {
+        /* A reload, see Reload. The storage can't be reallocated, the old image stays. */
+        std::cout << "Texture loader: " << request.FilePath << " changed size or format, restart to see it" << std::endl;
+        m_Stats.Failed++;
+        return;
+    }
+    if (fromStaging)
+        m_Staging->Bind();
+
+    /* RGBA8 rows are always 4 byte aligned, so the default unpack alignment is fine. */
+    for (unsigned int level = 0; level < image.Levels.size(); level++)
+    {
+        const Image::Level& info = image.Levels[level];
+        texture->SetLevel(level, info.Width, info.Height, GL_RGBA, GL_UNSIGNED_BYTE, data + info.Offset, info.Size);
+    }
+    if (image.GenerateMipmaps)
+        texture->GenerateMipmaps();
+
+    texture->SetReady();
+    m_Stats.Loaded++;
+    m_Stats.UploadedBytes += (unsigned int)image.Data.size();
+}
+
+void TextureLoader::Update()
+{
+    m_Stats.UploadedBytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        while (!m_Decoded.empty())
+        {
+            m_Uploads.push_back(m_Decoded.front());
+            m_Decoded.pop_front();
+        }
+    }
+    if (m_Uploads.empty())
+        return;
+
+    const unsigned int regionSize = m_Staging->GetRegionSize();
+    unsigned char* staging = (unsigned char*)m_Staging->Map();
+    unsigned int stagingUsed = 0;
+
+    /* First copy everything that fits into this frame's staging region. */
+    /* The list of what was staged only lives until the end of this call, so it comes from the frame arena. */
+    typedef std::pair<Request*, unsigned int> StagedUpload;
+    std::vector<StagedUpload, ArenaAllocator<StagedUpload>> staged((ArenaAllocator<StagedUpload>(LinearArena::GetFrameArena())));
+    staged.reserve(m_Uploads.size());
+    Request* direct = nullptr;
+    while (!m_Uploads.empty())
+    {
+        Request& request = *m_Uploads.front();
+        unsigned int size = (unsigned int)request.Decoded.Data.size();
+
+        if (request.Target.expired())
+        {
+            /* Nobody wants it anymore. */
+        }
+        else if (request.Failed || !IsFormatSupported(request.Decoded.InternalFormat))
+        {
+            std::cout << "Texture loader: can't load " << request.FilePath << ": "
+                << (request.Failed ? request.Error : "the format is not supported by this GPU") << std::endl;
+            m_Stats.Failed++;
+        }
+        else if (size > regionSize)
+        {
+            /* Larger than a whole region: handed to the driver straight from memory, which makes */
+            /* it copy the data right away. At most one of those per frame. */
+            if (direct)
+                break;
+            direct = m_Uploads.front();
+            m_Uploads.pop_front();
+            m_Stats.Pending--;
+            continue;
+        }
+        else if (stagingUsed + size > regionSize)
+        {
+            break; // The rest waits for the next frame
+        }
+        else
+        {
+            memcpy(staging + stagingUsed, request.Decoded.Data.data(), size);
+            staged.emplace_back(m_Uploads.front(), stagingUsed);
+            stagingUsed += size;
+            m_Uploads.pop_front();
+            m_Stats.Pending--;
+            continue;
+        }
+
+        m_Requests.Destroy(m_Uploads.front());
+        m_Uploads.pop_front();
+        m_Stats.Pending--;
+    }
+
+    /* Without persistent mapping this is where the region is copied into the buffer, */
+    /* so the uploads reading from it can only be issued after it. */
+    m_Staging->Unmap(stagingUsed);
+
+    if (!staged.empty())
+    {
+        const unsigned char* base = (const unsigned char*)(size_t)m_Staging->GetOffset();
+        for (const StagedUpload& upload : staged)
+        {
+            Upload(*upload.first, base + upload.second, true);
+            m_Requests.Destroy(upload.first);
+        }
+        m_Staging->Lock();
+    }
+
+    if (direct)
+    {
+        Upload(*direct, direct->Decoded.Data.data(), false);
+        m_Requests.Destroy(direct);
+    }
+    StateCache::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "ImageDecoder.h"
+#include "StreamBuffer.h"
+#include "Pool.h"
+
+/* Loads textures without ever blocking the render loop. */
+/*                                                                    */
+/* Load returns an empty Texture right away and queues the file for a pool of decode threads, which read */
+/* and decode it into memory. Update, called once per frame on the GL thread, then copies decoded images */
+/* into a pixel unpack StreamBuffer and uploads them from there, so glTexSubImage2D only records a copy */
+/* the GPU does later instead of waiting on the transfer. At most one stream region of bytes is uploaded */
+/* per frame, so a burst of loads is spread over several frames instead of causing a hitch. */
+class TextureLoader
+{
+public:
+    struct Stats
+    {
+        unsigned int Requested = 0;
+        unsigned int Loaded = 0;
+        unsigned int Failed = 0;
+        unsigned int Pending = 0;     // Still decoding or waiting for upload
+        unsigned int UploadedBytes = 0; // During the last Update
+    };
+
+private:
+    struct Request
+    {
+        std::weak_ptr<Texture> Target;
+        std::string FilePath;
+        Image Decoded;
+        std::string Error;
+        bool Failed = false;
+    };
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::deque<Request*> m_Queued;  // Waiting for a decode thread
+    std::deque<Request*> m_Decoded; // Waiting for Update
+    std::deque<Request*> m_Uploads; // Taken by Update, waiting for room in the staging buffer, GL thread only
+    bool m_Stop;
+
+    Pool<Request> m_Requests; // Created in Load and destroyed in Update, GL thread only
+
+    std::unordered_map<std::string, std::weak_ptr<Texture>> m_Cache; // GL thread only
+    std::unique_ptr<StreamBuffer> m_Staging;
+    Stats m_Stats;
+
+    void WorkerMain();
+    /* data is an offset into the staging buffer if fromStaging, a pointer to memory otherwise. */
+    void Upload(Request& request, const unsigned char* data, bool fromStaging);
+
+public:
+    /* uploadBudget is the size of one staging region, the most bytes uploaded per frame through the PBO. */
+    /* Images larger than that are uploaded straight from memory, one per frame, which makes the driver copy them. */
+    explicit TextureLoader(unsigned int decodeThreads = 2, unsigned int uploadBudget = 8 * 1024 * 1024);
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    /* The same file is only loaded once while any of its Textures is alive. GL thread only. */
+    std::shared_ptr<Texture> Load(const std::string& filepath);
+
+    /* Decodes the file again and uploads it into the Texture that is already alive, if there is one, */
+    /* see HotReloader. path is normalized. The new image must have the same size and format, */
+    /* the storage is immutable. Returns false if nothing loaded from path is alive. GL thread only. */
+    bool Reload(const std::string& path);
+
+    /* Uploads what has been decoded since the last call. GL thread only, once per frame. */
+    void Update();
+
+    inline const Stats& GetStats() const { return m_Stats; }
+};
@@ -0,0 +1,85 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+    : m_Task(nullptr), m_TaskCount(0), m_NextTask(0), m_Busy(0), m_Generation(0), m_Stop(false)
+{
+    m_Workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerMain, this, i + 1);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkReady.notify_all();
+
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+unsigned int ThreadPool::DefaultWorkerCount()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void ThreadPool::Run(unsigned int taskCount, const Task& task)
+{
+    if (taskCount == 0)
+        return;
+
+    /* Not worth waking anybody up for. */
+    if (taskCount == 1 || m_Workers.empty())
+    {
+        for (unsigned int i = 0; i < taskCount; i++)
+            task(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Task = &task;
+        m_TaskCount = taskCount;
+        m_NextTask = 0;
+        m_Busy = (unsigned int)m_Workers.size();
+        m_Generation++;
+    }
+    m_WorkReady.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [this] { return m_Busy == 0; });
+    m_Task = nullptr;
+}
+
+void ThreadPool::RunTasks(unsigned int thread)
+{
+    unsigned int task;
+    while ((task = m_NextTask++) < m_TaskCount)
+        (*m_Task)(task, thread);
+}
+
+void ThreadPool::WorkerMain(unsigned int thread)
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkReady.wait(lock, [this, generation] { return m_Stop || m_Generation != generation; });
+            if (m_Stop)
+                return;
+            generation = m_Generation;
+        }
+
+        RunTasks(thread);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_Busy == 0)
+            m_WorkDone.notify_one();
+    }
+}
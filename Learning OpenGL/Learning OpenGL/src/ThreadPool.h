@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* A fixed set of worker threads for splitting per-frame work into tasks. */
+/*                                                                    */
+/* Run hands out taskCount tasks and blocks until all of them are done. The calling thread works on */
+/* tasks too, as thread 0, so a pool of N workers runs on N + 1 threads. Tasks are picked with an */
+/* atomic counter, and Run allocates nothing, so it can be used many times per frame. */
+/* Tasks must not touch OpenGL: the context is only current on the thread that created the window. */
+class ThreadPool
+{
+public:
+    /* task is the index of the task, thread the index of the thread running it, in [0, GetThreadCount()). */
+    typedef std::function<void(unsigned int task, unsigned int thread)> Task;
+
+private:
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+
+    const Task* m_Task;
+    unsigned int m_TaskCount;
+    std::atomic<unsigned int> m_NextTask;
+    unsigned int m_Busy;          // Workers that have not finished the current Run yet
+    unsigned int m_Generation;    // Incremented by every Run, so workers can tell new work from a spurious wakeup
+    bool m_Stop;
+
+    void WorkerMain(unsigned int thread);
+    void RunTasks(unsigned int thread);
+
+public:
+    /* By default one worker per core, leaving a core for the calling thread. */
+    explicit ThreadPool(unsigned int workerCount = DefaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Run(unsigned int taskCount, const Task& task);
+
+    /* Workers plus the calling thread. */
+    inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size() + 1; }
+
+    static unsigned int DefaultWorkerCount();
+};
@@ -0,0 +1,34 @@
+#include "UniformBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int bindingPoint)
+    : m_Size(size), m_BindingPoint(bindingPoint)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::UniformBuffers, size);
+    StateCache::BindBufferBase(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::UniformBuffers, m_Size);
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    StateCache::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::Bind() const
+{
+    StateCache::BindBufferBase(GL_UNIFORM_BUFFER, m_BindingPoint, m_RendererID);
+}
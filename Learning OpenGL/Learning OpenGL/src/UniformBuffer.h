@@ -0,0 +1,27 @@
+#pragma once
+
+/* A uniform buffer object bound to a fixed binding point. Programs pick it up through */
+/* Shader::SetUniformBlockBinding, so one upload is seen by every program using the block. */
+/* The data has to follow the std140 layout rules of the block it backs: vec4 and mat4 members */
+/* are 16 byte aligned, and scalars followed by a vec4 need explicit padding. */
+class UniformBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Size;
+    unsigned int m_BindingPoint;
+
+public:
+    UniformBuffer(unsigned int size, unsigned int bindingPoint);
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+    /* Attaches the buffer to its binding point again, for buffers that share one. */
+    void Bind() const;
+
+    inline unsigned int GetBindingPoint() const { return m_BindingPoint; }
+};
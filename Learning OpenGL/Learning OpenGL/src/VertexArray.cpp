@@ -0,0 +1,77 @@
+#include "VertexArray.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+VertexArray::VertexArray()
+    : m_AttribIndex(0)
+{
+    GLCall(glGenVertexArrays(1, &m_RendererID));
+    GpuMemory::Allocate(GpuMemory::Category::VertexArrays, 0);
+}
+
+VertexArray::~VertexArray()
+{
+    StateCache::OnDeleteVertexArray(m_RendererID);
+    GLCall(glDeleteVertexArrays(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::VertexArrays, 0);
+}
+
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+{
+    Bind();
+    vb.Bind();
+    AddLayout(layout);
+}
+
+void VertexArray::AddBuffer(const StreamBuffer& sb, const VertexBufferLayout& layout)
+{
+    Bind();
+    sb.Bind();
+    AddLayout(layout);
+}
+
+void VertexArray::AddLayout(const VertexBufferLayout& layout)
+{
+    const auto& elements = layout.GetElements();
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < elements.size(); i++)
+    {
+        const auto& element = elements[i];
+
+        /* Attributes have at most 4 components, bigger elements (matrices) are split into columns. */
+        unsigned int remaining = element.count;
+        while (remaining > 0)
+        {
+            unsigned int count = remaining > 4 ? 4 : remaining;
+
+            /* 1) index = the attribute location in the shader */
+            /* 2) size = the number of components of this attribute */
+            /* 3) type = the type of each component */
+            /* 4) normalized = whether integers should be mapped to [0, 1] */
+            /* 5) stride = the amount of bytes between each vertex (or each instance) */
+            /* 6) pointer = offset of the attribute inside the vertex */
+            GLCall(glEnableVertexAttribArray(m_AttribIndex));
+            GLCall(glVertexAttribPointer(m_AttribIndex, count, element.type, element.normalized, layout.GetStride(), (const void*)(size_t)offset));
+            if (element.divisor)
+            {
+                GLCall(glVertexAttribDivisor(m_AttribIndex, element.divisor));
+            }
+
+            offset += VertexBufferElement::GetSize(element.type, count);
+            remaining -= count;
+            m_AttribIndex++;
+        }
+    }
+}
+
+void VertexArray::Bind() const
+{
+    StateCache::BindVertexArray(m_RendererID);
+}
+
+void VertexArray::Unbind() const
+{
+    StateCache::BindVertexArray(0);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "VertexBuffer.h"
+#include "StreamBuffer.h"
+#include "VertexBufferLayout.h"
+
+/* Owns a Vertex Array Object. Every buffer added gets the next free attribute locations, */
+/* so the per-vertex buffer has to be added first and per-instance buffers after it, */
+/* in the same order as the locations declared in the shader. */
+class VertexArray
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_AttribIndex; // Next free attribute location
+
+public:
+    VertexArray();
+    ~VertexArray();
+
+    VertexArray(const VertexArray&) = delete;
+    VertexArray& operator=(const VertexArray&) = delete;
+
+    void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+    void AddBuffer(const StreamBuffer& sb, const VertexBufferLayout& layout);
+
+    void Bind() const;
+    void Unbind() const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+private:
+    /* Sets up the attributes of the buffer currently bound to GL_ARRAY_BUFFER. */
+    void AddLayout(const VertexBufferLayout& layout);
+};
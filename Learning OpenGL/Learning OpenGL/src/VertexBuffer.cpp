@@ -0,0 +1,51 @@
+#include "VertexBuffer.h"
+
+#include "Renderer.h"
+#include "StateCache.h"
+#include "GpuMemory.h"
+
+VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+    : m_Size(size)
+{
+    /* Once we have generated a buffer, we need to select it, and that is done with glBindBuffer. */
+    /* In this case, we are binding the buffer into GL_ARRAY_BUFFER, which simply means that the */
+    /* purpose of the buffer will be of being an array of Vertex Attributes. */
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::VertexBuffers, size);
+}
+
+VertexBuffer::VertexBuffer(unsigned int size)
+    : m_Size(size)
+{
+    /* We give it nothing for now and tell OpenGL that the content will change every frame. */
+    GLCall(glGenBuffers(1, &m_RendererID));
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    GpuMemory::Allocate(GpuMemory::Category::VertexBuffers, size);
+}
+
+VertexBuffer::~VertexBuffer()
+{
+    StateCache::OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Free(GpuMemory::Category::VertexBuffers, m_Size);
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
+void VertexBuffer::Bind() const
+{
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void VertexBuffer::Unbind() const
+{
+    StateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
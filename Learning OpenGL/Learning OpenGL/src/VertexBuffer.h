@@ -0,0 +1,30 @@
+#pragma once
+
+class VertexBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Size;
+
+public:
+    /* Creates a buffer with its data already uploaded. This is what we want for geometry that never changes. */
+    VertexBuffer(const void* data, unsigned int size);
+
+    /* Creates an empty buffer of the given size whose content will be replaced through SetData. */
+    VertexBuffer(unsigned int size);
+
+    ~VertexBuffer();
+
+    VertexBuffer(const VertexBuffer&) = delete;
+    VertexBuffer& operator=(const VertexBuffer&) = delete;
+
+    /* Replaces size bytes of a dynamic buffer, starting offset bytes into it. */
+    void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+    void Bind() const;
+    void Unbind() const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+    inline unsigned int GetSize() const { return m_Size; }
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexFormats.h"
+
+struct VertexBufferElement
+{
+    unsigned int type;
+    unsigned int count;
+    unsigned char normalized;
+    unsigned int divisor; // 0 = advances per vertex, n = advances once every n instances
+
+    static unsigned int GetSizeOfType(unsigned int type)
+    {
+        switch (type)
+        {
+            case GL_FLOAT:                return 4;
+            case GL_UNSIGNED_INT:         return 4;
+            case GL_HALF_FLOAT:           return 2;
+            case GL_SHORT:                return 2;
+            case GL_UNSIGNED_SHORT:       return 2;
+            case GL_UNSIGNED_BYTE:        return 1;
+            case GL_INT_2_10_10_10_REV:   return 4; // For all four components
+        }
+        ASSERT(false);
+        return 0;
+    }
+
+    /* Packed types hold every component of the attribute in one value. */
+    static bool IsPacked(unsigned int type)
+    {
+        return type == GL_INT_2_10_10_10_REV;
+    }
+
+    /* Bytes taken by count components of type. */
+    static unsigned int GetSize(unsigned int type, unsigned int count)
+    {
+        return IsPacked(type) ? GetSizeOfType(type) : count * GetSizeOfType(type);
+    }
+};
+
+/* Describes how the data of one vertex buffer is laid out, element after element. */
+/* Elements pushed with a divisor are per-instance attributes, which is what lets one */
+/* glDrawElementsInstanced read a different transform or color for every copy of the mesh. */
+/* Besides float, elements can be Half (GL_HALF_FLOAT), short and unsigned short (normalized to [-1, 1] */
+/* and [0, 1]), unsigned char (normalized to [0, 1]) and PackedNormal (GL_INT_2_10_10_10_REV, normalized, */
+/* always 4 components). The shader still declares them as float vectors, see MeshQuantizer. */
+class VertexBufferLayout
+{
+private:
+    std::vector<VertexBufferElement> m_Elements;
+    unsigned int m_Stride;
+
+public:
+    VertexBufferLayout()
+        : m_Stride(0) {}
+
+    /* A float element with more than 4 components (e.g. 16 for a mat4) takes several consecutive */
+    /* attribute locations of 4 components each, exactly like a matrix input does in GLSL. */
+    template<typename T>
+    void Push(unsigned int count, unsigned int divisor = 0);
+
+    /* Same as Push, but the element advances once per instance instead of once per vertex. */
+    template<typename T>
+    void PushInstanced(unsigned int count, unsigned int divisor = 1)
+    {
+        Push<T>(count, divisor);
+    }
+
+    inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+    inline unsigned int GetStride() const { return m_Stride; }
+};
+
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+template<>
+inline void VertexBufferLayout::Push<Half>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_HALF_FLOAT, count, GL_FALSE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_HALF_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_SHORT, count, GL_TRUE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_SHORT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count, unsigned int divisor)
+{
+    m_Elements.push_back({ GL_UNSIGNED_SHORT, count, GL_TRUE, divisor });
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_SHORT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<PackedNormal>(unsigned int count, unsigned int divisor)
+{
+    ASSERT(count == 4); // The packed format always has four components
+    m_Elements.push_back({ GL_INT_2_10_10_10_REV, count, GL_TRUE, divisor });
+    m_Stride += VertexBufferElement::GetSizeOfType(GL_INT_2_10_10_10_REV);
+}
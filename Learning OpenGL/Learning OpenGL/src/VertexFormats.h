@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/* Compact encodings of vertex attributes, for VertexBufferLayout::Push and MeshQuantizer. */
+/* The GPU expands all of them to floats during vertex fetch, so shaders read them as plain vec2/vec3/vec4. */
+
+/* An IEEE 754 half: 1 sign bit, 5 exponent bits, 10 mantissa bits. Read as GL_HALF_FLOAT. */
+/* About 3 decimal digits, which is plenty for texture coordinates but not for large positions. */
+struct Half
+{
+    uint16_t Bits;
+
+    static Half FromFloat(float value)
+    {
+        uint32_t f;
+        memcpy(&f, &value, sizeof(f));
+
+        const uint32_t sign = (f >> 16) & 0x8000;
+        const int exponent = (int)((f >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = f & 0x7fffff;
+
+        Half half;
+        if (((f >> 23) & 0xff) == 0xff) // Infinity or NaN
+            half.Bits = (uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+        else if (exponent >= 31) // Too large, becomes infinity
+            half.Bits = (uint16_t)(sign | 0x7c00);
+        else if (exponent <= 0) // Subnormal or zero
+        {
+            if (exponent < -10)
+                half.Bits = (uint16_t)sign;
+            else
+            {
+                mantissa |= 0x800000;
+                const int shift = 14 - exponent;
+                uint32_t bits = mantissa >> shift;
+                if ((mantissa >> (shift - 1)) & 1) // Round to nearest
+                    bits++;
+                half.Bits = (uint16_t)(sign | bits);
+            }
+        }
+        else
+        {
+            uint32_t bits = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+            if (mantissa & 0x1000) // Round to nearest, a carry into the exponent is still correct
+                bits++;
+            half.Bits = (uint16_t)bits;
+        }
+        return half;
+    }
+
+    float ToFloat() const
+    {
+        const uint32_t sign = (uint32_t)(Bits & 0x8000) << 16;
+        const uint32_t exponent = (Bits >> 10) & 0x1f;
+        const uint32_t mantissa = Bits & 0x3ff;
+
+        if (exponent == 0)
+        {
+            const float value = mantissa / 1024.0f / 16384.0f; // mantissa * 2^-24
+            return sign ? -value : value;
+        }
+
+        uint32_t f;
+        if (exponent == 31)
+            f = sign | 0x7f800000 | (mantissa << 13);
+        else
+            f = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+        float value;
+        memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+};
+
+/* Four signed normalized components in 32 bits, x, y and z with 10 bits and w with 2. */
+/* Read as GL_INT_2_10_10_10_REV with normalized = true; perfect for unit normals and tangents */
+/* (w holds the sign of the bitangent). */
+struct PackedNormal
+{
+    uint32_t Bits;
+
+    static PackedNormal FromFloats(float x, float y, float z, float w = 0.0f)
+    {
+        PackedNormal packed;
+        packed.Bits = Snorm(x, 511) | (Snorm(y, 511) << 10) | (Snorm(z, 511) << 20) | (Snorm(w, 1) << 30);
+        return packed;
+    }
+
+    void ToFloats(float* out) const
+    {
+        out[0] = Unpack(Bits, 10, 511);
+        out[1] = Unpack(Bits >> 10, 10, 511);
+        out[2] = Unpack(Bits >> 20, 10, 511);
+        out[3] = Unpack(Bits >> 30, 2, 1);
+    }
+
+private:
+    /* Rounds to the nearest step and keeps the two's complement bits of the field. */
+    static uint32_t Snorm(float value, int max)
+    {
+        const float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+        const int quantized = (int)std::floor(clamped * max + 0.5f);
+        return (uint32_t)quantized & (uint32_t)(max * 2 + 1);
+    }
+
+    static float Unpack(uint32_t bits, int width, int max)
+    {
+        int value = (int)(bits & ((1u << width) - 1));
+        if (value & (1 << (width - 1)))
+            value -= 1 << width;
+        const float result = (float)value / max;
+        return result < -1.0f ? -1.0f : result; // The most negative value also means -1
+    }
+};
+
+static_assert(sizeof(Half) == 2, "Half must be 16 bits");
+static_assert(sizeof(PackedNormal) == 4, "PackedNormal must be 32 bits");
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <ostream>
+
+namespace scene {
+
+    /* What the last OnRender submitted, used by the benchmark to compute throughput. */
+    struct SceneStats
+    {
+        unsigned int DrawCalls = 0;
+        unsigned long long Triangles = 0;
+    };
+
+    /* A scene owns everything it needs to draw one demo or workload. */
+    /* The main loop only knows about this interface, so new scenes don't touch main(). */
+    class Scene
+    {
+    public:
+        Scene() {}
+        virtual ~Scene() {}
+
+        /* Advances the simulation by one fixed step. It may run on the simulation thread, so it must not */
+        /* touch OpenGL or anything OnRender reads directly; results go to OnRender through a SimulationState. */
+        virtual void OnUpdate(float /*step*/) {}
+
+        /* alpha in [0, 1] is how far the present is between the last two simulated states. */
+        virtual void OnRender(float /*alpha*/) {}
+
+        /* Called once per second with the stream the stats should be printed to. */
+        virtual void OnReport(std::ostream& /*out*/) {}
+
+        /* False while the scene is still loading (e.g. waiting for its shaders), in which case it draws nothing. */
+        virtual bool IsReady() const { return true; }
+
+        virtual SceneStats GetStats() const { return SceneStats(); }
+    };
+
+}
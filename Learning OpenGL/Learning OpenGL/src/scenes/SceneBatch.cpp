@@ -0,0 +1,97 @@
+#include "SceneBatch.h"
+
+#include "Renderer.h"
+#include "Shader.h"
+
+namespace scene {
+
+    SceneBatch::SceneBatch(int gridSize)
+        : m_GridSize(gridSize), m_R(0.0f), m_Speed(3.0f), m_State({ 0.0f })
+    {
+        /* The shader compiles in the background, the scene simply draws nothing until it is ready. */
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Batch.shader", BatchRenderer::GetShaderDefines());
+    }
+
+    SceneBatch::~SceneBatch()
+    {
+    }
+
+    void SceneBatch::OnUpdate(float step)
+    {
+        /* We are going to change color over time of our quads, at the same speed whatever the frame rate. */
+        m_R += m_Speed * step;
+        if (m_R >= 1.0f)
+        {
+            m_R = 1.0f;
+            m_Speed = -m_Speed;
+        }
+        else if (m_R <= 0.0f)
+        {
+            m_R = 0.0f;
+            m_Speed = -m_Speed;
+        }
+
+        m_State.Publish({ m_R });
+    }
+
+    void SceneBatch::OnRender(float alpha)
+    {
+        if (!m_Batch)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+
+            /* Instead of uploading one quad and issuing one glDrawElements per object, every quad goes through */
+            /* the batch renderer, which draws as many of them as fit in its vertex buffer with a single call. */
+            m_Batch.reset(new BatchRenderer(*m_Shader));
+        }
+
+        const SimulationState<State>::Snapshot& state = m_State.Acquire();
+        const float r = state.Previous.R + (state.Current.R - state.Previous.R) * alpha;
+
+        const float cellSize = 2.0f / m_GridSize;
+        const float quadSize = cellSize * 0.9f;
+
+        m_Batch->ResetStats();
+        m_Batch->BeginBatch();
+        for (int y = 0; y < m_GridSize; y++)
+        {
+            for (int x = 0; x < m_GridSize; x++)
+            {
+                const float color[4] = { r, (float)x / m_GridSize, (float)y / m_GridSize, 1.0f };
+                m_Batch->DrawQuad(-1.0f + x * cellSize, -1.0f + y * cellSize, quadSize, quadSize, color);
+            }
+        }
+        m_Batch->EndBatch();
+    }
+
+    void SceneBatch::OnReport(std::ostream& out)
+    {
+        if (!m_Batch)
+        {
+            out << "Waiting for the batch shader to compile" << std::endl;
+            return;
+        }
+
+        /* How many draw calls the batching saved us. */
+        const BatchRenderer::Stats& stats = m_Batch->GetStats();
+        out << "Quads: " << stats.QuadCount << " | Batches: " << stats.BatchCount << " | Draw calls: " << stats.DrawCount
+            << " | Stalls: " << stats.StallCount << std::endl;
+    }
+
+    SceneStats SceneBatch::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Batch)
+        {
+            stats.DrawCalls = m_Batch->GetStats().DrawCount;
+            stats.Triangles = m_Batch->GetStats().QuadCount * 2ull;
+        }
+        return stats;
+    }
+
+}
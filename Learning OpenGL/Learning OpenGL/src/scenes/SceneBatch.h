@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "BatchRenderer.h"
+#include "ShaderCompiler.h"
+#include "SimulationState.h"
+
+namespace scene {
+
+    /* A grid of colored quads drawn through the batch renderer. */
+    class SceneBatch : public Scene
+    {
+    private:
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+        std::unique_ptr<BatchRenderer> m_Batch;
+
+        /* What the renderer needs from the simulation. */
+        struct State
+        {
+            float R;
+        };
+
+        int m_GridSize;
+
+        /* Owned by OnUpdate. */
+        float m_R;
+        float m_Speed;
+
+        SimulationState<State> m_State;
+
+    public:
+        SceneBatch(int gridSize = 100);
+        ~SceneBatch();
+
+        void OnUpdate(float step) override;
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Batch != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}
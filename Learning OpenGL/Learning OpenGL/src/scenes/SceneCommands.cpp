@@ -0,0 +1,172 @@
+#include "SceneCommands.h"
+
+#include "Renderer.h"
+#include "Shader.h"
+#include "Profiler.h"
+
+namespace scene {
+
+    SceneCommands::SceneCommands(unsigned int gridSize, bool sort)
+        : m_Queue(m_Pool.GetThreadCount(), gridSize * gridSize, gridSize * gridSize * 2, gridSize * gridSize * 8),
+          m_GridSize(gridSize), m_Sort(sort), m_Ready(false)
+    {
+        for (unsigned int i = 0; i < ProgramCount; i++)
+            m_Programs[i] = 0;
+
+        m_ShaderHandles[Flat] = m_Compiler.Submit("res/shaders/Quad.shader");
+        m_ShaderHandles[Inverted] = m_Compiler.Submit("res/shaders/Quad.shader", { "INVERT" });
+        m_ShaderHandles[Textured] = m_Compiler.Submit("res/shaders/Quad.shader", { "TEXTURED" });
+
+        /* The texture objects exist right away, only their images stream in, so the materials can */
+        /* refer to them from the start. Nothing is drawn until they are ready. */
+        m_Checker = m_Loader.Load("res/textures/checker.tga");
+        m_Gradient = m_Loader.Load("res/textures/gradient.tga");
+
+        typedef RenderCommandQueue::BlendMode BlendMode;
+        const unsigned int checker = m_Checker->GetRendererID(), gradient = m_Gradient->GetRendererID();
+        m_Materials[Plain] = 0;
+        m_Materials[Glow] = m_Queue.AddMaterial({ 0, BlendMode::Additive });
+        m_Materials[Checker] = m_Queue.AddMaterial({ checker, BlendMode::Opaque });
+        m_Materials[Gradient] = m_Queue.AddMaterial({ gradient, BlendMode::Opaque });
+        m_Materials[CheckerAlpha] = m_Queue.AddMaterial({ checker, BlendMode::Alpha });
+        m_Materials[GradientAlpha] = m_Queue.AddMaterial({ gradient, BlendMode::Alpha });
+
+        float positions[8] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f,
+            0.0f, 1.0f
+        };
+
+        unsigned int indices[6] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        m_VertexArray.reset(new VertexArray());
+        m_VertexBuffer.reset(new VertexBuffer(positions, sizeof(positions)));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_IndexBuffer.reset(new IndexBuffer(indices, 6));
+        m_VertexArray->Unbind();
+    }
+
+    void SceneCommands::Record(unsigned int row, RenderCommandBuffer& buffer) const
+    {
+        const float cellSize = 2.0f / m_GridSize;
+        const float quadSize = cellSize * 0.9f;
+
+        for (unsigned int x = 0; x < m_GridSize; x++)
+        {
+            /* The same random choice for a cell every frame. Textured materials need the textured program. */
+            uint32_t hash = (x * 73856093u) ^ (row * 19349663u);
+            hash = (hash ^ (hash >> 13)) * 0x5bd1e995u;
+            hash ^= hash >> 15;
+
+            const unsigned int program = hash % ProgramCount;
+            const unsigned int variant = (hash / ProgramCount) % 4;
+            Material material;
+            if (program == Textured)
+                material = (Material)(Checker + variant);
+            else
+                material = variant == 0 ? Glow : Plain;
+
+            const Shader& shader = *m_Shaders[program];
+            const unsigned int queueMaterial = m_Materials[material];
+
+            /* Quads further right are "deeper", only so the key has something to order by. */
+            uint64_t key = m_Queue.MakeKey(0, shader, queueMaterial, (float)x / m_GridSize);
+            if (!buffer.Draw(key, shader, queueMaterial, *m_VertexArray, *m_IndexBuffer))
+                continue;
+
+            const float alpha = m_Queue.GetMaterial(queueMaterial).IsTranslucent() ? 0.6f : 1.0f;
+            buffer.SetUniform4f(m_RectLocations[program], -1.0f + x * cellSize, -1.0f + row * cellSize, quadSize, quadSize);
+            buffer.SetUniform4f(m_ColorLocations[program], (float)x / m_GridSize, (float)row / m_GridSize, 0.5f, alpha);
+        }
+    }
+
+    void SceneCommands::OnRender(float /*alpha*/)
+    {
+        m_Loader.Update();
+
+        if (!m_Ready)
+        {
+            if (!m_Checker->IsReady() || !m_Gradient->IsReady())
+                return;
+
+            m_Compiler.Poll();
+            for (unsigned int i = 0; i < ProgramCount; i++)
+            {
+                if (m_Shaders[i])
+                    continue;
+
+                m_Shaders[i] = m_Compiler.Take(m_ShaderHandles[i]);
+                if (!m_Shaders[i])
+                    return;
+
+                m_Shaders[i]->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+            }
+            m_Ready = true;
+        }
+
+        /* Recording threads can't look locations up, so we do it here, again after a hot reload. */
+        for (unsigned int i = 0; i < ProgramCount; i++)
+        {
+            if (m_Programs[i] == m_Shaders[i]->GetRendererID())
+                continue;
+
+            m_Programs[i] = m_Shaders[i]->GetRendererID();
+            m_RectLocations[i] = m_Shaders[i]->GetUniformLocation("u_Rect");
+            m_ColorLocations[i] = m_Shaders[i]->GetUniformLocation("u_Color");
+        }
+
+        /* One task per row, each thread recording into its own buffer. */
+        m_Pool.Run(m_GridSize, [this](unsigned int row, unsigned int thread)
+        {
+            Record(row, m_Queue.GetBuffer(thread));
+        });
+
+        m_Queue.Execute(m_Sort);
+
+        const RenderCommandQueue::Stats& stats = m_Queue.GetStats();
+        PROFILE_COUNTER("Commands: program changes", stats.Submitted.Programs);
+        PROFILE_COUNTER("Commands: material changes", stats.Submitted.Materials);
+    }
+
+    void SceneCommands::OnReport(std::ostream& out)
+    {
+        if (!m_Ready)
+        {
+            out << "Waiting for the quad shaders to compile and the textures to load" << std::endl;
+            return;
+        }
+
+        const RenderCommandQueue::Stats& stats = m_Queue.GetStats();
+        out << "Commands: " << stats.Draws << " from " << m_Pool.GetThreadCount() << " threads | " << m_Queue.GetMaterialCount()
+            << " materials | Dropped: " << stats.Dropped;
+        if (m_Sort)
+            out << " | Radix passes: " << stats.SortPasses << " of 8";
+        out << std::endl;
+
+        /* What drawing in the recorded order would change, then what was really submitted. */
+        const RenderCommandQueue::Changes& recorded = stats.Recorded;
+        const RenderCommandQueue::Changes& submitted = stats.Submitted;
+        out << "Changes recorded -> submitted: programs " << recorded.Programs << " -> " << submitted.Programs
+            << " | materials " << recorded.Materials << " -> " << submitted.Materials
+            << " | textures " << recorded.Textures << " -> " << submitted.Textures
+            << " | blend modes " << recorded.Blends << " -> " << submitted.Blends << std::endl;
+    }
+
+    SceneStats SceneCommands::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Ready)
+        {
+            stats.DrawCalls = m_Queue.GetStats().Draws;
+            stats.Triangles = m_Queue.GetStats().Draws * 2ull;
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "ShaderCompiler.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include "RenderCommandQueue.h"
+
+namespace scene {
+
+    /* A grid of quads, each its own draw call with its own uniforms, recorded in parallel */
+    /* into a RenderCommandQueue and submitted sorted from the GL thread. */
+    /* Every quad picks one of three programs and one of six materials (textured or not, opaque, */
+    /* alpha blended or additive) at random, the worst case for state changes when drawn in order, */
+    /* which the sort by key turns into a handful per frame. Unsorted, to compare, they are drawn */
+    /* in the order recorded. The report shows the changes of both orders. */
+    class SceneCommands : public Scene
+    {
+    private:
+        enum Program
+        {
+            Flat, Inverted, Textured, ProgramCount
+        };
+
+        enum Material
+        {
+            Plain, Glow, Checker, Gradient, CheckerAlpha, GradientAlpha, MaterialCount
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandles[ProgramCount];
+        std::unique_ptr<Shader> m_Shaders[ProgramCount];
+        unsigned int m_Programs[ProgramCount]; // The programs the locations below belong to
+        int m_RectLocations[ProgramCount];
+        int m_ColorLocations[ProgramCount];
+
+        TextureLoader m_Loader;
+        std::shared_ptr<Texture> m_Checker;
+        std::shared_ptr<Texture> m_Gradient;
+        unsigned int m_Materials[MaterialCount]; // In m_Queue
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+        ThreadPool m_Pool;
+        RenderCommandQueue m_Queue;
+
+        unsigned int m_GridSize;
+        bool m_Sort;
+        bool m_Ready;
+
+        void Record(unsigned int row, RenderCommandBuffer& buffer) const;
+
+    public:
+        SceneCommands(unsigned int gridSize = 100, bool sort = true);
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Ready; }
+        SceneStats GetStats() const override;
+    };
+
+}
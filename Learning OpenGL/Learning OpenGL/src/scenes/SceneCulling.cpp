@@ -0,0 +1,240 @@
+#include "SceneCulling.h"
+
+#include "StateCache.h"
+
+#include <cmath>
+#include <vector>
+
+namespace scene {
+
+    static const unsigned int MeshCount = 16;
+    static const float WorldHalfWidth = 10.0f;
+
+    /* Same sequence on every run, so benchmark results are comparable. */
+    static float Random(unsigned int& seed)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;
+    }
+
+    SceneCulling::SceneCulling(unsigned int columns, unsigned int rows, bool occlusion)
+        : m_Program(0), m_ViewProjectionLocation(-1), m_OccluderTriangles(0), m_Width(0), m_Height(0),
+          m_PyramidViewProjection(Mat4::Identity()), m_HasPyramid(false), m_Occlusion(occlusion),
+          m_Supported(Shader::IsComputeSupported()), m_Time(0.0f), m_State({ 0.0f })
+    {
+        if (!m_Supported)
+            return;
+
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Culling.shader");
+        m_CullShaderHandle = m_Compiler.Submit("res/shaders/Cull.shader");
+        m_PyramidShaderHandle = m_Compiler.Submit("res/shaders/DepthPyramid.shader");
+
+        /* Mesh 0 is a square for the walls, the others regular polygons from 3 to MeshCount + 1 sides. */
+        const unsigned int maxSides = MeshCount + 1;
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        m_Pool.reset(new MeshPool(layout, 4 + MeshCount * (maxSides + 1), 6 + MeshCount * maxSides * 3, GL_UNSIGNED_SHORT));
+
+        const float square[8] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+        const unsigned int squareIndices[6] = { 0, 1, 2, 2, 3, 0 };
+        m_Pool->AddMesh(square, 4, squareIndices, 6);
+
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        for (unsigned int mesh = 0; mesh < MeshCount; mesh++)
+        {
+            const unsigned int sides = 3 + mesh;
+            vertices.assign({ 0.0f, 0.0f });
+            indices.clear();
+            for (unsigned int i = 0; i < sides; i++)
+            {
+                float angle = 6.2831853f * i / sides;
+                vertices.push_back(0.5f * std::cos(angle));
+                vertices.push_back(0.5f * std::sin(angle));
+
+                indices.push_back(0);
+                indices.push_back(1 + i);
+                indices.push_back(1 + (i + 1) % sides);
+            }
+            m_Pool->AddMesh(vertices.data(), sides + 1, indices.data(), (unsigned int)indices.size());
+        }
+
+        /* The objects, spread over the whole world behind the walls. */
+        const unsigned int objectCount = columns * rows;
+        const unsigned int wallCount = (unsigned int)(WorldHalfWidth / 0.75f);
+        std::vector<DrawData> draws(objectCount + wallCount);
+        std::vector<GpuCuller::Bounds> bounds(objectCount);
+        m_Commands.reset(new IndirectCommandBuffer(objectCount));
+
+        unsigned int seed = 12345;
+        const float cellWidth = 2.0f * WorldHalfWidth / columns;
+        const float cellHeight = 2.0f / rows;
+        for (unsigned int y = 0; y < rows; y++)
+        {
+            for (unsigned int x = 0; x < columns; x++)
+            {
+                const unsigned int object = m_Commands->Add(m_Pool->GetMesh(1 + (x + y * 5) % MeshCount));
+                const float scale = cellHeight * (0.5f + 0.4f * Random(seed));
+
+                DrawData& draw = draws[object];
+                draw.Transform[0] = -WorldHalfWidth + (x + 0.5f) * cellWidth;
+                draw.Transform[1] = -1.0f + (y + 0.5f) * cellHeight;
+                draw.Transform[2] = scale;
+                draw.Transform[3] = scale;
+                draw.Depth = -0.8f + Random(seed);
+                draw.Color[0] = (unsigned char)(255 * x / columns);
+                draw.Color[1] = (unsigned char)(255 * y / rows);
+                draw.Color[2] = (unsigned char)(128 + 127 * Random(seed));
+                draw.Color[3] = 255;
+
+                GpuCuller::Bounds& sphere = bounds[object];
+                sphere.Center[0] = draw.Transform[0];
+                sphere.Center[1] = draw.Transform[1];
+                sphere.Center[2] = draw.Depth;
+                sphere.Radius = 0.5f * scale;
+            }
+        }
+        m_Commands->Upload();
+        m_Culler.reset(new GpuCuller(*m_Commands, bounds));
+
+        /* The walls are never culled. Their draw data goes after the objects'. */
+        m_OccluderCommands.reset(new IndirectCommandBuffer(wallCount, objectCount));
+        const MeshPool::Mesh& wall = m_Pool->GetMesh(0);
+        for (unsigned int i = 0; i < wallCount; i++)
+        {
+            DrawData& draw = draws[m_OccluderCommands->Add(wall)];
+            draw.Transform[0] = -WorldHalfWidth + (i + 0.5f) * 2.0f * WorldHalfWidth / wallCount;
+            draw.Transform[1] = 0.0f;
+            draw.Transform[2] = 0.6f;
+            draw.Transform[3] = 1.7f;
+            draw.Depth = 0.6f; // In front of every object
+            draw.Color[0] = draw.Color[1] = draw.Color[2] = 60;
+            draw.Color[3] = 255;
+            m_OccluderTriangles += wall.IndexCount / 3;
+        }
+        m_OccluderCommands->Upload();
+
+        m_DrawBuffer.reset(new VertexBuffer(draws.data(), (unsigned int)(draws.size() * sizeof(DrawData))));
+        VertexBufferLayout drawLayout;
+        drawLayout.PushInstanced<float>(4);         // Transform
+        drawLayout.PushInstanced<float>(1);         // Depth
+        drawLayout.PushInstanced<unsigned char>(4); // Color
+        m_Pool->GetVertexArray().AddBuffer(*m_DrawBuffer, drawLayout);
+        m_Pool->GetVertexArray().Unbind();
+    }
+
+    void SceneCulling::CreateTarget(int width, int height)
+    {
+        m_Width = width;
+        m_Height = height;
+
+        /* Depth has to be a texture so the pyramid can be built from it. */
+        FramebufferSpec spec;
+        spec.Width = width;
+        spec.Height = height;
+        spec.DepthFormat = GL_DEPTH_COMPONENT32F;
+        spec.DepthTexture = true;
+        if (m_Target)
+            m_Target->Resize(width, height);
+        else
+            m_Target.reset(new Framebuffer(spec));
+
+        m_Pyramid.reset(new DepthPyramid(width, height));
+        m_HasPyramid = false;
+    }
+
+    void SceneCulling::OnUpdate(float step)
+    {
+        m_Time += step;
+        m_State.Publish({ (WorldHalfWidth - 2.0f) * std::sin(0.15f * m_Time) });
+    }
+
+    void SceneCulling::OnRender(float alpha)
+    {
+        if (!m_Supported)
+            return;
+
+        if (!m_PyramidShader)
+        {
+            m_Compiler.Poll();
+            if (!m_Shader)
+                m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_CullShader)
+                m_CullShader = m_Compiler.Take(m_CullShaderHandle);
+            if (m_Shader && m_CullShader)
+                m_PyramidShader = m_Compiler.Take(m_PyramidShaderHandle);
+            if (!m_PyramidShader)
+                return;
+        }
+
+        if (m_Program != m_Shader->GetRendererID())
+        {
+            m_Program = m_Shader->GetRendererID();
+            m_ViewProjectionLocation = m_Shader->GetUniformLocation("u_ViewProjection");
+        }
+
+        GLint viewport[4];
+        GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+        if (viewport[2] != m_Width || viewport[3] != m_Height)
+            CreateTarget(viewport[2], viewport[3]);
+
+        GLint outputFramebuffer;
+        GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &outputFramebuffer));
+
+        const SimulationState<State>::Snapshot& state = m_State.Acquire();
+        const float cameraX = state.Previous.CameraX + (state.Current.CameraX - state.Previous.CameraX) * alpha;
+        const float aspect = (float)m_Width / m_Height;
+        const Mat4 viewProjection = Mat4::Ortho(cameraX - aspect, cameraX + aspect, -1.0f, 1.0f);
+
+        m_Target->Bind();
+        StateCache::SetDepthTest(true);
+        StateCache::SetDepthMask(true);
+        StateCache::SetDepthFunc(GL_LESS);
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+        /* The walls first, then everything the culling kept, whose commands never leave the GPU. */
+        m_Shader->Bind();
+        GLCall(glUniformMatrix4fv(m_ViewProjectionLocation, 1, GL_FALSE, viewProjection.Elements));
+        m_Renderer.DrawIndirect(*m_Pool, *m_OccluderCommands, *m_Shader);
+
+        m_Culler->Cull(*m_CullShader, viewProjection, m_Occlusion && m_HasPyramid ? m_Pyramid.get() : nullptr, m_PyramidViewProjection);
+        m_Renderer.DrawIndirect(*m_Pool, *m_Commands, *m_Shader);
+
+        m_Target->BlitColor(outputFramebuffer, 0, 0, m_Width, m_Height, GL_NEAREST);
+        StateCache::SetDepthTest(false);
+
+        /* Next frame culls against what this one ended up drawing. */
+        if (m_Occlusion)
+        {
+            m_Pyramid->Build(*m_PyramidShader, m_Target->GetDepthTexture());
+            m_PyramidViewProjection = viewProjection;
+            m_HasPyramid = true;
+        }
+    }
+
+    void SceneCulling::OnReport(std::ostream& out)
+    {
+        if (!m_Supported)
+        {
+            out << "GPU culling needs compute shaders (OpenGL 4.3), nothing to draw" << std::endl;
+            return;
+        }
+
+        const GpuCuller::Stats& stats = m_Culler->GetStats();
+        out << "Objects: " << stats.Objects << " | Visible: " << stats.Visible
+            << " (" << (stats.Objects ? 100 * stats.Visible / stats.Objects : 0) << "%)"
+            << " | Occlusion: " << (m_Occlusion ? "on" : "off") << " | Draw calls: 2" << std::endl;
+    }
+
+    SceneStats SceneCulling::GetStats() const
+    {
+        SceneStats stats;
+        if (m_PyramidShader)
+        {
+            stats.DrawCalls = 2;
+            stats.Triangles = m_OccluderTriangles + m_Culler->GetStats().Triangles;
+        }
+        return stats;
+    }
+
+}
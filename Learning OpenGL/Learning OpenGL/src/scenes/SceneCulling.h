@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "MeshPool.h"
+#include "IndirectCommandBuffer.h"
+#include "GpuCuller.h"
+#include "DepthPyramid.h"
+#include "Framebuffer.h"
+#include "ShaderCompiler.h"
+#include "SimulationState.h"
+
+namespace scene {
+
+    /* A world much wider than the view, full of small objects, with a few large walls in front of them. */
+    /* The camera pans across it, and every frame a compute shader culls the objects against the view and */
+    /* against the depth pyramid built from the previous frame, writing the indirect commands the single */
+    /* multi-draw then consumes. The CPU never looks at a single object after the constructor. */
+    /*                                                                    */
+    /* The scene renders into its own framebuffer because it needs depth as a texture, and copies the color */
+    /* to whatever framebuffer was bound when OnRender was called. */
+    class SceneCulling : public Scene
+    {
+    private:
+        struct DrawData
+        {
+            float Transform[4]; // Center xy, scale zw
+            float Depth;
+            unsigned char Color[4];
+        };
+
+        struct State
+        {
+            float CameraX;
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle, m_CullShaderHandle, m_PyramidShaderHandle;
+        std::unique_ptr<Shader> m_Shader, m_CullShader, m_PyramidShader;
+        unsigned int m_Program;       // The program the location below belongs to, it changes on a hot reload
+        int m_ViewProjectionLocation; // Set every frame, so looked up once
+
+        Renderer m_Renderer;
+        std::unique_ptr<MeshPool> m_Pool;
+        std::unique_ptr<VertexBuffer> m_DrawBuffer;
+        std::unique_ptr<IndirectCommandBuffer> m_Commands;
+        std::unique_ptr<IndirectCommandBuffer> m_OccluderCommands;
+        std::unique_ptr<GpuCuller> m_Culler;
+        unsigned long long m_OccluderTriangles;
+
+        /* Render target, recreated when the viewport size changes. */
+        int m_Width, m_Height;
+        std::unique_ptr<Framebuffer> m_Target;
+        std::unique_ptr<DepthPyramid> m_Pyramid;
+        Mat4 m_PyramidViewProjection;
+        bool m_HasPyramid;
+
+        bool m_Occlusion;
+        bool m_Supported;
+
+        /* Owned by OnUpdate. */
+        float m_Time;
+
+        SimulationState<State> m_State;
+
+    public:
+        SceneCulling(unsigned int columns = 200, unsigned int rows = 60, bool occlusion = true);
+
+        void OnUpdate(float step) override;
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_PyramidShader != nullptr || !m_Supported; }
+        SceneStats GetStats() const override;
+
+    private:
+        void CreateTarget(int width, int height);
+    };
+
+}
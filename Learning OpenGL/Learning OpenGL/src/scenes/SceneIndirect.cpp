@@ -0,0 +1,120 @@
+#include "SceneIndirect.h"
+
+#include <cmath>
+#include <vector>
+
+namespace scene {
+
+    /* Meshes with 3 to 3 + MeshCount - 1 sides, so the draws really are of different meshes. */
+    static const unsigned int MeshCount = 32;
+
+    SceneIndirect::SceneIndirect(unsigned int columns, unsigned int rows, bool multiDraw)
+        : m_TriangleCount(0), m_DrawCalls(0), m_MultiDraw(multiDraw), m_Supported(IndirectCommandBuffer::IsSupported())
+    {
+        if (!m_Supported)
+            return;
+
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Indirect.shader");
+
+        /* Regular polygons as a center vertex plus a triangle fan around it. */
+        const unsigned int maxSides = 3 + MeshCount - 1;
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        m_Pool.reset(new MeshPool(layout, MeshCount * (maxSides + 1), MeshCount * maxSides * 3, GL_UNSIGNED_SHORT));
+
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        for (unsigned int mesh = 0; mesh < MeshCount; mesh++)
+        {
+            const unsigned int sides = 3 + mesh;
+            vertices.assign({ 0.0f, 0.0f });
+            indices.clear();
+            for (unsigned int i = 0; i < sides; i++)
+            {
+                float angle = 6.2831853f * i / sides;
+                vertices.push_back(0.5f * std::cos(angle));
+                vertices.push_back(0.5f * std::sin(angle));
+
+                indices.push_back(0);
+                indices.push_back(1 + i);
+                indices.push_back(1 + (i + 1) % sides);
+            }
+            m_Pool->AddMesh(vertices.data(), sides + 1, indices.data(), (unsigned int)indices.size());
+        }
+
+        /* One command per object. BaseInstance is the index of the object's entry in the draw data buffer. */
+        const unsigned int objectCount = columns * rows;
+        m_Commands.reset(new IndirectCommandBuffer(objectCount));
+        std::vector<DrawData> draws(objectCount);
+        const float cellWidth = 2.0f / columns;
+        const float cellHeight = 2.0f / rows;
+        for (unsigned int y = 0; y < rows; y++)
+        {
+            for (unsigned int x = 0; x < columns; x++)
+            {
+                const MeshPool::Mesh& mesh = m_Pool->GetMesh((x + y * 3) % MeshCount);
+                DrawData& draw = draws[m_Commands->Add(mesh)];
+                draw.Transform[0] = -1.0f + (x + 0.5f) * cellWidth;
+                draw.Transform[1] = -1.0f + (y + 0.5f) * cellHeight;
+                draw.Transform[2] = cellWidth * 0.9f;
+                draw.Transform[3] = cellHeight * 0.9f;
+                draw.Color[0] = (unsigned char)(255 * x / columns);
+                draw.Color[1] = (unsigned char)(255 * y / rows);
+                draw.Color[2] = 160;
+                draw.Color[3] = 255;
+                m_TriangleCount += mesh.IndexCount / 3;
+            }
+        }
+        m_Commands->Upload();
+
+        m_DrawBuffer.reset(new VertexBuffer(draws.data(), (unsigned int)(draws.size() * sizeof(DrawData))));
+        VertexBufferLayout drawLayout;
+        drawLayout.PushInstanced<float>(4);         // Transform
+        drawLayout.PushInstanced<unsigned char>(4); // Color
+        m_Pool->GetVertexArray().AddBuffer(*m_DrawBuffer, drawLayout);
+        m_Pool->GetVertexArray().Unbind();
+    }
+
+    void SceneIndirect::OnRender(float /*alpha*/)
+    {
+        if (!m_Supported)
+            return;
+
+        if (!m_Shader)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+        }
+
+        m_DrawCalls = m_Renderer.DrawIndirect(*m_Pool, *m_Commands, *m_Shader, m_MultiDraw);
+    }
+
+    void SceneIndirect::OnReport(std::ostream& out)
+    {
+        if (!m_Supported)
+        {
+            out << "Indirect drawing needs OpenGL 4.2 or GL_ARB_base_instance, nothing to draw" << std::endl;
+            return;
+        }
+
+        out << "Objects: " << m_Commands->GetCommandCount() << " | Meshes: " << m_Pool->GetMeshCount()
+            << " | Draw calls: " << m_DrawCalls
+            << (m_MultiDraw && !IndirectCommandBuffer::IsMultiDrawSupported() ? " (multi-draw not supported)" : "") << std::endl;
+    }
+
+    SceneStats SceneIndirect::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Shader)
+        {
+            stats.DrawCalls = m_DrawCalls;
+            stats.Triangles = m_TriangleCount;
+        }
+        return stats;
+    }
+
+}
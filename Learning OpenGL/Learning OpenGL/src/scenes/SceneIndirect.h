@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "MeshPool.h"
+#include "IndirectCommandBuffer.h"
+#include "ShaderCompiler.h"
+
+namespace scene {
+
+    /* A grid of objects, each one a draw of one of several different meshes. All the meshes live in one */
+    /* MeshPool and all the draws in one IndirectCommandBuffer, so with multiDraw the whole grid is a single */
+    /* glMultiDrawElementsIndirect. Without it the same commands are issued one draw call per object, */
+    /* which is the baseline the benchmark compares the multi-draw against. */
+    class SceneIndirect : public Scene
+    {
+    private:
+        struct DrawData
+        {
+            float Transform[4]; // Center xy, scale zw
+            unsigned char Color[4];
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+
+        Renderer m_Renderer;
+        std::unique_ptr<MeshPool> m_Pool;
+        std::unique_ptr<VertexBuffer> m_DrawBuffer;
+        std::unique_ptr<IndirectCommandBuffer> m_Commands;
+        unsigned long long m_TriangleCount;
+        unsigned int m_DrawCalls;
+        bool m_MultiDraw;
+        bool m_Supported;
+
+    public:
+        SceneIndirect(unsigned int columns = 100, unsigned int rows = 100, bool multiDraw = true);
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Shader != nullptr || !m_Supported; }
+        SceneStats GetStats() const override;
+    };
+
+}
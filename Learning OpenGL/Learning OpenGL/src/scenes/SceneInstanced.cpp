@@ -0,0 +1,103 @@
+#include "SceneInstanced.h"
+
+#include <vector>
+
+namespace scene {
+
+    SceneInstanced::SceneInstanced(unsigned int columns, unsigned int rows)
+        : m_InstanceCount(columns * rows)
+    {
+        /* The shader compiles in the background while we build the instance data. */
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Instanced.shader");
+
+        float positions[8] = {
+            -0.5f, -0.5f,
+             0.5f, -0.5f,
+             0.5f,  0.5f,
+            -0.5f,  0.5f
+        };
+
+        unsigned int indices[6] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        /* Every instance is the unit quad scaled down to its cell and moved to the cell center. */
+        std::vector<InstanceData> instances(m_InstanceCount);
+        const float cellWidth = 2.0f / columns;
+        const float cellHeight = 2.0f / rows;
+        for (unsigned int y = 0; y < rows; y++)
+        {
+            for (unsigned int x = 0; x < columns; x++)
+            {
+                InstanceData& instance = instances[y * columns + x];
+                for (int i = 0; i < 16; i++)
+                    instance.Transform[i] = 0.0f;
+                instance.Transform[0] = cellWidth * 0.8f;
+                instance.Transform[5] = cellHeight * 0.8f;
+                instance.Transform[10] = 1.0f;
+                instance.Transform[12] = -1.0f + (x + 0.5f) * cellWidth;
+                instance.Transform[13] = -1.0f + (y + 0.5f) * cellHeight;
+                instance.Transform[15] = 1.0f;
+
+                instance.Color[0] = (float)x / columns;
+                instance.Color[1] = (float)y / rows;
+                instance.Color[2] = 0.5f;
+                instance.Color[3] = 1.0f;
+            }
+        }
+
+        m_VertexArray.reset(new VertexArray());
+
+        m_QuadBuffer.reset(new VertexBuffer(positions, sizeof(positions)));
+        VertexBufferLayout quadLayout;
+        quadLayout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_QuadBuffer, quadLayout);
+
+        m_InstanceBuffer.reset(new VertexBuffer(instances.data(), (unsigned int)(instances.size() * sizeof(InstanceData))));
+        VertexBufferLayout instanceLayout;
+        instanceLayout.PushInstanced<float>(16); // Transform
+        instanceLayout.PushInstanced<float>(4);  // Color
+        m_VertexArray->AddBuffer(*m_InstanceBuffer, instanceLayout);
+
+        m_IndexBuffer.reset(new IndexBuffer(indices, 6));
+
+        m_VertexArray->Unbind();
+    }
+
+    SceneInstanced::~SceneInstanced()
+    {
+    }
+
+    void SceneInstanced::OnRender(float /*alpha*/)
+    {
+        if (!m_Shader)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+        }
+
+        m_Renderer.DrawInstanced(*m_VertexArray, *m_IndexBuffer, *m_Shader, m_InstanceCount);
+    }
+
+    void SceneInstanced::OnReport(std::ostream& out)
+    {
+        out << "Instances: " << m_InstanceCount << " | Draw calls: 1" << std::endl;
+    }
+
+    SceneStats SceneInstanced::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Shader)
+        {
+            stats.DrawCalls = 1;
+            stats.Triangles = m_InstanceCount * 2ull;
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "ShaderCompiler.h"
+
+namespace scene {
+
+    /* One quad mesh drawn many times with a single glDrawElementsInstanced. */
+    /* Every instance reads its own transform and color from a per-instance vertex buffer. */
+    class SceneInstanced : public Scene
+    {
+    private:
+        struct InstanceData
+        {
+            float Transform[16]; // Column-major, takes attribute locations 1 to 4
+            float Color[4];
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+        unsigned int m_InstanceCount;
+
+        Renderer m_Renderer;
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_QuadBuffer;
+        std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    public:
+        SceneInstanced(unsigned int columns = 400, unsigned int rows = 250);
+        ~SceneInstanced();
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Shader != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}
@@ -0,0 +1,205 @@
+#include "SceneMesh.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "StateCache.h"
+#include "MeshOptimizer.h"
+
+namespace scene {
+
+    /* A unit sphere with its seam duplicated, so the texture coordinates can wrap around. */
+    static void BuildSphere(unsigned int slices, unsigned int stacks, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        const float pi = 3.14159265f;
+        vertices.reserve((slices + 1) * (stacks + 1));
+        for (unsigned int i = 0; i <= stacks; i++)
+        {
+            const float theta = pi * i / stacks; // 0 at the north pole
+            for (unsigned int j = 0; j <= slices; j++)
+            {
+                const float phi = 2.0f * pi * j / slices;
+
+                MeshVertex vertex;
+                vertex.Position[0] = std::sin(theta) * std::sin(phi);
+                vertex.Position[1] = std::cos(theta);
+                vertex.Position[2] = std::sin(theta) * std::cos(phi);
+                for (int c = 0; c < 3; c++)
+                    vertex.Normal[c] = vertex.Position[c];
+
+                /* The tangent follows the u direction, which goes around the sphere. */
+                vertex.Tangent[0] = std::cos(phi);
+                vertex.Tangent[1] = 0.0f;
+                vertex.Tangent[2] = -std::sin(phi);
+                vertex.Tangent[3] = 1.0f;
+
+                vertex.TexCoords[0] = (float)j / slices;
+                vertex.TexCoords[1] = (float)i / stacks;
+
+                vertex.Color[0] = 0.5f + 0.5f * vertex.Position[0];
+                vertex.Color[1] = 0.5f + 0.5f * vertex.Position[1];
+                vertex.Color[2] = 0.8f;
+                vertex.Color[3] = 1.0f;
+                vertices.push_back(vertex);
+            }
+        }
+
+        /* Counter-clockwise seen from outside, so back face culling removes the far half. */
+        indices.reserve(slices * stacks * 6);
+        for (unsigned int i = 0; i < stacks; i++)
+        {
+            for (unsigned int j = 0; j < slices; j++)
+            {
+                const unsigned int a = i * (slices + 1) + j;
+                const unsigned int b = a + slices + 1;
+                indices.push_back(a);
+                indices.push_back(b);
+                indices.push_back(b + 1);
+                indices.push_back(a);
+                indices.push_back(b + 1);
+                indices.push_back(a + 1);
+            }
+        }
+    }
+
+    SceneMesh::SceneMesh(bool compact, bool optimize, unsigned int columns, unsigned int rows, unsigned int slices, unsigned int stacks)
+        : m_Columns(columns), m_Rows(rows), m_VertexCount(0), m_VertexSize(0), m_StartupTime(0.0),
+          m_Compact(compact), m_Optimize(optimize), m_FromPack(false)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Mesh.shader");
+
+        std::ostringstream path;
+        path << "cache/meshes/sphere-" << slices << "x" << stacks << (m_Compact ? "-compact" : "-float") << (m_Optimize ? "-optimized" : "") << ".pack";
+
+        const auto start = std::chrono::steady_clock::now();
+        AssetPack pack;
+        m_FromPack = pack.Open(path.str()) && Load(pack);
+        if (!m_FromPack)
+        {
+            /* First start, or the pack is outdated: build the mesh and keep the result for the next time. */
+            AssetPackWriter writer;
+            Build(writer, slices, stacks);
+            const std::vector<unsigned char> image = writer.Serialize();
+            if (!AssetPackWriter::WriteFile(path.str(), image))
+                std::cout << "SceneMesh: could not write " << path.str() << ", the mesh will be built again next time" << std::endl;
+
+            const bool loaded = pack.Open(image.data(), image.size()) && Load(pack);
+            ASSERT(loaded);
+            (void)loaded;
+        }
+        m_StartupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void SceneMesh::Build(AssetPackWriter& writer, unsigned int slices, unsigned int stacks) const
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        BuildSphere(slices, stacks, vertices, indices);
+        unsigned int vertexCount = (unsigned int)vertices.size();
+
+        MeshInfo info = {};
+        for (int c = 0; c < 3; c++)
+            info.PositionScale[c] = 1.0f;
+
+        const unsigned int indexCount = (unsigned int)indices.size();
+        info.ACMR = MeshOptimizer::AnalyzeVertexCache(indices.data(), indexCount, vertexCount).ACMR;
+        if (m_Optimize)
+        {
+            MeshOptimizer::OptimizeVertexCache(indices.data(), indexCount, vertexCount);
+            vertexCount = MeshOptimizer::OptimizeVertexFetch(vertices.data(), sizeof(MeshVertex), vertexCount, indices.data(), indexCount);
+            info.OptimizedACMR = MeshOptimizer::AnalyzeVertexCache(indices.data(), indexCount, vertexCount).ACMR;
+        }
+
+        if (m_Compact)
+        {
+            MeshQuantizer::Result quantized = MeshQuantizer::Quantize(vertices.data(), vertexCount);
+            for (int c = 0; c < 3; c++)
+            {
+                info.PositionScale[c] = quantized.PositionScale[c];
+                info.PositionOffset[c] = quantized.PositionOffset[c];
+            }
+            info.MaxPositionError = quantized.MaxPositionError;
+            info.MaxNormalError = quantized.MaxNormalError;
+            writer.AddVertices("sphere.vertices", quantized.Vertices.data(), vertexCount, sizeof(CompactVertex));
+        }
+        else
+        {
+            writer.AddVertices("sphere.vertices", vertices.data(), vertexCount, sizeof(MeshVertex));
+        }
+
+        writer.AddIndices("sphere.indices", indices.data(), indexCount); // 33k vertices, so 16 bit indices
+        writer.AddData("sphere.info", &info, sizeof(info));
+    }
+
+    bool SceneMesh::Load(const AssetPack& pack)
+    {
+        const unsigned int vertexSize = m_Compact ? sizeof(CompactVertex) : sizeof(MeshVertex);
+        const AssetPackEntry* info = pack.Find("sphere.info");
+        const AssetPackEntry* vertices = pack.Find("sphere.vertices");
+        if (!info || info->Size != sizeof(MeshInfo) || !vertices || vertices->Format != vertexSize || !pack.Find("sphere.indices"))
+            return false;
+
+        memcpy(&m_Info, pack.GetData(*info), sizeof(MeshInfo));
+        m_VertexCount = vertices->Count;
+        m_VertexSize = vertexSize;
+
+        /* Straight from the mapping to the GL, nothing is parsed or copied on the way. */
+        m_VertexArray.reset(new VertexArray());
+        m_VertexBuffer = pack.CreateVertexBuffer("sphere.vertices");
+        m_VertexArray->AddBuffer(*m_VertexBuffer, m_Compact ? MeshQuantizer::GetCompactLayout() : MeshQuantizer::GetSourceLayout());
+        m_IndexBuffer = pack.CreateIndexBuffer("sphere.indices"); // Captured by the bound VAO
+        m_VertexArray->Unbind();
+        return true;
+    }
+
+    void SceneMesh::OnRender(float /*alpha*/)
+    {
+        if (!m_Shader)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+            m_Shader->Bind();
+            m_Shader->SetUniform3f("u_PositionScale", m_Info.PositionScale[0], m_Info.PositionScale[1], m_Info.PositionScale[2]);
+            m_Shader->SetUniform3f("u_PositionOffset", m_Info.PositionOffset[0], m_Info.PositionOffset[1], m_Info.PositionOffset[2]);
+            m_Shader->SetUniform2i("u_GridSize", (int)m_Columns, (int)m_Rows);
+        }
+
+        /* The spheres are convex and don't overlap, so culling back faces is all the hidden surface removal needed. */
+        StateCache::SetCullFace(true);
+        m_Renderer.DrawInstanced(*m_VertexArray, *m_IndexBuffer, *m_Shader, m_Columns * m_Rows);
+        StateCache::SetCullFace(false);
+    }
+
+    void SceneMesh::OnReport(std::ostream& out)
+    {
+        out << (m_Compact ? "Compact" : "Float") << " vertices: " << m_VertexCount << " x " << m_VertexSize << " bytes = "
+            << m_VertexCount * m_VertexSize / 1024 << " KB | Indices: " << m_IndexBuffer->GetCount() << " x " << m_IndexBuffer->GetIndexSize()
+            << " bytes | ACMR: " << m_Info.ACMR;
+        if (m_Optimize)
+            out << " -> " << m_Info.OptimizedACMR;
+        out << " | Instances: " << m_Columns * m_Rows;
+        if (m_Compact)
+            out << " | Max position error: " << m_Info.MaxPositionError << " | Max normal error: " << m_Info.MaxNormalError << " deg";
+        out << " | Startup: " << m_StartupTime << " ms (" << (m_FromPack ? "mapped pack" : "built") << ")" << std::endl;
+    }
+
+    SceneStats SceneMesh::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Shader)
+        {
+            stats.DrawCalls = 1;
+            stats.Triangles = (unsigned long long)m_Columns * m_Rows * (m_IndexBuffer->GetCount() / 3);
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "MeshQuantizer.h"
+#include "AssetPack.h"
+#include "ShaderCompiler.h"
+
+namespace scene {
+
+    /* A grid of spinning, finely tessellated spheres with normals, tangents, texture coordinates and */
+    /* colors, lit with a procedural bump map so that any error in the attributes would show. With compact */
+    /* the mesh goes through MeshQuantizer first (24 byte vertices), otherwise it stays in full floats */
+    /* (64 byte vertices); both versions are drawn by the same shader and should look the same. */
+    /* With optimize the mesh is also reordered by MeshOptimizer for the vertex caches. */
+    class SceneMesh : public Scene
+    {
+    private:
+        /* Everything the draw and the report need besides the buffers, stored in the pack next to them. */
+        struct MeshInfo
+        {
+            float PositionScale[3];
+            float PositionOffset[3];
+            float MaxPositionError;
+            float MaxNormalError;
+            float ACMR;
+            float OptimizedACMR;
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+
+        Renderer m_Renderer;
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+        MeshInfo m_Info;
+        unsigned int m_Columns, m_Rows;
+        unsigned int m_VertexCount;
+        unsigned int m_VertexSize;
+        double m_StartupTime; // Milliseconds to get the mesh onto the GPU
+        bool m_Compact;
+        bool m_Optimize;
+        bool m_FromPack;
+
+    public:
+        /* The finished mesh is kept in an AssetPack under cache/meshes, so only the first start builds it. */
+        SceneMesh(bool compact, bool optimize, unsigned int columns = 8, unsigned int rows = 8, unsigned int slices = 256, unsigned int stacks = 128);
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Shader != nullptr; }
+        SceneStats GetStats() const override;
+
+    private:
+        void Build(AssetPackWriter& writer, unsigned int slices, unsigned int stacks) const;
+        bool Load(const AssetPack& pack);
+    };
+
+}
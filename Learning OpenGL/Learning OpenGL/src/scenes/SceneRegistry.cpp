@@ -0,0 +1,68 @@
+#include "SceneRegistry.h"
+
+#include "SceneBatch.h"
+#include "SceneInstanced.h"
+#include "SceneShaderHeavy.h"
+#include "SceneCommands.h"
+#include "SceneTextures.h"
+#include "SceneTextureArray.h"
+#include "SceneIndirect.h"
+#include "SceneCulling.h"
+#include "SceneMesh.h"
+#include "SceneSprites.h"
+#include "SceneWorld.h"
+
+namespace scene {
+
+    std::unique_ptr<Scene> CreateScene(const std::string& name)
+    {
+        if (name == "quad")
+            return std::unique_ptr<Scene>(new SceneBatch(1));
+        if (name == "batch")
+            return std::unique_ptr<Scene>(new SceneBatch(100));          // 10k quads
+        if (name == "instanced")
+            return std::unique_ptr<Scene>(new SceneInstanced(400, 250)); // 100k instances
+        if (name == "triangles-1m")
+            return std::unique_ptr<Scene>(new SceneInstanced(1000, 500)); // 500k instances, 1M triangles
+        if (name == "shader-heavy")
+            return std::unique_ptr<Scene>(new SceneShaderHeavy());
+        if (name == "commands")
+            return std::unique_ptr<Scene>(new SceneCommands(100));      // 10k draw calls recorded in parallel
+        if (name == "commands-unsorted")
+            return std::unique_ptr<Scene>(new SceneCommands(100, false)); // The same, drawn in the order recorded
+        if (name == "textures")
+            return std::unique_ptr<Scene>(new SceneTextures(16));
+        if (name == "texture-array")
+            return std::unique_ptr<Scene>(new SceneTextureArray(64, 256)); // 4096 quads, 256 images, one draw
+        if (name == "indirect")
+            return std::unique_ptr<Scene>(new SceneIndirect(100, 100, true));  // 10k meshes, one multi-draw
+        if (name == "indirect-loop")
+            return std::unique_ptr<Scene>(new SceneIndirect(100, 100, false)); // The same 10k meshes, one draw call each
+        if (name == "gpu-culling")
+            return std::unique_ptr<Scene>(new SceneCulling(200, 60, true));  // 12k objects, frustum and Hi-Z culled in a compute shader
+        if (name == "gpu-culling-frustum")
+            return std::unique_ptr<Scene>(new SceneCulling(200, 60, false)); // The same, frustum culling only
+        if (name == "mesh-float")
+            return std::unique_ptr<Scene>(new SceneMesh(false, false)); // 64 spheres of 33k vertices, 64 byte float vertices
+        if (name == "mesh-compact")
+            return std::unique_ptr<Scene>(new SceneMesh(true, false));  // The same spheres quantized to 24 byte vertices
+        if (name == "mesh-optimized")
+            return std::unique_ptr<Scene>(new SceneMesh(true, true));   // Quantized and reordered for the vertex caches
+        if (name == "sprites")
+            return std::unique_ptr<Scene>(new SceneSprites(100000, SpriteStore::GetBestKernel())); // 100k rotated quads from SIMD
+        if (name == "sprites-scalar")
+            return std::unique_ptr<Scene>(new SceneSprites(100000, SpriteStore::Kernel::Scalar)); // The same, one sprite at a time
+        if (name == "world")
+            return std::unique_ptr<Scene>(new SceneWorld(200000, 64.0f, 1.0f, true)); // 200k objects, only what the camera sees drawn
+        if (name == "world-nocull")
+            return std::unique_ptr<Scene>(new SceneWorld(200000, 64.0f, 1.0f, false)); // The same world, everything drawn
+        return nullptr;
+    }
+
+    const std::vector<std::string>& GetSceneNames()
+    {
+        static const std::vector<std::string> names = { "quad", "batch", "instanced", "triangles-1m", "shader-heavy", "commands", "commands-unsorted", "textures", "texture-array", "indirect", "indirect-loop", "gpu-culling", "gpu-culling-frustum", "mesh-float", "mesh-compact", "mesh-optimized", "sprites", "sprites-scalar", "world", "world-nocull" };
+        return names;
+    }
+
+}
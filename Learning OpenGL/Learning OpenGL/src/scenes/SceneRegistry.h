@@ -0,0 +1,17 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Scene.h"
+
+namespace scene {
+
+    /* Creates a scene by name, or returns null if there is no scene with that name. */
+    std::unique_ptr<Scene> CreateScene(const std::string& name);
+
+    /* Every name CreateScene knows about, in the order the benchmark runs them. */
+    const std::vector<std::string>& GetSceneNames();
+
+}
@@ -0,0 +1,65 @@
+#include "SceneShaderHeavy.h"
+
+#include <string>
+
+namespace scene {
+
+    SceneShaderHeavy::SceneShaderHeavy(unsigned int iterations)
+        : m_Iterations(iterations)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/ShaderHeavy.shader", { "ITERATIONS " + std::to_string(iterations) });
+
+        /* Covers the whole [-1, 1] view, the projection only widens it to the aspect ratio. */
+        float positions[8] = {
+            -2.0f, -1.0f,
+             2.0f, -1.0f,
+             2.0f,  1.0f,
+            -2.0f,  1.0f
+        };
+
+        unsigned int indices[6] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        m_VertexArray.reset(new VertexArray());
+        m_VertexBuffer.reset(new VertexBuffer(positions, sizeof(positions)));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_IndexBuffer.reset(new IndexBuffer(indices, 6));
+        m_VertexArray->Unbind();
+    }
+
+    void SceneShaderHeavy::OnRender(float /*alpha*/)
+    {
+        if (!m_Shader)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+        }
+
+        m_Renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+    }
+
+    void SceneShaderHeavy::OnReport(std::ostream& out)
+    {
+        out << "Fullscreen quad | Iterations per fragment: " << m_Iterations << std::endl;
+    }
+
+    SceneStats SceneShaderHeavy::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Shader)
+        {
+            stats.DrawCalls = 1;
+            stats.Triangles = 2;
+        }
+        return stats;
+    }
+
+}
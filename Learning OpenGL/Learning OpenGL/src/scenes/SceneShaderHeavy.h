@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "ShaderCompiler.h"
+
+namespace scene {
+
+    /* A single fullscreen quad running an expensive fragment shader, */
+    /* so the frame time is dominated by fragment shading instead of submission. */
+    class SceneShaderHeavy : public Scene
+    {
+    private:
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+
+        Renderer m_Renderer;
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+        unsigned int m_Iterations;
+
+    public:
+        /* iterations is injected into the shader as ITERATIONS. */
+        SceneShaderHeavy(unsigned int iterations = 256);
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Shader != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}
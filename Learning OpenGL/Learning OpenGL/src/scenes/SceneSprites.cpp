@@ -0,0 +1,151 @@
+#include "SceneSprites.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "Renderer.h"
+#include "Shader.h"
+#include "Profiler.h"
+
+namespace scene {
+
+    const unsigned int SceneSprites::TaskSize;
+
+    static const float TwoPi = 6.28318530718f;
+    static const float Period = 8.0f; // Seconds until every sprite is back where it started
+
+    SceneSprites::SceneSprites(unsigned int count, SpriteStore::Kernel kernel)
+        : m_Sprites(count), m_Kernel(SpriteStore::IsSupported(kernel) ? kernel : SpriteStore::GetBestKernel()),
+          m_Time(0.0f), m_State({ 0.0f }), m_WriteMilliseconds(0.0)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Batch.shader", BatchRenderer::GetShaderDefines());
+
+        /* A jittered grid over the whole screen, with a small LCG so every run draws the same thing. */
+        const unsigned int columns = (unsigned int)std::ceil(std::sqrt((float)count));
+        const float cellSize = 2.0f / columns;
+        uint32_t seed = 12345;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / 16777216.0f;
+        };
+
+        m_BaseRotation.reserve(count);
+        m_Spin.reserve(count);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            const float x = -1.0f + (i % columns + random()) * cellSize;
+            const float y = -1.0f + (i / columns + random()) * cellSize;
+            const float size = cellSize * (0.6f + random() * 0.8f);
+            const uint32_t color = SpriteStore::PackColor(0.5f + (x + 1.0f) * 0.25f, 0.5f + (y + 1.0f) * 0.25f, random(), 1.0f);
+
+            m_BaseRotation.push_back(random() * TwoPi);
+            int turns = (int)(random() * 6.0f) - 3; // -3 to 3 turns per period, never standing still
+            m_Spin.push_back((turns >= 0 ? turns + 1 : turns) * TwoPi / Period);
+            m_Sprites.Add(x, y, m_BaseRotation.back(), size, size * 0.5f, color);
+        }
+    }
+
+    void SceneSprites::OnUpdate(float step)
+    {
+        /* Every spin is a whole number of turns per period, so wrapping the time changes nothing on screen */
+        /* and keeps the angles in the range the SIMD sine and cosine are accurate for. */
+        m_Time += step;
+        if (m_Time >= Period)
+            m_Time -= Period;
+
+        m_State.Publish({ m_Time });
+    }
+
+    void SceneSprites::OnRender(float alpha)
+    {
+        if (!m_Batch)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+
+            /* The most quads that still index with 16 bits, so a batch is as large as it can be cheaply. */
+            m_Batch.reset(new BatchRenderer(*m_Shader, 16384));
+        }
+
+        const SimulationState<State>::Snapshot& state = m_State.Acquire();
+        float current = state.Current.Time;
+        if (current < state.Previous.Time)
+            current += Period;
+        const float time = state.Previous.Time + (current - state.Previous.Time) * alpha;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        m_Batch->ResetStats();
+        m_Batch->BeginBatch();
+
+        /* The batch the tasks write into. Captured by reference with this alone, the task fits into */
+        /* std::function without a heap allocation every batch. */
+        struct Chunk
+        {
+            unsigned int First;
+            unsigned int Count;
+            QuadVertex* Vertices;
+            float Time;
+        } chunk = { 0, 0, nullptr, time };
+
+        const unsigned int count = m_Sprites.GetCount();
+        while (chunk.First < count)
+        {
+            /* As many sprites as the batch has room for, the rest goes into the next one. */
+            chunk.Count = m_Batch->AllocateQuads(count - chunk.First, chunk.Vertices);
+            const unsigned int taskCount = (chunk.Count + TaskSize - 1) / TaskSize;
+
+            PROFILE_SCOPE("SceneSprites::WriteVertices");
+            m_Pool.Run(taskCount, [this, &chunk](unsigned int task, unsigned int)
+            {
+                const unsigned int begin = chunk.First + task * TaskSize;
+                const unsigned int size = std::min(TaskSize, chunk.Count - task * TaskSize);
+
+                float* rotation = m_Sprites.GetRotation() + begin;
+                const float* base = m_BaseRotation.data() + begin;
+                const float* spin = m_Spin.data() + begin;
+                for (unsigned int i = 0; i < size; i++)
+                    rotation[i] = base[i] + spin[i] * chunk.Time;
+
+                m_Sprites.WriteVertices(chunk.Vertices + task * TaskSize * 4, begin, size, 0.0f, m_Kernel);
+            });
+
+            chunk.First += chunk.Count;
+        }
+
+        m_WriteMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_Batch->EndBatch();
+    }
+
+    void SceneSprites::OnReport(std::ostream& out)
+    {
+        if (!m_Batch)
+        {
+            out << "Waiting for the batch shader to compile" << std::endl;
+            return;
+        }
+
+        const BatchRenderer::Stats& stats = m_Batch->GetStats();
+        out << "Sprites: " << stats.QuadCount << " | Kernel: " << SpriteStore::GetKernelName(m_Kernel) << " on "
+            << m_Pool.GetThreadCount() << " threads | Vertices: " << m_WriteMilliseconds << " ms | Batches: "
+            << stats.BatchCount << " | Stalls: " << stats.StallCount << std::endl;
+    }
+
+    SceneStats SceneSprites::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Batch)
+        {
+            stats.DrawCalls = m_Batch->GetStats().DrawCount;
+            stats.Triangles = m_Batch->GetStats().QuadCount * 2ull;
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Scene.h"
+#include "BatchRenderer.h"
+#include "ShaderCompiler.h"
+#include "SimulationState.h"
+#include "SpriteStore.h"
+#include "ThreadPool.h"
+
+namespace scene {
+
+    /* Many small spinning sprites whose vertices are generated on the CPU every frame. */
+    /* The sprites live in a SpriteStore and are written straight into the batch renderer's mapped */
+    /* vertex buffer, one batch at a time, split into tasks over a ThreadPool. Each task updates the */
+    /* rotations of its range and transforms it with the chosen kernel, so the frame time shows what */
+    /* scalar against SIMD vertex generation costs when it feeds the GPU rather than a test buffer. */
+    class SceneSprites : public Scene
+    {
+    private:
+        /* Sprites per task, enough to keep the overhead of handing tasks out small. */
+        static const unsigned int TaskSize = 1024;
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+        std::unique_ptr<BatchRenderer> m_Batch;
+
+        ThreadPool m_Pool;
+        SpriteStore m_Sprites;
+        SpriteStore::Kernel m_Kernel;
+        std::vector<float> m_BaseRotation;
+        std::vector<float> m_Spin; // Radians per second, whole turns per Period so the time can wrap
+
+        /* What the renderer needs from the simulation. */
+        struct State
+        {
+            float Time;
+        };
+
+        /* Owned by OnUpdate. */
+        float m_Time;
+
+        SimulationState<State> m_State;
+
+        double m_WriteMilliseconds; // CPU time of the last frame's vertices, with the flushes of full batches
+
+    public:
+        SceneSprites(unsigned int count, SpriteStore::Kernel kernel);
+
+        void OnUpdate(float step) override;
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Batch != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}
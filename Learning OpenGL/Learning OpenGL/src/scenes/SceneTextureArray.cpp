@@ -0,0 +1,119 @@
+#include "SceneTextureArray.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace scene {
+
+    SceneTextureArray::SceneTextureArray(unsigned int gridSize, unsigned int layers)
+        : m_InstanceCount(gridSize * gridSize)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/TextureArray.shader");
+
+        /* Every layer gets its own color and stripe width, so neighbouring quads clearly differ. */
+        const int size = 64;
+        layers = std::min(layers, TextureArray::GetMaxLayers());
+        m_Textures.reset(new TextureArray(size, size, layers));
+        std::vector<unsigned char> pixels(size * size * 4);
+        for (unsigned int layer = 0; layer < layers; layer++)
+        {
+            unsigned char r = (unsigned char)(layer * 67 % 256);
+            unsigned char g = (unsigned char)(layer * 131 % 256);
+            unsigned char b = (unsigned char)(255 - layer * 29 % 256);
+            int stripe = 2 + layer % 14;
+            for (int y = 0; y < size; y++)
+            {
+                for (int x = 0; x < size; x++)
+                {
+                    unsigned char* pixel = &pixels[(y * size + x) * 4];
+                    bool dark = ((x + y) / stripe) % 2 == 0;
+                    pixel[0] = dark ? r / 3 : r;
+                    pixel[1] = dark ? g / 3 : g;
+                    pixel[2] = dark ? b / 3 : b;
+                    pixel[3] = 255;
+                }
+            }
+            m_Textures->SetLayer(layer, pixels.data());
+        }
+        m_Textures->GenerateMipmaps();
+
+        float positions[8] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f,
+            0.0f, 1.0f
+        };
+
+        unsigned int indices[6] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        const float cellSize = 2.0f / gridSize;
+        std::vector<InstanceData> instances(m_InstanceCount);
+        for (unsigned int y = 0; y < gridSize; y++)
+        {
+            for (unsigned int x = 0; x < gridSize; x++)
+            {
+                InstanceData& instance = instances[y * gridSize + x];
+                instance.Rect[0] = -1.0f + x * cellSize;
+                instance.Rect[1] = -1.0f + y * cellSize;
+                instance.Rect[2] = cellSize * 0.9f;
+                instance.Rect[3] = cellSize * 0.9f;
+                instance.Layer = (float)((x * 7 + y * 13) % layers);
+            }
+        }
+
+        m_VertexArray.reset(new VertexArray());
+
+        m_QuadBuffer.reset(new VertexBuffer(positions, sizeof(positions)));
+        VertexBufferLayout quadLayout;
+        quadLayout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_QuadBuffer, quadLayout);
+
+        m_InstanceBuffer.reset(new VertexBuffer(instances.data(), (unsigned int)(instances.size() * sizeof(InstanceData))));
+        VertexBufferLayout instanceLayout;
+        instanceLayout.PushInstanced<float>(4); // Rect
+        instanceLayout.PushInstanced<float>(1); // Layer
+        m_VertexArray->AddBuffer(*m_InstanceBuffer, instanceLayout);
+
+        m_IndexBuffer.reset(new IndexBuffer(indices, 6));
+
+        m_VertexArray->Unbind();
+    }
+
+    void SceneTextureArray::OnRender(float /*alpha*/)
+    {
+        if (!m_Shader)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+            m_Shader->Bind();
+            m_Shader->SetUniform1i("u_Layers", 0);
+        }
+
+        m_Textures->Bind(0);
+        m_Renderer.DrawInstanced(*m_VertexArray, *m_IndexBuffer, *m_Shader, m_InstanceCount);
+    }
+
+    void SceneTextureArray::OnReport(std::ostream& out)
+    {
+        out << "Quads: " << m_InstanceCount << " | Images: " << m_Textures->GetLayerCount() << " | Draw calls: 1 | Texture binds: 1" << std::endl;
+    }
+
+    SceneStats SceneTextureArray::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Shader)
+        {
+            stats.DrawCalls = 1;
+            stats.Triangles = m_InstanceCount * 2ull;
+        }
+        return stats;
+    }
+
+}
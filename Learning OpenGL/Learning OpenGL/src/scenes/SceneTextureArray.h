@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include "Scene.h"
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "ShaderCompiler.h"
+#include "TextureArray.h"
+
+namespace scene {
+
+    /* A grid of quads that each show one of many different images, drawn with a single instanced */
+    /* draw and a single texture bind: the images are the layers of one TextureArray and every */
+    /* instance carries the layer it samples. */
+    class SceneTextureArray : public Scene
+    {
+    private:
+        struct InstanceData
+        {
+            float Rect[4];
+            float Layer;
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+
+        Renderer m_Renderer;
+        std::unique_ptr<TextureArray> m_Textures;
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_QuadBuffer;
+        std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        unsigned int m_InstanceCount;
+
+    public:
+        SceneTextureArray(unsigned int gridSize = 64, unsigned int layers = 256);
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Shader != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}
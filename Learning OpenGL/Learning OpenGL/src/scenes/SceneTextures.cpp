@@ -0,0 +1,92 @@
+#include "SceneTextures.h"
+
+#include "Renderer.h"
+#include "Shader.h"
+
+namespace scene {
+
+    SceneTextures::SceneTextures(int gridSize)
+        : m_GridSize(gridSize)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Batch.shader", BatchRenderer::GetShaderDefines());
+
+        /* All of these return immediately, the files are read and decoded on the loader's threads. */
+        m_Textures.push_back(m_Loader.Load("res/textures/checker.tga"));
+        m_Textures.push_back(m_Loader.Load("res/textures/gradient.tga"));
+        m_Textures.push_back(m_Loader.Load("res/textures/tiles.dds"));
+    }
+
+    SceneTextures::~SceneTextures()
+    {
+    }
+
+    bool SceneTextures::IsReady() const
+    {
+        if (!m_Batch)
+            return false;
+
+        for (const std::shared_ptr<Texture>& texture : m_Textures)
+        {
+            if (!texture->IsReady())
+                return false;
+        }
+        return true;
+    }
+
+    void SceneTextures::OnRender(float /*alpha*/)
+    {
+        m_Loader.Update();
+
+        if (!m_Batch)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+            m_Batch.reset(new BatchRenderer(*m_Shader));
+        }
+
+        const float cellSize = 2.0f / m_GridSize;
+        const float quadSize = cellSize * 0.9f;
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        const float grey[4] = { 0.3f, 0.3f, 0.3f, 1.0f };
+
+        m_Batch->ResetStats();
+        m_Batch->BeginBatch();
+        for (int y = 0; y < m_GridSize; y++)
+        {
+            for (int x = 0; x < m_GridSize; x++)
+            {
+                const Texture& texture = *m_Textures[(x + y) % m_Textures.size()];
+                if (texture.IsReady())
+                    m_Batch->DrawQuad(-1.0f + x * cellSize, -1.0f + y * cellSize, quadSize, quadSize, texture, white);
+                else
+                    m_Batch->DrawQuad(-1.0f + x * cellSize, -1.0f + y * cellSize, quadSize, quadSize, grey);
+            }
+        }
+        m_Batch->EndBatch();
+    }
+
+    void SceneTextures::OnReport(std::ostream& out)
+    {
+        const TextureLoader::Stats& stats = m_Loader.GetStats();
+        out << "Textures: " << stats.Loaded << " loaded, " << stats.Pending << " pending, " << stats.Failed << " failed";
+        if (m_Batch)
+            out << " | Draw calls: " << m_Batch->GetStats().DrawCount;
+        out << std::endl;
+    }
+
+    SceneStats SceneTextures::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Batch)
+        {
+            stats.DrawCalls = m_Batch->GetStats().DrawCount;
+            stats.Triangles = m_Batch->GetStats().QuadCount * 2ull;
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Scene.h"
+#include "BatchRenderer.h"
+#include "ShaderCompiler.h"
+#include "TextureLoader.h"
+
+namespace scene {
+
+    /* A grid of textured quads drawn through the batch renderer while the textures stream in. */
+    /* Quads whose texture is not uploaded yet are drawn in flat grey, so the loading never */
+    /* holds a frame back. */
+    class SceneTextures : public Scene
+    {
+    private:
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+        std::unique_ptr<BatchRenderer> m_Batch;
+
+        TextureLoader m_Loader;
+        std::vector<std::shared_ptr<Texture>> m_Textures;
+
+        int m_GridSize;
+
+    public:
+        SceneTextures(int gridSize = 16);
+        ~SceneTextures();
+
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override;
+        SceneStats GetStats() const override;
+    };
+
+}
@@ -0,0 +1,173 @@
+#include "SceneWorld.h"
+
+#include <cmath>
+
+#include "Renderer.h"
+#include "Shader.h"
+#include "Profiler.h"
+
+namespace scene {
+
+    /* Wraps a coordinate into [0, size), for objects drifting off one edge of the world onto the other. */
+    static float Wrap(float value, float size)
+    {
+        value = std::fmod(value, size);
+        return value < 0.0f ? value + size : value;
+    }
+
+    SceneWorld::SceneWorld(unsigned int objectCount, float worldSize, float cellSize, bool culling)
+        : m_WorldSize(worldSize), m_Culling(culling), m_Grid(0.0f, 0.0f, worldSize, worldSize, cellSize),
+          m_Time(0.0f), m_State({ 0.0f }), m_Drawn(0)
+    {
+        m_ShaderHandle = m_Compiler.Submit("res/shaders/Batch.shader", BatchRenderer::GetShaderDefines());
+
+        uint32_t seed = 4321;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / 16777216.0f;
+        };
+
+        m_Objects.reserve(objectCount);
+        m_Positions.reserve(objectCount * 2);
+        m_Visible.reserve(objectCount); // A query never has to grow it, even with the whole world in view
+        for (unsigned int i = 0; i < objectCount; i++)
+        {
+            Object object;
+            object.X = random() * worldSize;
+            object.Y = random() * worldSize;
+            object.HalfSize = 0.01f + random() * 0.03f;
+            object.Color[0] = object.X / worldSize;
+            object.Color[1] = object.Y / worldSize;
+            object.Color[2] = 0.3f + random() * 0.7f;
+            object.Color[3] = 1.0f;
+
+            /* One in four drifts, in any direction, at up to a screen every few seconds. */
+            object.VelocityX = object.VelocityY = 0.0f;
+            if (i % 4 == 0)
+            {
+                float angle = random() * 6.28318530718f;
+                float speed = 0.05f + random() * 0.45f;
+                object.VelocityX = std::cos(angle) * speed;
+                object.VelocityY = std::sin(angle) * speed;
+                m_Moving.push_back(i);
+            }
+
+            object.Handle = m_Grid.Insert(object.X, object.Y, object.HalfSize, object.HalfSize);
+            ASSERT(object.Handle == i); // Nothing is ever removed, so handles are indices
+            m_Objects.push_back(object);
+            m_Positions.push_back(object.X);
+            m_Positions.push_back(object.Y);
+        }
+    }
+
+    void SceneWorld::OnUpdate(float step)
+    {
+        m_Time += step;
+        m_State.Publish({ m_Time });
+    }
+
+    void SceneWorld::OnRender(float alpha)
+    {
+        if (!m_Batch)
+        {
+            m_Compiler.Poll();
+            m_Shader = m_Compiler.Take(m_ShaderHandle);
+            if (!m_Shader)
+                return;
+
+            m_Shader->SetUniformBlockBinding("Frame", FrameData::BindingPoint);
+            m_Batch.reset(new BatchRenderer(*m_Shader, 16384));
+        }
+
+        const SimulationState<State>::Snapshot& state = m_State.Acquire();
+        const float time = state.Previous.Time + (state.Current.Time - state.Previous.Time) * alpha;
+
+        {
+            /* Positions follow from the time alone, so the grid can be brought up to date here. */
+            PROFILE_SCOPE("SceneWorld::Move");
+            for (unsigned int index : m_Moving)
+            {
+                const Object& object = m_Objects[index];
+                const float x = Wrap(object.X + object.VelocityX * time, m_WorldSize);
+                const float y = Wrap(object.Y + object.VelocityY * time, m_WorldSize);
+                m_Positions[index * 2] = x;
+                m_Positions[index * 2 + 1] = y;
+                m_Grid.Move(object.Handle, x, y);
+            }
+        }
+
+        /* The view is [-aspect, aspect] x [-1, 1] around the camera. The viewport is client state, reading */
+        /* it back doesn't wait for the GPU. */
+        GLint viewport[4];
+        GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+        const float aspect = viewport[3] > 0 ? (float)viewport[2] / viewport[3] : 1.0f;
+
+        /* The camera sweeps slowly over the whole world, never leaving it. */
+        const float range = m_WorldSize * 0.5f - 1.0f;
+        const float cameraX = m_WorldSize * 0.5f + range * std::sin(time * 0.05f);
+        const float cameraY = m_WorldSize * 0.5f + range * std::sin(time * 0.037f);
+
+        const unsigned int* handles = nullptr;
+        unsigned int count = (unsigned int)m_Objects.size();
+        if (m_Culling)
+        {
+            PROFILE_SCOPE("SceneWorld::Query");
+            m_Visible.clear();
+            count = m_Grid.Query(cameraX - aspect, cameraY - 1.0f, cameraX + aspect, cameraY + 1.0f, m_Visible);
+            handles = m_Visible.data();
+        }
+
+        m_Batch->ResetStats();
+        m_Batch->BeginBatch();
+        for (unsigned int i = 0; i < count; i++)
+        {
+            const unsigned int index = handles ? handles[i] : i;
+            const Object& object = m_Objects[index];
+            const float size = object.HalfSize * 2.0f;
+            m_Batch->DrawQuad(m_Positions[index * 2] - object.HalfSize - cameraX, m_Positions[index * 2 + 1] - object.HalfSize - cameraY,
+                size, size, object.Color);
+        }
+        m_Batch->EndBatch();
+        m_Drawn = count;
+
+        PROFILE_COUNTER("World: drawn", m_Drawn);
+        PROFILE_COUNTER("World: culled", m_Objects.size() - m_Drawn);
+        if (m_Culling)
+        {
+            PROFILE_COUNTER("World: cells visited", m_Grid.GetStats().CellsVisited);
+            PROFILE_COUNTER("World: objects tested", m_Grid.GetStats().ObjectsTested);
+        }
+    }
+
+    void SceneWorld::OnReport(std::ostream& out)
+    {
+        if (!m_Batch)
+        {
+            out << "Waiting for the batch shader to compile" << std::endl;
+            return;
+        }
+
+        out << "Objects: " << m_Objects.size() << " (" << m_Moving.size() << " moving) | Drawn: " << m_Drawn
+            << " | Culled: " << m_Objects.size() - m_Drawn << " | Batches: " << m_Batch->GetStats().BatchCount;
+        if (m_Culling)
+        {
+            const SpatialGrid::Stats& stats = m_Grid.GetStats();
+            out << " | Cells of " << m_Grid.GetCellSize() << ": " << stats.CellsVisited << " of " << m_Grid.GetCellCount()
+                << " | Tested: " << stats.ObjectsTested;
+        }
+        out << std::endl;
+    }
+
+    SceneStats SceneWorld::GetStats() const
+    {
+        SceneStats stats;
+        if (m_Batch)
+        {
+            stats.DrawCalls = m_Batch->GetStats().DrawCount;
+            stats.Triangles = m_Batch->GetStats().QuadCount * 2ull;
+        }
+        return stats;
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Scene.h"
+#include "BatchRenderer.h"
+#include "ShaderCompiler.h"
+#include "SimulationState.h"
+#include "SpatialGrid.h"
+
+namespace scene {
+
+    /* A 2D world many times larger than the screen, with a camera flying over it. */
+    /* The objects are indexed in a SpatialGrid and only those the camera's rectangle finds are drawn */
+    /* through the batch renderer. A quarter of them drift across the world and are moved in the grid */
+    /* every frame. Without culling every object is drawn, to compare against. The counts of drawn and */
+    /* culled objects, and of the cells and objects a query visited, go to the profiler. */
+    class SceneWorld : public Scene
+    {
+    private:
+        struct Object
+        {
+            float X, Y;     // Where it starts
+            float VelocityX, VelocityY;
+            float HalfSize;
+            float Color[4];
+            unsigned int Handle; // In m_Grid
+        };
+
+        ShaderCompiler m_Compiler;
+        ShaderCompiler::Handle m_ShaderHandle;
+        std::unique_ptr<Shader> m_Shader;
+        std::unique_ptr<BatchRenderer> m_Batch;
+
+        float m_WorldSize;
+        bool m_Culling;
+        SpatialGrid m_Grid;
+        std::vector<Object> m_Objects;
+        std::vector<unsigned int> m_Moving;  // Indices into m_Objects
+        std::vector<float> m_Positions;      // Current center of every object, x and y
+        std::vector<unsigned int> m_Visible; // What the last query found, handles are indices into m_Objects
+
+        /* What the renderer needs from the simulation. */
+        struct State
+        {
+            float Time;
+        };
+
+        /* Owned by OnUpdate. */
+        float m_Time;
+
+        SimulationState<State> m_State;
+
+        unsigned int m_Drawn;
+
+    public:
+        /* objectCount objects in a square world of worldSize, indexed in cells of cellSize. */
+        SceneWorld(unsigned int objectCount, float worldSize, float cellSize, bool culling);
+
+        void OnUpdate(float step) override;
+        void OnRender(float alpha) override;
+        void OnReport(std::ostream& out) override;
+        bool IsReady() const override { return m_Batch != nullptr; }
+        SceneStats GetStats() const override;
+    };
+
+}